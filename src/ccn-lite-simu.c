@@ -156,8 +156,8 @@ ccnl_simu_add2cache(char node, const char *name, int seqn, void *data, int len)
     pkt->content = pkt->buf->data + dataoffset;
     pkt->contlen = len;
     c = ccnl_content_new(relay, &pkt);
-    if (c)
-        ccnl_content_add2cache(relay, c);
+    if (c && !ccnl_content_add2cache(relay, c))
+        ccnl_content_free(c);
     return;
 }
 
@@ -371,6 +371,7 @@ ccnl_simu_init_node(char node, const char *addr,
         i->mtu = 4096;
     i->reflect = 1;
     i->fwdalli = 1;
+    ccnl_interface_qinit(i, relay->if_qlen);
     relay->ifcount++;
 
 #ifdef USE_SCHEDULER
@@ -418,8 +419,7 @@ ccnl_simu_add_fwd(char node, const char *name, char dstnode, int mtu)
         fwd->face->frag = ccnl_frag_new(CCNL_FRAG_BEGINEND2015, mtu);
 #endif
     fwd->face->flags |= CCNL_FACE_FLAGS_STATIC;
-    fwd->next = relay->fib;
-    relay->fib = fwd;
+    ccnl_fib_link(relay, fwd);
 }
 
 
@@ -499,36 +499,15 @@ ccnl_simu_phase_two(void *ptr, void *dummy)
 void
 simu_eventloop()
 {
-    static struct timeval now;
     long usec;
 
-    while (eventqueue) {
-        struct ccnl_timer_s *t = eventqueue;
+    while ((usec = ccnl_run_events()) >= 0) {
         // printf("  looping now %g\n", CCNL_NOW());
-        gettimeofday(&now, 0);
-        usec = timevaldelta(&(t->timeout), &now);
-        if (usec >= 0) {
-            // usleep(usec);
-            struct timespec ts;
-            ts.tv_sec = usec / 1000000;
-            ts.tv_nsec = 1000 * (usec % 1000000);
-            nanosleep(&ts, NULL);
-        }
-        t = eventqueue;
-        eventqueue = t->next;
-        if (t->fct) {
-            void (*fct)(char,int) = t->fct;
-            char c = t->node;
-            int i = t->intarg;
-            ccnl_free(t);
-            (fct)(c, i);
-        } else if (t->fct2) {
-            void (*fct2)(void*,void*) = t->fct2;
-            void *aux1 = t->aux1;
-            void *aux2 = t->aux2;
-            ccnl_free(t);
-            (fct2)(aux1, aux2);
-        }
+        // usleep(usec);
+        struct timespec ts;
+        ts.tv_sec = usec / 1000000;
+        ts.tv_nsec = 1000 * (usec % 1000000);
+        nanosleep(&ts, NULL);
     }
     DEBUGMSG(ERROR, "simu event loop: no more events to handle\n");
 }
@@ -550,8 +529,7 @@ ccnl_simu_cleanup(void *dummy, void *dummy2)
         ccnl_core_cleanup(relay);
     }
 
-    while(eventqueue)
-        ccnl_rem_timer(eventqueue);
+    ccnl_timer_cleanup();
 
     while(etherqueue) {
         struct ccnl_ethernet_s *e = etherqueue->next;
@@ -346,7 +346,7 @@ ccnl_populate_cache(struct ccnl_relay_s *ccnl, char *path)
             continue;
         }
 
-        buf = (struct ccnl_buf_s *) ccnl_malloc(sizeof(*buf) + s.st_size);
+        buf = ccnl_buf_new(NULL, s.st_size);
         if (buf)
             datalen = read(fd, buf->data, s.st_size);
         else
@@ -421,8 +421,10 @@ ccnl_populate_cache(struct ccnl_relay_s *ccnl, char *path)
             DEBUGMSG(WARNING, "could not create content (%s)\n", de->d_name);
             goto Done;
         }
-        ccnl_content_add2cache(ccnl, c);
         c->flags |= CCNL_CONTENT_FLAGS_STATIC;
+        if (!ccnl_content_add2cache(ccnl, c)) {
+            ccnl_content_free(c);
+        }
 Done:
         ccnl_pkt_free(pk);
         ccnl_free(buf);
@@ -0,0 +1,155 @@
+/*
+ * @f ccnl-ageing.h
+ * @b CCN lite (CCNL), core header file (expiry queues for the ageing)
+ *
+ * Copyright (C) 2011-17, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifndef CCNL_AGEING_H
+#define CCNL_AGEING_H
+
+#ifndef CCNL_LINUXKERNEL
+#include <stdint.h>
+#else
+#include <linux/types.h>
+#endif
+
+/**
+ * @brief Max number of entries of each queue handled by one ageing tick,
+ * the remaining due entries wait for the next tick
+ */
+#ifndef CCNL_AGEING_BUDGET
+#define CCNL_AGEING_BUDGET      1024
+#endif
+
+/**
+ * @brief Interval of the ageing ticks in microseconds
+ *
+ * Content and faces are due at full seconds, PIT entries after their
+ * retransmission timeout in milliseconds: the interval bounds how late a
+ * retransmission is sent.
+ */
+#ifndef CCNL_AGEING_INTERVAL
+#define CCNL_AGEING_INTERVAL    100000
+#endif
+
+/**
+ * @brief Number of buckets of the tick duration histogram
+ *
+ * Bucket k counts the ticks which took less than 16 << (2 * k)
+ * microseconds, the last one all longer ticks.
+ */
+#define CCNL_AGEING_HIST        8
+
+/**
+ * @brief An entry of an expiry queue, embedded in the queued object
+ */
+struct ccnl_ageq_entry_s {
+    struct ccnl_ageq_entry_s *next;     /**< entry due later */
+    struct ccnl_ageq_entry_s *prev;     /**< entry due earlier */
+    uint32_t due;                       /**< when the entry is due (clock of the queue) */
+    void *obj;                          /**< the queued object, NULL if not queued */
+};
+
+/**
+ * @brief A queue of entries ordered by the time they are due
+ *
+ * Entries added with \ref ccnl_ageq_add are appended: the queue is
+ * ordered because each such user adds entries with a fixed delay. An
+ * entry which would be due before the last one is due together with it,
+ * so entries are handled late rather than early. Users with varying
+ * delays use \ref ccnl_ageq_insert instead. The clock is the user's,
+ * CCNL_NOW() for the content and the faces, \ref ccnl_rtt_now for the
+ * PIT.
+ */
+struct ccnl_ageq_s {
+    struct ccnl_ageq_entry_s *head;     /**< entry due first */
+    struct ccnl_ageq_entry_s *tail;     /**< entry due last */
+    uint32_t count;                     /**< number of entries */
+};
+
+/**
+ * @brief Statistics of the ageing ticks
+ */
+struct ccnl_ageing_stats_s {
+    uint32_t ticks;                     /**< number of ticks */
+    uint32_t capped;                    /**< ticks which reached the budget of a queue */
+    uint32_t max_usec;                  /**< duration of the longest tick */
+    uint32_t hist[CCNL_AGEING_HIST];    /**< ticks by duration */
+};
+
+/**
+ * @brief Appends an entry to a queue
+ *
+ * @param[in] q      the queue
+ * @param[in] e      the entry, must not be queued
+ * @param[in] due    when the entry is due
+ * @param[in] obj    the object the entry is embedded in
+ */
+void
+ccnl_ageq_add(struct ccnl_ageq_s *q, struct ccnl_ageq_entry_s *e,
+              uint32_t due, void *obj);
+
+/**
+ * @brief Inserts an entry into a queue at the position of its due time
+ *
+ * For users whose entries are due after varying delays. The position is
+ * searched from the tail, an entry is queued after those due at the same
+ * time.
+ *
+ * @param[in] q      the queue
+ * @param[in] e      the entry, must not be queued
+ * @param[in] due    when the entry is due
+ * @param[in] obj    the object the entry is embedded in
+ */
+void
+ccnl_ageq_insert(struct ccnl_ageq_s *q, struct ccnl_ageq_entry_s *e,
+                 uint32_t due, void *obj);
+
+/**
+ * @brief Removes an entry from its queue
+ *
+ * @param[in] q      the queue
+ * @param[in] e      the entry, may be not queued
+ */
+void
+ccnl_ageq_remove(struct ccnl_ageq_s *q, struct ccnl_ageq_entry_s *e);
+
+/**
+ * @brief Returns the object of the first entry if it is due
+ *
+ * The entry stays queued.
+ *
+ * @param[in] q      the queue
+ * @param[in] now    the current time
+ *
+ * @return the object, NULL if no entry is due
+ */
+void*
+ccnl_ageq_due(struct ccnl_ageq_s *q, uint32_t now);
+
+/**
+ * @brief Records the duration of a tick
+ *
+ * @param[in] stats  the statistics
+ * @param[in] usec   the duration in microseconds
+ */
+void
+ccnl_ageing_record(struct ccnl_ageing_stats_s *stats, long usec);
+
+#endif // CCNL_AGEING_H
@@ -28,18 +28,50 @@
 
 struct ccnl_relay_s;
 
+/**
+ * @brief A packet or other chunk of bytes
+ *
+ * Packet buffers are shared instead of copied, e.g. between the content
+ * store, the faces a Data is sent to and the interface queues. The bytes
+ * of a buffer must not be changed once it has more than one owner, and
+ * a buffer which may be shared is released with \ref ccnl_buf_free.
+ */
 struct ccnl_buf_s {
     struct ccnl_buf_s *next;
+    unsigned int refcnt;        /**< number of owners */
     size_t datalen;
     unsigned char data[1];
 };
 
 /**
- * 
+ * @brief Allocates a buffer with a single owner
+ *
+ * @param[in] data  bytes to copy into the buffer, NULL to leave it uninitialized
+ * @param[in] len   size of the buffer
+ *
+ * @return the buffer, NULL if out of memory
  */
 struct ccnl_buf_s*
 ccnl_buf_new(void *data, size_t len);
 
+/**
+ * @brief Adds an owner to a buffer
+ *
+ * @param[in] buf   the buffer (may be NULL)
+ *
+ * @return \p buf
+ */
+struct ccnl_buf_s*
+ccnl_buf_ref(struct ccnl_buf_s *buf);
+
+/**
+ * @brief Drops an owner of a buffer, the last one frees it
+ *
+ * @param[in] buf   the buffer (may be NULL)
+ */
+void
+ccnl_buf_free(struct ccnl_buf_s *buf);
+
 #define buf_dup(B)      (B) ? ccnl_buf_new(B->data, B->datalen) : NULL
 #define buf_equal(X,Y)  ((X) && (Y) && (X->datalen==Y->datalen) &&\
                          !memcmp(X->data,Y->data,X->datalen))
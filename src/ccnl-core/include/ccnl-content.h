@@ -25,12 +25,21 @@
 
 #include <stdbool.h>
 #ifndef CCNL_LINUXKERNEL
+#include <stddef.h>
 #include <stdint.h>
 #else
 #include <linux/types.h>
 
 #endif
 
+#ifndef CCNL_LINUXKERNEL
+#include "ccnl-ageing.h"
+#include "ccnl-htable.h"
+#else
+#include "../include/ccnl-ageing.h"
+#include "../include/ccnl-htable.h"
+#endif
+
 #ifdef CCNL_RIOT
 #include "evtimer_msg.h"
 #endif
@@ -46,15 +55,23 @@ typedef enum ccnl_content_flags_e {
     CCNL_CONTENT_FLAGS_NOT_STALE = 0x0, /**< content is not stale */
     CCNL_CONTENT_FLAGS_STATIC = 0x01,   /**< content is static */
     CCNL_CONTENT_FLAGS_STALE = 0x02,    /**< content is stale */
+    CCNL_CONTENT_FLAGS_STORED = 0x04,   /**< content is also in the backing store */
+    CCNL_CONTENT_FLAGS_DIGEST = 0x08,   /**< the implicit digest has been computed */
     CCNL_CONTENT_DO_NOT_USE = UINT8_MAX /**< for internal use only, sets the width of the enum to sizeof(uint8_t) */
 } ccnl_content_flags;
 
+/**
+ * @brief Length of the implicit digest of a content object (SHA256)
+ */
+#define CCNL_CONTENT_DIGEST_LEN 32
+
 /**
  * @brief Defines an entry in the content store.
  *
  * The content store is implemented as linked list and stores the
  * full byte representation (the packet) of an content object 
- * (and not just the content itself).
+ * (and not just the content itself). Lookups by name go through a
+ * hash index (\ref ccnl_content_lookup) instead of walking the list.
  */
 typedef struct ccnl_content_s {
     struct ccnl_content_s *next;          /**< pointer to the next element in the content store */
@@ -71,6 +88,13 @@ typedef struct ccnl_content_s {
     evtimer_msg_event_t evtmsg_cstimeout; /**< event timer message which is triggered when a timeout in the content store occurs */
 #endif
     int served_cnt;                       /**< determines how often the content has been served */
+    struct ccnl_hentry_s cs_entry;        /**< entry in the name index of the content store */
+    struct ccnl_content_s *cs_qnext;      /**< next (older) entry in the replacement queue */
+    struct ccnl_content_s *cs_qprev;      /**< previous (newer) entry in the replacement queue */
+    uint8_t cs_queue;                     /**< replacement queue of this entry plus one, 0 if in none */
+    uint8_t cs_freq;                      /**< use count kept by the replacement policy */
+    struct ccnl_ageq_entry_s age_entry;   /**< entry in the expiry queue of the content store */
+    unsigned char digest[CCNL_CONTENT_DIGEST_LEN]; /**< implicit digest, see ccnl_content_digest() */
 } ccnl_content;
 
 /**
@@ -86,6 +110,33 @@ typedef struct ccnl_content_s {
 struct ccnl_content_s*
 ccnl_content_new(struct ccnl_pkt_s **packet);
 
+/**
+ * @brief Checks whether the freshness period of content has expired
+ *
+ * Content is marked stale when this is first found out, static content
+ * never becomes stale.
+ *
+ * @param[in] c  the content
+ *
+ * @return 1 if the content is stale, 0 otherwise
+ */
+int
+ccnl_content_is_stale(struct ccnl_content_s *c);
+
+/**
+ * @brief Returns the implicit digest of content, the SHA256 of its packet
+ *
+ * The digest is computed on the first call only, so matching an Interest
+ * which ends with a digest costs a hash once per content object.
+ *
+ * @param[in] c  the content
+ *
+ * @return the \ref CCNL_CONTENT_DIGEST_LEN bytes of the digest
+ * @return NULL if the relay is built without digest support
+ */
+unsigned char*
+ccnl_content_digest(struct ccnl_content_s *c);
+
 /**
  * @brief Frees a \p content object.
 
@@ -94,5 +145,18 @@ ccnl_content_new(struct ccnl_pkt_s **packet);
 int
 ccnl_content_free(struct ccnl_content_s *content);
 
+/**
+ * @brief Returns the memory used by a \p content object
+ *
+ * Accounts the packet bytes, the name and the data structures wrapping
+ * them. Used to keep the content store within its byte budget.
+ *
+ * @param[in] content The content object
+ *
+ * @return the number of bytes used by \p content
+ */
+size_t
+ccnl_content_size(struct ccnl_content_s *content);
+
 #endif // EOF
 /** @} */
@@ -28,11 +28,14 @@
 #include "ccnl-defs.h"
 #include "ccnl-face.h"
 #include "ccnl-frag.h"
+#include "ccnl-htable.h"
 #include "ccnl-interest.h"
 #include "ccnl-malloc.h"
 #include "ccnl-os-time.h"
 #include "ccnl-pkt.h"
+#include "ccnl-pool.h"
 #include "ccnl-relay.h"
+#include "ccnl-ring.h"
 #include "ccnl-sockunion.h"
 #include "ccnl-buf.h"
 #include "ccnl-crypto.h"
@@ -0,0 +1,283 @@
+/*
+ * @f ccnl-cs-policy.h
+ * @b CCN lite (CCNL), core header file (content store replacement policies)
+ *
+ * Copyright (C) 2011-17, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifndef CCNL_CS_POLICY_H
+#define CCNL_CS_POLICY_H
+
+#ifndef CCNL_LINUXKERNEL
+#include <stdint.h>
+#include "ccnl-htable.h"
+#else
+#include <linux/types.h>
+#include "../include/ccnl-htable.h"
+#endif
+
+struct ccnl_relay_s;
+struct ccnl_content_s;
+struct ccnl_prefix_s;
+
+/**
+ * @brief Number of replacement queues of a content store
+ *
+ * LFU uses one queue per (capped) use count, the other policies need
+ * at most two queues.
+ */
+#ifndef CCNL_CS_QUEUES
+#define CCNL_CS_QUEUES 8
+#endif
+
+/**
+ * @brief Replacement policies of the content store
+ */
+typedef enum ccnl_cs_policy_e {
+    CCNL_CS_POLICY_LRU = 0, /**< least recently used (default) */
+    CCNL_CS_POLICY_LFU,     /**< least frequently used, LRU among equals */
+    CCNL_CS_POLICY_S3FIFO,  /**< small and main FIFO queues with a ghost queue */
+    CCNL_CS_POLICY_ARC,     /**< adaptive replacement cache */
+    CCNL_CS_POLICY_MAX
+} ccnl_cs_policy;
+
+/**
+ * @brief A queue of content objects, linked through the content objects
+ */
+struct ccnl_cs_queue_s {
+    struct ccnl_content_s *head;    /**< most recently inserted or used entry */
+    struct ccnl_content_s *tail;    /**< next candidate for eviction */
+    uint32_t cnt;                   /**< number of entries in the queue */
+};
+
+/**
+ * @brief A bounded FIFO of name hashes of recently evicted content
+ *
+ * Used by S3-FIFO and ARC to recognize content which comes back soon
+ * after its eviction. Only the hash of the name is remembered.
+ */
+struct ccnl_cs_ghost_s {
+    struct ccnl_htable_s index;     /**< the remembered hashes */
+    struct ccnl_hentry_s *ring;     /**< storage of the entries, oldest is overwritten */
+    uint32_t size;                  /**< number of entries in ring, 0 if not allocated */
+    uint32_t pos;                   /**< next entry of ring to use */
+};
+
+/**
+ * @brief Max value of a counter of the admission filter
+ */
+#define CCNL_CS_SKETCH_MAX      15
+
+/**
+ * @brief Number of counters of the admission filter per name
+ */
+#define CCNL_CS_SKETCH_DEPTH    4
+
+/**
+ * @brief Counters per row of the admission filter if the content store
+ * has no max number of entries
+ */
+#ifndef CCNL_CS_SKETCH_DEFAULT
+#define CCNL_CS_SKETCH_DEFAULT  65536
+#endif
+
+/**
+ * @brief Admission filter of a content store (TinyLFU)
+ *
+ * A count-min sketch estimates how often each name was asked for
+ * recently: every Interest increments the smallest of the counters its
+ * name hashes to, and all counters are halved after a sample period, so
+ * the counts of old requests fade. When the content store is full, new
+ * content only replaces the entry chosen for eviction if its name was
+ * asked for more often, which keeps content requested only once from
+ * pushing out popular content.
+ */
+struct ccnl_cs_sketch_s {
+    uint8_t *counters;              /**< the counters, NULL if the filter is off */
+    uint32_t mask;                  /**< number of counters minus one */
+    uint32_t samples;               /**< Interests counted since the counters were halved */
+    uint32_t period;                /**< Interests after which the counters are halved */
+};
+
+/**
+ * @brief Hit statistics of a content store and its backing store
+ */
+struct ccnl_cs_stats_s {
+    uint32_t lookups;               /**< Interests looked up in the content store */
+    uint32_t hits;                  /**< Interests served from the content store */
+    uint32_t store_hits;            /**< Interests served from the backing store */
+    uint32_t rejected;              /**< content not admitted by the admission filter */
+    uint32_t spilled;               /**< evicted content written to the backing store */
+};
+
+/**
+ * @brief State of the replacement policy of a content store
+ *
+ * Every content object which may be evicted is in exactly one of the
+ * queues, so insertion, use and eviction take constant time. A zeroed
+ * structure is an empty LRU policy.
+ */
+struct ccnl_cs_policy_s {
+    ccnl_cs_policy type;                        /**< the active policy */
+    struct ccnl_cs_queue_s q[CCNL_CS_QUEUES];   /**< the replacement queues */
+    struct ccnl_cs_ghost_s ghost[2];            /**< evicted names (S3-FIFO uses the first only) */
+    uint32_t target;                            /**< ARC: target size of the recency queue */
+};
+
+/**
+ * @brief Selects the replacement policy of a content store
+ *
+ * The entries already in the content store are handed over to the new
+ * policy, their usage history is lost.
+ *
+ * @param[in] relay   the relay
+ * @param[in] type    the new policy
+ *
+ * @return 0 on success
+ * @return -1 if \p type is not a valid policy
+ */
+int
+ccnl_cs_set_policy(struct ccnl_relay_s *relay, ccnl_cs_policy type);
+
+/**
+ * @brief Parses the name of a replacement policy ("lru", "lfu", "s3fifo", "arc")
+ *
+ * @param[in] name    the name of the policy
+ *
+ * @return the policy
+ * @return -1 if \p name is not known
+ */
+int
+ccnl_cs_policy_from_str(const char *name);
+
+/**
+ * @brief Returns the name of a replacement policy
+ *
+ * @param[in] type    the policy
+ *
+ * @return the name, "?" for an invalid policy
+ */
+const char*
+ccnl_cs_policy_to_str(ccnl_cs_policy type);
+
+/**
+ * @brief Hands a content object which was added to the content store
+ * over to the replacement policy
+ *
+ * @param[in] relay   the relay
+ * @param[in] c       the new content object
+ */
+void
+ccnl_cs_policy_insert(struct ccnl_relay_s *relay, struct ccnl_content_s *c);
+
+/**
+ * @brief Tells the replacement policy that a content object was served
+ * from the content store
+ *
+ * @param[in] relay   the relay
+ * @param[in] c       the content object
+ */
+void
+ccnl_cs_policy_hit(struct ccnl_relay_s *relay, struct ccnl_content_s *c);
+
+/**
+ * @brief Removes a content object from the replacement policy
+ *
+ * Called when the object leaves the content store for any reason.
+ * Removing an object which is not managed by the policy is a no-op.
+ *
+ * @param[in] relay   the relay
+ * @param[in] c       the content object
+ */
+void
+ccnl_cs_policy_remove(struct ccnl_relay_s *relay, struct ccnl_content_s *c);
+
+/**
+ * @brief Selects the content object to evict next
+ *
+ * The object is not removed from the content store. Static content is
+ * never selected.
+ *
+ * @param[in] relay   the relay
+ *
+ * @return the content object to evict
+ * @return NULL if there is no content object which may be evicted
+ */
+struct ccnl_content_s*
+ccnl_cs_policy_victim(struct ccnl_relay_s *relay);
+
+/**
+ * @brief Turns the admission filter of the content store on or off
+ *
+ * @param[in] relay   the relay
+ * @param[in] size    number of counters, rounded up to a power of two,
+ *                    about twice the number of cached entries; 0 turns
+ *                    the filter off
+ *
+ * @return 0 on success
+ * @return -1 if no memory is available, the filter is off then
+ */
+int
+ccnl_cs_set_admission(struct ccnl_relay_s *relay, uint32_t size);
+
+/**
+ * @brief Counts a request for a name in the admission filter
+ *
+ * @param[in] relay   the relay
+ * @param[in] pfx     the name of an Interest
+ */
+void
+ccnl_cs_admission_record(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx);
+
+/**
+ * @brief Estimates how often the name of a content object was asked for
+ * recently
+ *
+ * @param[in] relay   the relay
+ * @param[in] c       the content object
+ *
+ * @return the estimated count, CCNL_CS_SKETCH_MAX if the filter is off
+ */
+uint32_t
+ccnl_cs_admission_estimate(struct ccnl_relay_s *relay, struct ccnl_content_s *c);
+
+/**
+ * @brief Decides whether a content object may replace the one chosen
+ * for eviction
+ *
+ * Static content and content from the backing store are always admitted.
+ *
+ * @param[in] relay   the relay
+ * @param[in] c       the new content object
+ * @param[in] victim  the content object to evict for it
+ *
+ * @return 1 if \p c is admitted, 0 otherwise
+ */
+int
+ccnl_cs_admit(struct ccnl_relay_s *relay, struct ccnl_content_s *c,
+              struct ccnl_content_s *victim);
+
+/**
+ * @brief Releases the memory held by the replacement policy
+ *
+ * @param[in] relay   the relay
+ */
+void
+ccnl_cs_policy_cleanup(struct ccnl_relay_s *relay);
+
+#endif // CCNL_CS_POLICY_H
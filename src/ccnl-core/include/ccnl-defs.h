@@ -33,6 +33,18 @@
 
 #define CCNL_DEFAULT_UNIXSOCKNAME       "/tmp/.ccnl.sock"
 
+/**
+ * @brief Storage class of the state which each thread of a sharded relay
+ * keeps for itself (object pools, timers, static result buffers)
+ *
+ * Empty on the platforms which run a single relay without threads.
+ */
+#if !defined(CCNL_LINUXKERNEL) && !defined(CCNL_RIOT) && !defined(CCNL_ARDUINO)
+# define CCNL_THREAD_LOCAL              _Thread_local
+#else
+# define CCNL_THREAD_LOCAL
+#endif
+
 /* assuming that all broadcast addresses consist of a sequence of equal octets */
 #define CCNL_BROADCAST_OCTET            0xFF
 
@@ -84,11 +96,6 @@
 #endif
 
 #define CCNL_DEFAULT_MAX_CACHE_ENTRIES  0   // means: no content caching
-#ifdef CCNL_RIOT
-#define CCNL_MAX_NONCES                 -1 // -1 --> detect dups by PIT
-#else //!CCNL_RIOT
-#define CCNL_MAX_NONCES                 256 // for detected dups
-#endif //CCNL_RIOT
 
 enum {
 #ifdef USE_SUITE_CCNB
@@ -255,9 +262,9 @@ typedef enum ccnl_enc_e {
 
 
 #ifdef USE_CCNxDIGEST
-#  define compute_ccnx_digest(buf) SHA256(buf->data, buf->datalen, NULL)
+#  define compute_ccnx_digest(buf, md) SHA256(buf->data, buf->datalen, md)
 #else
-#  define compute_ccnx_digest(b) NULL
+#  define compute_ccnx_digest(b, md) NULL
 #endif
 
 #endif //CCNL_DEFS_H
@@ -24,21 +24,40 @@
 #define CCNL_FACE_H
 
 #include "ccnl-sockunion.h"
+#include "ccnl-ageing.h"
+#include "ccnl-htable.h"
+#include "ccnl-rtt.h"
 
 #ifdef CCNL_RIOT
 #include "evtimer_msg.h"
 #endif
 
+/**
+ * @brief Performance of a face as next hop, used by the forwarding strategies
+ */
+struct ccnl_face_perf_s {
+    struct ccnl_rtt_s rtt;      /**< RTT of the Interests forwarded on this face */
+    uint32_t forwarded;         /**< number of Interests forwarded on this face */
+    uint32_t satisfied;         /**< number of PIT entries satisfied by content from this face */
+};
+
 struct ccnl_face_s {
     struct ccnl_face_s *next, *prev;
     int faceid;
     int ifndx;
-    sockunion peer;
     int flags;
     uint32_t last_used; // updated when we receive a packet
     struct ccnl_buf_s *outq, *outqend; // queue of packets to send
     struct ccnl_frag_s *frag;  // which special datagram armoring
     struct ccnl_sched_s *sched;
+    struct ccnl_ageq_entry_s age_entry; // in the expiry queue of the faces
+    struct ccnl_face_perf_s perf; // performance as next hop
+    struct ccnl_hentry_s peer_entry; // in the relay's index by interface and peer
+    struct ccnl_hentry_s id_entry; // in the relay's index by faceid
+    struct ccnl_pendint_s *pendints; // the PIT entries waiting for content on this face
+    struct ccnl_interest_s *interests; // the PIT entries received from this face
+    struct ccnl_forward_s *fwds; // the FIB entries via this face
+    sockunion peer; // last: its size depends on the address families
 #ifdef CCNL_RIOT
     evtimer_msg_event_t evtmsg_timeout;
 #endif
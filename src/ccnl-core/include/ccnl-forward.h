@@ -27,16 +27,24 @@
 #include "ccnl-face.h"
 #include "ccnl-relay.h"
 #include "ccnl-buf.h"
+#include "ccnl-htable.h"
+#include "ccnl-strategy.h"
  
 typedef void (*tapCallback)(struct ccnl_relay_s *, struct ccnl_face_s *,
                             struct ccnl_prefix_s *, struct ccnl_buf_s *);
 
 struct ccnl_forward_s {
     struct ccnl_forward_s *next;
+    struct ccnl_forward_s *prev;
     struct ccnl_prefix_s *prefix;
     tapCallback tap;
     struct ccnl_face_s *face;
+    struct ccnl_forward_s *face_next, *face_prev; /**< list of the FIB entries of \ref face, while linked */
     char suite;
+    struct ccnl_hentry_s fib_entry; /**< entry in the prefix index of the FIB */
+    const struct ccnl_strategy_s *strategy; /**< strategy of the prefix, NULL: the one of another next hop of the prefix, or the default */
+    uint32_t uses;                  /**< number of Interests forwarded via this entry */
+    int32_t credit;                 /**< state of the "weighted" strategy */
 };
 
 #endif //CCNL_FORWARD_H
@@ -0,0 +1,123 @@
+/*
+ * @f ccnl-htable.h
+ * @b CCN lite (CCNL), core header file (internal data structures)
+ *
+ * Copyright (C) 2011-17, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifndef CCNL_HTABLE_H
+#define CCNL_HTABLE_H
+
+#ifndef CCNL_LINUXKERNEL
+#include <stdint.h>
+#else
+#include <linux/types.h>
+#endif
+
+/**
+ * @brief Initial number of buckets, allocated on the first insert
+ */
+#ifndef CCNL_HTABLE_MIN_SIZE
+#define CCNL_HTABLE_MIN_SIZE 16
+#endif
+
+/**
+ * @brief An entry of a hash table
+ *
+ * The entry is embedded into the indexed object (content, interest, ...),
+ * so adding an object to a table does not allocate memory. A zeroed entry
+ * is not part of any table.
+ */
+struct ccnl_hentry_s {
+    struct ccnl_hentry_s *next; /**< next entry in the same bucket */
+    uint32_t hash;              /**< hash value of the key of this entry */
+    void *obj;                  /**< the indexed object, NULL if not in a table */
+};
+
+/**
+ * @brief A chained hash table with a power of two number of buckets
+ *
+ * The table only stores hash values: keys are compared by the caller
+ * when walking the candidates returned by \ref ccnl_htable_lookup.
+ * A zeroed table is a valid, empty table, the buckets are allocated
+ * lazily and the table grows when the load factor exceeds one.
+ */
+struct ccnl_htable_s {
+    struct ccnl_hentry_s **buckets; /**< array of bucket lists */
+    uint32_t size;                  /**< number of buckets, 0 if not allocated */
+    uint32_t count;                 /**< number of entries in the table */
+};
+
+/**
+ * @brief Adds an entry to a hash table
+ *
+ * @param[in] table  the hash table
+ * @param[in] entry  the entry to add (embedded in \p obj)
+ * @param[in] hash   hash value of the key of \p obj
+ * @param[in] obj    the object which is indexed
+ *
+ * @return 0 on success
+ * @return -1 if the buckets could not be allocated
+ */
+int
+ccnl_htable_add(struct ccnl_htable_s *table, struct ccnl_hentry_s *entry,
+                uint32_t hash, void *obj);
+
+/**
+ * @brief Removes an entry from a hash table
+ *
+ * Removing an entry which is not part of the table is a no-op.
+ *
+ * @param[in] table  the hash table
+ * @param[in] entry  the entry to remove
+ */
+void
+ccnl_htable_remove(struct ccnl_htable_s *table, struct ccnl_hentry_s *entry);
+
+/**
+ * @brief Returns the first entry with a given hash value
+ *
+ * @param[in] table  the hash table
+ * @param[in] hash   the hash value to look for
+ *
+ * @return the first entry with hash value \p hash, NULL if there is none
+ */
+struct ccnl_hentry_s*
+ccnl_htable_lookup(struct ccnl_htable_s *table, uint32_t hash);
+
+/**
+ * @brief Returns the next entry with the same hash value as \p entry
+ *
+ * @param[in] entry  an entry returned by \ref ccnl_htable_lookup
+ *
+ * @return the next entry with the same hash value, NULL if there is none
+ */
+struct ccnl_hentry_s*
+ccnl_htable_next(struct ccnl_hentry_s *entry);
+
+/**
+ * @brief Releases the buckets of a hash table
+ *
+ * The entries are not touched, the table is empty afterwards.
+ *
+ * @param[in] table  the hash table
+ */
+void
+ccnl_htable_cleanup(struct ccnl_htable_s *table);
+
+#endif // CCNL_HTABLE_H
@@ -44,6 +44,21 @@ int
 ccnl_http_anteselect(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http,
                      fd_set *readfs, fd_set *writefs, int *maxfd);
 
+/**
+ * @brief Serves the HTTP status page after the sockets were polled
+ *
+ * @param[in] ccnl              the relay
+ * @param[in] http              the status server
+ * @param[in] server_readable   the listening socket has a connection pending
+ * @param[in] client_readable   the client socket can be read from
+ * @param[in] client_writable   the client socket can be written to
+ *
+ * @return 0 on success, -1 if \p http is NULL
+ */
+int
+ccnl_http_io(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http,
+             int server_readable, int client_readable, int client_writable);
+
 int
 ccnl_http_postselect(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http,
                      fd_set *readfs, fd_set *writefs);
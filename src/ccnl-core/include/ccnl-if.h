@@ -30,6 +30,17 @@
 #include "ccnl-sched.h"
 #include "ccnl-face.h"
 
+/**
+ * @brief The transmit queue of an interface is a lock-free ring of
+ * configurable depth, except on the embedded targets and in the kernel,
+ * where it is an array of CCNL_MAX_IF_QLEN requests
+ */
+#if !defined(CCNL_LINUXKERNEL) && !defined(CCNL_ARDUINO) && \
+    !defined(CCNL_RIOT) && !defined(CCNL_ANDROID)
+#define CCNL_IF_RING
+#include "ccnl-ring.h"
+#endif
+
 
 
 struct ccnl_txrequest_s {
@@ -61,19 +72,93 @@ struct ccnl_if_s { // interface for packet IO
     int fwdalli; // whether to forward all I packets rcvd on this interface
     uint32_t mtu;
 
+#ifdef CCNL_IF_RING
+    struct ccnl_ring_s *txq; // pending sends, see ccnl_interface_qinit()
+#else
     size_t qlen;  // number of pending sends
     size_t qfront; // index of next packet to send
     struct ccnl_txrequest_s queue[CCNL_MAX_IF_QLEN];
+#endif
     struct ccnl_sched_s *sched;
 
 #ifdef USE_STATS
     uint32_t rx_cnt, tx_cnt;
+    uint32_t rx_batch_cnt, rx_batch_pkts; // batched receive calls and their packets
+    uint32_t tx_batch_cnt, tx_batch_pkts; // batched transmit calls and their packets
 #endif
 };
 
 void
 ccnl_interface_cleanup(struct ccnl_if_s *i);
 
+/**
+ * @brief Allocates the transmit queue of an interface
+ *
+ * Called when the interface is configured, before other threads use it:
+ * with CCNL_IF_RING any thread may then queue packets with
+ * \ref ccnl_interface_qreserve and \ref ccnl_interface_qcommit, while only
+ * the relay's thread sends them. An interface which was not set up gets
+ * a queue of the default depth when its relay first sends on it. Without
+ * CCNL_IF_RING the depth is CCNL_MAX_IF_QLEN and the queue is used by the
+ * relay's thread only.
+ *
+ * @param[in] i         the interface
+ * @param[in] depth     max number of queued packets, 0: CCNL_MAX_IF_QLEN
+ *
+ * @return 0 on success, -1 if no memory is available: the interface
+ *         then drops all packets it should send
+ */
+int
+ccnl_interface_qinit(struct ccnl_if_s *i, uint32_t depth);
+
+/**
+ * @brief Reserves the next transmit request of an interface
+ *
+ * @param[in] i         the interface
+ *
+ * @return the request to fill in, NULL if the queue is full (counted as
+ *         a drop)
+ */
+struct ccnl_txrequest_s*
+ccnl_interface_qreserve(struct ccnl_if_s *i);
+
+/**
+ * @brief Queues a request filled in after \ref ccnl_interface_qreserve
+ *
+ * @param[in] i         the interface
+ * @param[in] r         the request
+ */
+void
+ccnl_interface_qcommit(struct ccnl_if_s *i, struct ccnl_txrequest_s *r);
+
+/**
+ * @brief Returns the n-th oldest queued request (relay's thread)
+ *
+ * @param[in] i         the interface
+ * @param[in] n         0 for the next request to send
+ *
+ * @return the request, NULL if there is none
+ */
+struct ccnl_txrequest_s*
+ccnl_interface_qpeek(struct ccnl_if_s *i, uint32_t n);
+
+/**
+ * @brief Removes the oldest queued request (relay's thread), its buffer
+ * is not freed
+ *
+ * @param[in] i         the interface
+ */
+void
+ccnl_interface_qrelease(struct ccnl_if_s *i);
+
+/**
+ * @brief Returns the number of queued requests
+ *
+ * @param[in] i         the interface
+ */
+size_t
+ccnl_interface_qlen(struct ccnl_if_s *i);
+
 #if !defined(CCNL_LINUXKERNEL) && !defined(CCNL_ANDROID)
 int
 ccnl_close_socket(int s);
@@ -26,7 +26,9 @@
 #define CCNL_INTEREST_H
 
 #include "ccnl-pkt.h"
+#include "ccnl-ageing.h"
 #include "ccnl-face.h"
+#include "ccnl-htable.h"
 
 #ifdef CCNL_RIOT
 #include "evtimer_msg.h"
@@ -39,6 +41,8 @@ struct ccnl_pendint_s {
     struct ccnl_pendint_s *next; /**< pointer to the next list element */
     struct ccnl_face_s *face;    /**< pointer to incoming face  */
     uint32_t last_used;          /** */
+    struct ccnl_interest_s *interest; /**< the PIT entry this element belongs to */
+    struct ccnl_pendint_s *face_next, *face_prev; /**< list of the pending interests of \ref face */
 };
 
 /**
@@ -49,10 +53,16 @@ struct ccnl_interest_s {
     struct ccnl_interest_s *prev;       /**< pointer to the previous list element */
     struct ccnl_pkt_s *pkt;             /**< the packet the interests originates from (?) */
     struct ccnl_face_s *from;           /**< the face the interest was received from */
+    struct ccnl_interest_s *from_next, *from_prev; /**< list of the PIT entries received from \ref from */
     struct ccnl_pendint_s *pending;     /**< linked list of faces wanting that content */
     uint32_t lifetime;                  /**< interest lifetime */
     uint32_t last_used;                 /**< last time the entry was used */
     int retries;                        /**< current number of executed retransmits. */
+    uint32_t sent;                      /**< when the interest was first forwarded (\ref ccnl_rtt_now) */
+    uint32_t rto;                       /**< retransmission timeout of the next hops in ms */
+    struct ccnl_hentry_s pit_entry;     /**< entry in the name index of the PIT */
+    struct ccnl_hentry_s digest_entry;  /**< entry in the PIT index by name without implicit digest */
+    struct ccnl_ageq_entry_s age_entry; /**< entry in the retransmission queue of the PIT */
 #ifdef CCNL_RIOT
     evtimer_msg_event_t evtmsg_retrans; /**< retransmission timer */
     evtimer_msg_event_t evtmsg_timeout; /**< timeout timer for (?) */
@@ -73,6 +83,21 @@ struct ccnl_interest_s*
 ccnl_interest_new(struct ccnl_relay_s *ccnl, struct ccnl_face_s *from,
                   struct ccnl_pkt_s **pkt);
 
+/**
+ * Looks up the PIT entry which aggregates an interest
+ *
+ * Only PIT entries with the same name are visited (via the name index of
+ * the PIT), the first one for which \ref ccnl_interest_isSame holds is
+ * returned.
+ *
+ * @param[in] ccnl
+ * @param[in] pkt  the interest packet
+ *
+ * @return the matching PIT entry, NULL if there is none
+ */
+struct ccnl_interest_s*
+ccnl_interest_find(struct ccnl_relay_s *ccnl, struct ccnl_pkt_s *pkt);
+
 /**
  * Checks if two interests are the same
  * 
@@ -115,4 +140,23 @@ ccnl_interest_append_pending(struct ccnl_interest_s *i, struct ccnl_face_s *from
 int
 ccnl_interest_remove_pending(struct ccnl_interest_s *i, struct ccnl_face_s *face);
 
+/**
+ * Sets the face an interest was received from, and keeps the list of the
+ * PIT entries of the face up to date
+ *
+ * @param[in] i
+ * @param[in] from  the face, NULL for none
+ */
+void
+ccnl_interest_set_from(struct ccnl_interest_s *i, struct ccnl_face_s *from);
+
+/**
+ * Frees a pending interest which is no longer in the pending list of its
+ * PIT entry, and removes it from the list of its face
+ *
+ * @param[in] pi
+ */
+void
+ccnl_pendint_free(struct ccnl_pendint_s *pi);
+
 #endif //CCNL_INTEREST_H
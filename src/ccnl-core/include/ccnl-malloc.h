@@ -26,6 +26,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "ccnl-os-time.h"
+#include "ccnl-defs.h"
 #endif //CCNL_LINUXKERNEL
 
 
@@ -40,7 +41,12 @@ struct mhdr {
 #else
     char *tstamp; // Linux kernel (no double), also used for CCNL_UNIX
 #endif // CCNL_ARDUINO
-} *mem;
+};
+
+/**
+ * @brief The blocks allocated by the calling thread
+ */
+extern CCNL_THREAD_LOCAL struct mhdr *mem;
 #endif // USE_DEBUG_MALLOC
 
 
@@ -0,0 +1,141 @@
+/*
+ * @f ccnl-nonce.h
+ * @b CCN lite (CCNL), core header file (duplicate nonce detection)
+ *
+ * Copyright (C) 2011-17, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifndef CCNL_NONCE_H
+#define CCNL_NONCE_H
+
+#ifndef CCNL_LINUXKERNEL
+#include <stdint.h>
+#else
+#include <linux/types.h>
+#endif
+
+struct ccnl_prefix_s;
+struct ccnl_buf_s;
+
+/**
+ * @brief Default number of (name, nonce) pairs remembered per window
+ */
+#ifndef CCNL_NONCE_CAPACITY
+# if defined(CCNL_RIOT) || defined(CCNL_ARDUINO)
+#  define CCNL_NONCE_CAPACITY 64
+# else
+#  define CCNL_NONCE_CAPACITY 4096
+# endif
+#endif
+
+/**
+ * @brief Default length of a window in seconds
+ */
+#ifndef CCNL_NONCE_WINDOW
+#define CCNL_NONCE_WINDOW 4
+#endif
+
+/**
+ * @brief Time-windowed set of recently seen (name, nonce) pairs
+ *
+ * Two open addressing hash sets of 32 bit fingerprints: new pairs go
+ * into the current set, lookups check both. When the window has passed
+ * or the current set holds \p capacity pairs, the previous set is cleared
+ * and becomes the current one. A pair is therefore remembered for at
+ * least one window (unless the capacity is exceeded) and at most two.
+ *
+ * Each set has twice as many slots as \p capacity, so a check takes a
+ * constant number of probes. A new pair is taken for a duplicate if its
+ * fingerprint equals one of the remembered ones, with a probability of
+ * at most 2 * capacity / 2^32 (2 per million for the default capacity),
+ * so the false positive rate is set with the capacity.
+ *
+ * A zeroed structure is a filter with the default configuration, the
+ * sets are allocated on first use.
+ */
+struct ccnl_nonce_filter_s {
+    uint32_t *set[2];       /**< current and previous set, 0 marks an empty slot */
+    uint32_t cur;           /**< index of the current set */
+    uint32_t size;          /**< slots per set, 0 if not allocated */
+    uint32_t count[2];      /**< pairs in each set */
+    uint32_t capacity;      /**< max pairs per set, 0 selects CCNL_NONCE_CAPACITY */
+    uint32_t window;        /**< window in seconds, 0 selects CCNL_NONCE_WINDOW */
+    uint32_t rotated;       /**< when the current set was started */
+    uint32_t checked;       /**< checked pairs (total) */
+    uint32_t dups;          /**< duplicates, i.e. suppressed loops (total) */
+    uint32_t rotations;     /**< number of rotations (total) */
+};
+
+/**
+ * @brief Changes the size and the window of a filter
+ *
+ * The remembered pairs are forgotten.
+ *
+ * @param[in] f         the filter
+ * @param[in] capacity  max number of pairs per window
+ * @param[in] window    length of a window in seconds
+ *
+ * @return 0 on success
+ * @return -1 if a value is out of range
+ */
+int
+ccnl_nonce_filter_config(struct ccnl_nonce_filter_s *f, uint32_t capacity,
+                         uint32_t window);
+
+/**
+ * @brief Hashes a name and a nonce into a fingerprint
+ *
+ * @param[in] pfx    the name of the Interest
+ * @param[in] nonce  the nonce of the Interest
+ *
+ * @return the fingerprint, never 0
+ */
+uint32_t
+ccnl_nonce_hash(struct ccnl_prefix_s *pfx, struct ccnl_buf_s *nonce);
+
+/**
+ * @brief Checks whether a fingerprint was seen recently and remembers it
+ *
+ * @param[in] f      the filter
+ * @param[in] hash   the fingerprint, see \ref ccnl_nonce_hash
+ * @param[in] now    the current time in seconds
+ *
+ * @return 1 if \p hash was seen in the last one or two windows
+ * @return 0 otherwise, also if no memory is available
+ */
+int
+ccnl_nonce_filter_check(struct ccnl_nonce_filter_s *f, uint32_t hash,
+                        uint32_t now);
+
+/**
+ * @brief Returns the number of remembered pairs
+ *
+ * @param[in] f      the filter
+ */
+uint32_t
+ccnl_nonce_filter_count(struct ccnl_nonce_filter_s *f);
+
+/**
+ * @brief Releases the memory of a filter
+ *
+ * @param[in] f      the filter
+ */
+void
+ccnl_nonce_filter_cleanup(struct ccnl_nonce_filter_s *f);
+
+#endif // CCNL_NONCE_H
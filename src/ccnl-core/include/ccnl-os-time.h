@@ -76,16 +76,36 @@ timestamp(void);
 
 // ----------------------------------------------------------------------
 
+/**
+ * @brief Length of a tick of the timer wheel in microseconds
+ *
+ * Timers fire at the first tick boundary after their timeout.
+ */
+#ifndef CCNL_TIMER_TICK
+#define CCNL_TIMER_TICK         1000
+#endif
+
+/**
+ * @brief Number of levels of the timer wheel
+ *
+ * Each level has 64 slots, four levels cover 2^24 ticks (4.6 hours with
+ * the default tick), later timers are parked in the last level.
+ */
+#ifndef CCNL_TIMER_LEVELS
+#define CCNL_TIMER_LEVELS       4
+#endif
+
 struct ccnl_timer_s {
     struct ccnl_timer_s *next;
-    struct timeval timeout;
+    struct ccnl_timer_s **pprev;    /**< link to this timer, NULL if not pending */
+    uint64_t expires;               /**< tick at which the timer fires */
     void (*fct)(char,int);
     void (*fct2)(void*,void*);
     char node;
     int intarg;
     void *aux1;
     void *aux2;
-  //    int handler;
+    int slot;                       /**< slot of the timer wheel holding this timer */
 };
 
 void
@@ -98,9 +118,23 @@ void*
 ccnl_set_timer(uint64_t usec, void (*fct)(void *aux1, void *aux2),
                  void *aux1, void *aux2);
 
+/**
+ * @brief Cancels a pending timer
+ *
+ * The handle returned by \ref ccnl_set_timer is only valid until the
+ * timer fires or is removed.
+ *
+ * @param[in] h  the handle of the timer
+ */
 void
 ccnl_rem_timer(void *h);
 
+/**
+ * @brief Cancels all pending timers and releases their memory
+ */
+void
+ccnl_timer_cleanup(void);
+
 #endif
 
 #ifdef CCNL_LINUXKERNEL
@@ -159,7 +193,7 @@ ccnl_run_events(void);
 
 void*
 ccnl_set_absolute_timer(struct timeval abstime, void (*fct)(void *aux1, void *aux2),
-         void *aux1, void *aux2)
+         void *aux1, void *aux2);
 
 #endif
 
@@ -32,6 +32,7 @@
 #endif
 
 #include "ccnl-buf.h"
+#include "ccnl-defs.h"
 #include "ccnl-prefix.h"
 
 #ifdef USE_SUITE_NDNTLV
@@ -42,12 +43,20 @@
 #endif
 #endif
 
-// packet flags:  0000ebtt
+// packet flags:  000vebtt
 #define CCNL_PKT_REQUEST    0x01 // "Interest"
 #define CCNL_PKT_REPLY      0x02 // "Object", "Data"
 #define CCNL_PKT_FRAGMENT   0x03 // "Fragment"
 #define CCNL_PKT_FRAG_BEGIN 0x04 // see also CCNL_DATA_FRAG_FLAG_FIRST etc
 #define CCNL_PKT_FRAG_END   0x08
+#define CCNL_PKT_VIEW       0x10 // decoded in place, see ccnl_pkt_view_s
+
+/**
+ * @brief Maximum length of a nonce in a packet view
+ */
+#ifndef CCNL_PKT_VIEW_NONCE_LEN
+#define CCNL_PKT_VIEW_NONCE_LEN 8
+#endif
 
 /**
  * @brief Options for Interest messages of all TLV formats
@@ -108,13 +117,37 @@ struct ccnl_pkt_s {
         struct ccnl_pktdetail_ccntlv_s ccntlv;
         struct ccnl_pktdetail_ndntlv_s ndntlv;
     } s;                           /**< suite specific packet details */
+    unsigned int flags;
+    char suite;
+    // optional fields last, the common ones have the same offsets in all builds
 #ifdef USE_HMAC256
     uint8_t *hmacStart;
     size_t hmacLen;
     uint8_t *hmacSignature;
 #endif
-    unsigned int flags;
-    char suite;
+};
+
+/**
+ * @brief Storage for a packet which is decoded without allocations
+ *
+ * The *_bytes2view() parsers store the packet, its prefix and the nonce
+ * in this structure, all other pointers refer to the received bytes. The
+ * packet is flagged with CCNL_PKT_VIEW and is only valid as long as the
+ * received bytes are: code which keeps a packet (PIT, content store)
+ * first turns it into an allocated packet with \ref ccnl_pkt_own.
+ */
+struct ccnl_pkt_view_s {
+    struct ccnl_pkt_s pkt;              /**< the packet, must be the first member */
+    struct ccnl_prefix_s pfx;           /**< storage for the prefix */
+    uint8_t *comp[CCNL_MAX_NAME_COMP];  /**< storage for the name components */
+    size_t complen[CCNL_MAX_NAME_COMP]; /**< storage for the component lengths */
+    uint32_t chunknum;                  /**< storage for the chunk number */
+    uint8_t *start;                     /**< first byte of the packet */
+    size_t len;                         /**< length of the packet */
+    union {
+        struct ccnl_buf_s buf;
+        uint8_t space[sizeof(struct ccnl_buf_s) + CCNL_PKT_VIEW_NONCE_LEN];
+    } nonce;                            /**< storage for the nonce */
 };
 
 /**
@@ -125,6 +158,30 @@ struct ccnl_pkt_s {
 void
 ccnl_pkt_free(struct ccnl_pkt_s *pkt);
 
+/**
+ * @brief Prepares a packet view for one of the *_bytes2view() parsers
+ *
+ * @param[in] view      the packet view
+ * @param[in] suite     packet format of the packet which is decoded
+*/
+void
+ccnl_pkt_view_init(struct ccnl_pkt_view_s *view, char suite);
+
+/**
+ * @brief Turns a packet view into an allocated packet
+ *
+ * The packet bytes, the prefix and the nonce are copied and the pointers
+ * into the received bytes are moved to the copy. Other packets are left
+ * unchanged.
+ *
+ * @param[in,out] pkt   the packet, replaced by the allocated packet
+ *
+ * @return 0 on success
+ * @return -1 if the memory could not be allocated, \p pkt is unchanged
+*/
+int
+ccnl_pkt_own(struct ccnl_pkt_s **pkt);
+
 /**
  * @brief Duplicates a pkt data structure
  *
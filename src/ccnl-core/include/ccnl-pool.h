@@ -0,0 +1,111 @@
+/*
+ * @f ccnl-pool.h
+ * @b CCN lite (CCNL), fixed-size object pools for the hot relay objects
+ *
+ * Copyright (C) 2011-17, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifndef CCNL_POOL_H
+#define CCNL_POOL_H
+
+#ifndef CCNL_LINUXKERNEL
+#include <stddef.h>
+#include <stdint.h>
+#else
+#include <linux/types.h>
+#endif
+#include "ccnl-defs.h"
+
+/**
+ * @brief Size (and alignment) of a slab, must be a power of two
+ */
+#ifndef CCNL_POOL_SLAB_SIZE
+#define CCNL_POOL_SLAB_SIZE (64 * 1024)
+#endif
+
+/**
+ * @brief Number of name components which fit into a pooled prefix,
+ * longer names are allocated with ccnl_malloc()
+ */
+#ifndef CCNL_POOL_PREFIX_COMP
+#define CCNL_POOL_PREFIX_COMP 8
+#endif
+
+struct ccnl_pool_slab_s;
+
+/**
+ * @brief A pool of objects of one fixed size
+ *
+ * The objects are carved from slabs which are never returned to the
+ * system while one of their objects is in use. Where slabs are not
+ * available (Linux kernel, RIOT) or cannot be allocated, the pool falls
+ * back to ccnl_calloc(), and \ref ccnl_pool_free releases such objects
+ * with ccnl_free(), so objects of a pooled type may still be allocated
+ * with ccnl_malloc() by code which does not know about the pools.
+ */
+struct ccnl_pool_s {
+    const char *name;               /**< name shown in the statistics */
+    size_t size;                    /**< size of an object */
+    void *freelist;                 /**< free objects, linked through their first word */
+    struct ccnl_pool_slab_s *slabs; /**< slabs of this pool */
+    uint32_t nslabs;                /**< number of slabs */
+    uint32_t inuse;                 /**< number of objects handed out from slabs */
+    uint32_t allocs;                /**< objects allocated from slabs (total) */
+    uint32_t fallbacks;             /**< objects allocated with ccnl_calloc() (total) */
+};
+
+extern CCNL_THREAD_LOCAL struct ccnl_pool_s ccnl_pool_pkt;      /**< struct ccnl_pkt_s */
+extern CCNL_THREAD_LOCAL struct ccnl_pool_s ccnl_pool_prefix;   /**< compact struct ccnl_prefix_s */
+extern CCNL_THREAD_LOCAL struct ccnl_pool_s ccnl_pool_interest; /**< struct ccnl_interest_s */
+extern CCNL_THREAD_LOCAL struct ccnl_pool_s ccnl_pool_pendint;  /**< struct ccnl_pendint_s */
+extern CCNL_THREAD_LOCAL struct ccnl_pool_s ccnl_pool_content;  /**< struct ccnl_content_s */
+
+/**
+ * @brief Returns the NULL terminated list of the pools of the calling
+ * thread, for the statistics
+ */
+struct ccnl_pool_s**
+ccnl_pool_list(void);
+
+/**
+ * @brief Allocates a zeroed object from a pool
+ *
+ * @param[in] pool  the pool
+ *
+ * @return the object, NULL if no memory is available
+ */
+void*
+ccnl_pool_alloc(struct ccnl_pool_s *pool);
+
+/**
+ * @brief Returns an object to its pool
+ *
+ * Objects which do not belong to a slab are released with ccnl_free().
+ *
+ * @param[in] obj  the object, may be NULL
+ */
+void
+ccnl_pool_free(void *obj);
+
+/**
+ * @brief Releases the slabs of all pools which have no object in use
+ */
+void
+ccnl_pool_cleanup(void);
+
+#endif // CCNL_POOL_H
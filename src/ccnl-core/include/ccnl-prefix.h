@@ -115,6 +115,49 @@ int32_t
 ccnl_prefix_cmp(struct ccnl_prefix_s *pfx, unsigned char *md,
                 struct ccnl_prefix_s *nam, int mode);
 
+/**
+ * @brief Computes a hash value over the first components of a Prefix
+ *
+ * The hash covers the suite and the first \p compcnt components (content
+ * and length), two prefixes which are equal according to CMP_EXACT thus
+ * always have the same hash value. The chunk number is not part of the hash.
+ *
+ * @param[in] prefix    Prefix to be hashed
+ * @param[in] compcnt   Number of components to include (at most prefix->compcnt)
+ *
+ * @return      the hash value
+*/
+uint32_t
+ccnl_prefix_hash(struct ccnl_prefix_s *prefix, uint32_t compcnt);
+
+/**
+ * @brief Computes the hash values of all leading parts of a Prefix at once
+ *
+ * Fills @p hashes[k] with ccnl_prefix_hash(prefix, k) for k = 0 .. @p cnt,
+ * which is cheaper than hashing each part separately.
+ *
+ * @param[in] prefix    Prefix to be hashed
+ * @param[out] hashes   Array of at least @p cnt + 1 hash values
+ * @param[in] cnt       Number of components to include (at most prefix->compcnt)
+*/
+void
+ccnl_prefix_hashes(struct ccnl_prefix_s *prefix, uint32_t *hashes, uint32_t cnt);
+
+/**
+ * @brief Checks if a Prefix consists of exactly the first components of a name
+ *
+ * @param[in] prefix    Prefix to be checked
+ * @param[in] name      Name to compare with
+ * @param[in] compcnt   Number of leading components of @p name
+ *
+ * @return      1 if @p prefix has the suite and exactly the first @p compcnt
+ *              components of @p name
+ * @return      0 otherwise
+*/
+int
+ccnl_prefix_is_head(struct ccnl_prefix_s *prefix, struct ccnl_prefix_s *name,
+                    uint32_t compcnt);
+
 /**
  * @brief checks if a prefixname is a prefix of a content name
  *
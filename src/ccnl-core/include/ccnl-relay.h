@@ -23,30 +23,62 @@
 #ifndef CCNL_RELAY_H
 #define CCNL_RELAY_H
 
+#include "ccnl-ageing.h"
+#include "ccnl-cs-policy.h"
 #include "ccnl-defs.h"
 #include "ccnl-face.h"
+#include "ccnl-htable.h"
 #include "ccnl-if.h"
+#include "ccnl-nonce.h"
 #include "ccnl-pkt.h"
 #include "ccnl-sched.h"
+#include "ccnl-strategy.h"
 
 
 struct ccnl_relay_s {
     void (*ccnl_ll_TX_ptr)(struct ccnl_relay_s*, struct ccnl_if_s*,
         sockunion*, struct ccnl_buf_s*);
+    int (*ccnl_ll_TXv_ptr)(struct ccnl_relay_s*, struct ccnl_if_s*,
+        struct ccnl_txrequest_s**, int); /**< batched transmit, optional, see ccnl_interface_flush() */
+    int (*ccnl_handoff_ptr)(struct ccnl_relay_s*, struct ccnl_face_s*,
+        struct ccnl_pkt_s*); /**< passes a received packet to another relay (shard), optional: nonzero if it was taken */
+    int (*ccnl_cs_load_ptr)(struct ccnl_relay_s*,
+        struct ccnl_pkt_s*); /**< loads the content an Interest asks for from a backing store into the content store, optional: number of objects loaded */
+    void (*ccnl_cs_evict_ptr)(struct ccnl_relay_s*,
+        struct ccnl_content_s*); /**< hands content evicted from the content store to a backing store, optional */
+    void *cs_store;             /**< the backing store of the content store, see ccnl_cs_load_ptr */
 #ifndef CCNL_ARDUINO
     time_t startup_time;
 #endif
     int id;
     struct ccnl_face_s *faces;  /**< The existing forwarding faces */
+    struct ccnl_htable_s face_index; /**< index over the faces by interface and peer address */
+    struct ccnl_htable_s faceid_index; /**< index over the faces by faceid */
     struct ccnl_forward_s *fib; /**< The Forwarding Information Base (FIB) */
+    struct ccnl_htable_s fib_index; /**< index over the FIB by prefix */
 
     struct ccnl_interest_s *pit; /**< The Pending Interest Table (PIT) */
+    struct ccnl_htable_s pit_index; /**< name index over the PIT */
+    struct ccnl_htable_s pit_digest_index; /**< PIT entries which may name an implicit digest, by name without it */
     struct ccnl_content_s *contents; /**< contentsend; */
-    struct ccnl_buf_s *nonces;  /**< The nonces that are currently in use */
+    struct ccnl_htable_s cs_index; /**< name index over the content store */
+    struct ccnl_cs_policy_s cs_policy; /**< replacement policy of the content store */
+    struct ccnl_cs_sketch_s cs_sketch; /**< admission filter of the content store */
+    struct ccnl_cs_stats_s cs_stats; /**< hits of the content store and its backing store */
+    struct ccnl_nonce_filter_s nonce_filter; /**< recently seen Interest nonces, for loop detection */
     int contentcnt;             /**< number of cached items */
     int max_cache_entries;      /**< max number of cached items -1: unlimited */
+    size_t cache_bytes;         /**< memory used by cached items, see ccnl_content_size() */
+    size_t max_cache_bytes;     /**< max memory used by cached items; 0: unlimited */
     int pitcnt;                 /**< Number of entries in the PIT */
     int max_pit_entries;        /**< max number of pit entries; -1: unlimited */ 
+    struct ccnl_ageq_s cs_ageq;   /**< cached content, by expiry */
+    struct ccnl_ageq_s pit_ageq;  /**< PIT entries, by next retransmission */
+    struct ccnl_ageq_s face_ageq; /**< faces, by expiry */
+    struct ccnl_ageing_stats_s ageing; /**< durations of the ageing ticks */
+    const struct ccnl_strategy_s *strategy; /**< default forwarding strategy, NULL for "multicast" */
+    uint32_t fib_version;       /**< incremented on each change of the FIB */
+    uint32_t if_qlen;           /**< depth of the interfaces' transmit queues; 0: CCNL_MAX_IF_QLEN */
     struct ccnl_if_s ifs[CCNL_MAX_INTERFACES];
     int ifcount;               /**< number of active interfaces */
     char halt_flag;            /**< Flag to interrupt the IO_Loop and to exit the relay */
@@ -89,6 +121,17 @@ ccnl_get_face_or_create(struct ccnl_relay_s *ccnl, int ifndx,
 struct ccnl_face_s*
 ccnl_face_remove(struct ccnl_relay_s *ccnl, struct ccnl_face_s *f);
 
+/**
+ * @brief Returns the face with a given faceid
+ *
+ * @param[in] ccnl      the relay
+ * @param[in] faceid    the faceid
+ *
+ * @return the face, NULL if there is none
+ */
+struct ccnl_face_s*
+ccnl_face_find(struct ccnl_relay_s *ccnl, int faceid);
+
 void
 ccnl_interface_enqueue(void (tx_done)(void*, int, int), struct ccnl_face_s *f,
                        struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc,
@@ -135,6 +178,9 @@ ccnl_interest_remove(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i);
 /**
  * @brief Forwards interest message according to FIB rules 
  *
+ * The PIT entry is then due for its next retransmission after the largest
+ * RTO of the faces it was sent to, backed off by its number of retries.
+ *
  * @param[in] ccnl  pointer to current ccnl relay
  * @param[in] i     interest message to be forwarded
 */
@@ -159,23 +205,64 @@ ccnl_content_remove(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c);
 struct ccnl_content_s*
 ccnl_content_add2cache(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c);
 
+/**
+ * @brief Looks up content in the content store by name
+ *
+ * Returns the cached content objects whose name consists of exactly the
+ * first @p compcnt components of @p pfx, one per call. The chunk number
+ * is not compared, callers apply their own matching on the result.
+ *
+ * @param[in] ccnl     pointer to current ccnl relay
+ * @param[in] pfx      the name to look for
+ * @param[in] compcnt  number of components of @p pfx to match
+ * @param[in] prev     NULL to get the first match, else the previous match
+ *
+ * @return   the next content object with this name
+ * @return   NULL, if there are no more matches
+*/
+struct ccnl_content_s*
+ccnl_content_lookup(struct ccnl_relay_s *ccnl, struct ccnl_prefix_s *pfx,
+                    uint32_t compcnt, struct ccnl_content_s *prev);
+
 /**
  * @brief deliver new content @p c to all clients with (loosely) matching interest 
  *
+ * The time since the insertion of each satisfied PIT entry which was not
+ * retransmitted is an RTT sample of the face @p from.
+ *
  * @param[in] ccnl  pointer to current ccnl relay
+ * @param[in] from  face the content was received from, NULL for local content
  * @param[in] c     content to be sent
  *
  * @return   number of faces to which the content was sent to
 */
 int
-ccnl_content_serve_pending(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c);
+ccnl_content_serve_pending(struct ccnl_relay_s *ccnl, struct ccnl_face_s *from,
+                           struct ccnl_content_s *c);
 
+/**
+ * @brief Expires content, PIT entries and faces, and retransmits Interests
+ *
+ * Only the entries which are due are visited, at most CCNL_AGEING_BUDGET
+ * of each kind per call: the platforms call this every
+ * CCNL_AGEING_INTERVAL microseconds (or at least once a second).
+ *
+ * @param[in] ptr    pointer to current ccnl relay
+ * @param[in] dummy  unused
+ */
 void
 ccnl_do_ageing(void *ptr, void *dummy);
 
-int
-ccnl_nonce_find_or_append(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *nonce);
-
+/**
+ * @brief Checks whether an Interest with the same name and nonce was
+ * received recently, and remembers this one
+ *
+ * @param[in] relay  pointer to current ccnl relay
+ * @param[in] pkt    the Interest
+ *
+ * @return 1 if the Interest is a duplicate (looped)
+ * @return 0 otherwise, also for Interests without a nonce
+ */
 int
 ccnl_nonce_isDup(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt);
 
@@ -212,6 +299,64 @@ ccnl_fib_rem_entry(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx,
                    struct ccnl_face_s *face);
 #endif //NEEDS_PREFIX_MATCHING
 
+/**
+ * @brief Links an entry into the FIB
+ *
+ * The entry is added to the FIB list and to the prefix index used for
+ * longest prefix matching. Use this instead of manipulating relay->fib.
+ *
+ * @par[in] relay   Local relay struct
+ * @par[in] fwd     the FIB entry
+ *
+ * @return 0    on success
+ * @return -1   on error
+ */
+int
+ccnl_fib_link(struct ccnl_relay_s *relay, struct ccnl_forward_s *fwd);
+
+/**
+ * @brief Unlinks an entry from the FIB, the entry itself is not freed
+ *
+ * @par[in] relay   Local relay struct
+ * @par[in] fwd     the FIB entry
+ */
+void
+ccnl_fib_unlink(struct ccnl_relay_s *relay, struct ccnl_forward_s *fwd);
+
+/**
+ * @brief Looks up the FIB entries for a prefix
+ *
+ * Returns the entries whose prefix consists of exactly the first
+ * @p compcnt components of @p pfx, one per call. There is one entry per
+ * next hop of a prefix.
+ *
+ * @par[in] relay   Local relay struct
+ * @par[in] pfx     the name to look for
+ * @par[in] compcnt number of components of @p pfx to match
+ * @par[in] prev    NULL to get the first entry, else the previous entry
+ *
+ * @return the next FIB entry for this prefix, NULL if there are no more
+ */
+struct ccnl_forward_s*
+ccnl_fib_lookup(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx,
+                uint32_t compcnt, struct ccnl_forward_s *prev);
+
+/**
+ * @brief Longest prefix match in the FIB
+ *
+ * Probes the prefix index once per name component, starting with the
+ * full name. Further next hops of the matched prefix are obtained with
+ * @ref ccnl_fib_lookup.
+ *
+ * @par[in] relay   Local relay struct
+ * @par[in] pfx     the name to look for
+ *
+ * @return the first FIB entry of the longest matching prefix
+ * @return NULL if no prefix matches
+ */
+struct ccnl_forward_s*
+ccnl_fib_longest_match(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx);
+
 /**
  * @brief Prints the current FIB
  *
@@ -231,6 +376,24 @@ ccnl_cs_dump(struct ccnl_relay_s *ccnl);
 void
 ccnl_interface_CTS(void *aux1, void *aux2);
 
+/**
+ * @brief Sends all packets queued at an interface
+ *
+ * If the relay has a batched transmit function (ccnl_ll_TXv_ptr), packets
+ * handed to \ref ccnl_interface_enqueue are only queued, and the platform
+ * calls this function before it waits for I/O. The queue is then handed
+ * to ccnl_ll_TXv_ptr, which may send several packets with one system call.
+ * Without it, the packets are sent one at a time.
+ *
+ * Packets which could not be sent stay queued and are sent by
+ * \ref ccnl_interface_CTS when the interface becomes writable.
+ *
+ * @param[in] ccnl  the relay
+ * @param[in] ifc   the interface
+ */
+void
+ccnl_interface_flush(struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc);
+
 #define DBL_LINKED_LIST_ADD(l,e) \
   do { if ((l)) (l)->prev = (e); \
        (e)->next = (l); \
@@ -293,9 +456,9 @@ ccnl_cs_lookup(struct ccnl_relay_s *ccnl, char *prefix);
  * The given function will be called if the cache is full and a new content
  * chunk arrives. It shall remove (at least) one entry from the cache.
  *
- * If the return value of @p func is 0, the default caching strategy will be
- * applied by the CCN-lite stack. If the return value is 1, it is assumed that
- * (at least) one entry has been removed from the cache.
+ * If the return value of @p func is 0, the replacement policy of the content
+ * store (see @ref ccnl_cs_set_policy) evicts an entry. If the return value is
+ * 1, it is assumed that (at least) one entry has been removed from the cache.
  *
  * @param[in] func  The function to be called for an incoming content chunk if
  *                  the cache is full.
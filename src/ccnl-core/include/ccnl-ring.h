@@ -0,0 +1,156 @@
+/*
+ * @f ccnl-ring.h
+ * @b CCN lite (CCNL), core header file (lock-free message rings)
+ *
+ * Copyright (C) 2011-17, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifndef CCNL_RING_H
+#define CCNL_RING_H
+
+// C11 atomics: not available in the Linux kernel and on the Arduino
+#if !defined(CCNL_LINUXKERNEL) && !defined(CCNL_ARDUINO)
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Size of a cache line, the producer and the consumer side of a
+ * ring and the slots are aligned to it
+ */
+#ifndef CCNL_RING_CACHELINE
+#define CCNL_RING_CACHELINE     64
+#endif
+
+/**
+ * @brief Max number of elements of a ring
+ */
+#define CCNL_RING_MAX_DEPTH     (1UL << 20)
+
+/**
+ * @brief A bounded lock-free queue of fixed size elements
+ *
+ * Any number of threads may produce, one thread consumes (MPSC). The
+ * elements are written and read in place: a producer reserves a slot,
+ * fills it and commits it, the consumer peeks at the oldest committed
+ * element and releases it when done. Each slot carries a sequence number
+ * which tells whose turn it is, so producers only contend on the tail
+ * counter and never wait for each other, and a full ring drops rather
+ * than blocks.
+ */
+struct ccnl_ring_s {
+    _Alignas(CCNL_RING_CACHELINE)
+    _Atomic uint32_t tail;      /**< next position to reserve (producers) */
+    _Alignas(CCNL_RING_CACHELINE)
+    _Atomic uint32_t head;      /**< next position to consume (consumer) */
+    _Alignas(CCNL_RING_CACHELINE)
+    uint8_t *slots;             /**< the slots, CCNL_RING_CACHELINE aligned */
+    size_t stride;              /**< size of a slot */
+    uint32_t depth;             /**< number of slots, a power of two */
+    _Atomic uint32_t drops;     /**< elements not queued because the ring was full */
+    _Atomic uint32_t highwater; /**< max number of queued elements */
+};
+
+/**
+ * @brief Allocates the slots of a ring
+ *
+ * @param[in] r         the ring
+ * @param[in] depth     number of elements, rounded up to a power of two
+ * @param[in] elemsize  size of an element
+ *
+ * @return 0 on success, -1 if the arguments are invalid or no memory is
+ * available
+ */
+int
+ccnl_ring_init(struct ccnl_ring_s *r, uint32_t depth, size_t elemsize);
+
+/**
+ * @brief Releases the slots of a ring, queued elements are discarded
+ *
+ * @param[in] r         the ring
+ */
+void
+ccnl_ring_cleanup(struct ccnl_ring_s *r);
+
+/**
+ * @brief Reserves the slot for the next element (any thread)
+ *
+ * @param[in] r         the ring
+ *
+ * @return the element to fill in, NULL if the ring is full (counted as
+ * a drop)
+ */
+void*
+ccnl_ring_reserve(struct ccnl_ring_s *r);
+
+/**
+ * @brief Hands a filled element to the consumer
+ *
+ * @param[in] r         the ring
+ * @param[in] elem      the element returned by \ref ccnl_ring_reserve
+ */
+void
+ccnl_ring_commit(struct ccnl_ring_s *r, void *elem);
+
+/**
+ * @brief Returns the oldest element (consumer thread)
+ *
+ * The element stays queued until it is released. Elements are consumed
+ * in the order they were reserved: an element reserved but not yet
+ * committed holds back the ones behind it.
+ *
+ * @param[in] r         the ring
+ *
+ * @return the element, NULL if there is none
+ */
+void*
+ccnl_ring_peek(struct ccnl_ring_s *r);
+
+/**
+ * @brief Returns the n-th oldest element (consumer thread), so that
+ * several elements can be processed before they are released
+ *
+ * @param[in] r         the ring
+ * @param[in] n         0 for the oldest element
+ *
+ * @return the element, NULL if it is not committed yet
+ */
+void*
+ccnl_ring_peek_nth(struct ccnl_ring_s *r, uint32_t n);
+
+/**
+ * @brief Frees the slot of the oldest element (consumer thread)
+ *
+ * @param[in] r         the ring
+ */
+void
+ccnl_ring_release(struct ccnl_ring_s *r);
+
+/**
+ * @brief Returns the number of reserved elements, exact only when no
+ * other thread uses the ring
+ *
+ * @param[in] r         the ring
+ */
+uint32_t
+ccnl_ring_count(struct ccnl_ring_s *r);
+
+#endif // !CCNL_LINUXKERNEL && !CCNL_ARDUINO
+
+#endif // CCNL_RING_H
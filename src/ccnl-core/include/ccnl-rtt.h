@@ -0,0 +1,103 @@
+/*
+ * @f ccnl-rtt.h
+ * @b CCN lite (CCNL), core header file (RTT and RTO estimation)
+ *
+ * Copyright (C) 2011-17, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifndef CCNL_RTT_H
+#define CCNL_RTT_H
+
+#ifndef CCNL_LINUXKERNEL
+#include <stdint.h>
+#else
+#include <linux/types.h>
+#endif
+
+/**
+ * @brief Retransmission timeout in milliseconds before the first RTT sample
+ */
+#ifndef CCNL_RTO_INITIAL
+#define CCNL_RTO_INITIAL        1000
+#endif
+
+/**
+ * @brief Lower bound of the retransmission timeout in milliseconds
+ */
+#ifndef CCNL_RTO_MIN
+#define CCNL_RTO_MIN            200
+#endif
+
+/**
+ * @brief Upper bound of the retransmission timeout in milliseconds, also
+ * after the exponential backoff
+ */
+#ifndef CCNL_RTO_MAX
+#define CCNL_RTO_MAX            4000
+#endif
+
+/**
+ * @brief RTT estimation of a face (RFC 6298), all values in milliseconds
+ */
+struct ccnl_rtt_s {
+    uint32_t srtt;                      /**< smoothed RTT */
+    uint32_t rttvar;                    /**< RTT variation */
+    uint32_t rto;                       /**< retransmission timeout, 0 before the first sample */
+    uint32_t samples;                   /**< number of samples */
+};
+
+/**
+ * @brief Returns the current time of the millisecond clock used for the
+ * RTT samples and the retransmissions
+ *
+ * The clock wraps, only differences of its values are meaningful.
+ */
+uint32_t
+ccnl_rtt_now(void);
+
+/**
+ * @brief Adds an RTT sample to the estimation
+ *
+ * @param[in] r      the estimation
+ * @param[in] rtt    the measured RTT in milliseconds
+ */
+void
+ccnl_rtt_sample(struct ccnl_rtt_s *r, uint32_t rtt);
+
+/**
+ * @brief Returns the retransmission timeout of an estimation
+ *
+ * @param[in] r      the estimation, may be NULL
+ *
+ * @return the timeout in milliseconds, CCNL_RTO_INITIAL without samples
+ */
+uint32_t
+ccnl_rtt_rto(const struct ccnl_rtt_s *r);
+
+/**
+ * @brief Applies the exponential backoff to a retransmission timeout
+ *
+ * @param[in] rto      the timeout in milliseconds
+ * @param[in] retries  the number of retransmissions done
+ *
+ * @return rto * 2^retries, at most CCNL_RTO_MAX
+ */
+uint32_t
+ccnl_rtt_backoff(uint32_t rto, int retries);
+
+#endif // CCNL_RTT_H
@@ -130,6 +130,17 @@ char* ccnl_addr2ascii(sockunion *su);
 int
 ccnl_addr_cmp(sockunion *s1, sockunion *s2);
 
+/**
+ * @brief Returns a hash value of the parts of an address which
+ * \ref ccnl_addr_cmp compares
+ *
+ * @param[in] su    the address
+ *
+ * @return the hash value, equal for addresses which compare equal
+ */
+uint32_t
+ccnl_addr_hash(sockunion *su);
+
 char*
 ll2ascii(unsigned char *addr, size_t len);
 
@@ -0,0 +1,141 @@
+/*
+ * @f ccnl-strategy.h
+ * @b CCN lite (CCNL), core header file (forwarding strategies)
+ *
+ * Copyright (C) 2011-17, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifndef CCNL_STRATEGY_H
+#define CCNL_STRATEGY_H
+
+#ifndef CCNL_LINUXKERNEL
+#include <stdint.h>
+#else
+#include <linux/types.h>
+#endif
+
+struct ccnl_relay_s;
+struct ccnl_interest_s;
+struct ccnl_forward_s;
+struct ccnl_prefix_s;
+
+/**
+ * @brief Max number of next hops of a prefix offered to a strategy, further
+ * FIB entries of the prefix are not used
+ */
+#ifndef CCNL_MAX_NEXTHOPS
+#define CCNL_MAX_NEXTHOPS       16
+#endif
+
+/**
+ * @brief Max number of registered strategies, including the built-in ones
+ */
+#ifndef CCNL_MAX_STRATEGIES
+#define CCNL_MAX_STRATEGIES     8
+#endif
+
+/**
+ * @brief Chooses the next hops an Interest is forwarded to
+ *
+ * The candidates are the FIB entries of the longest prefix matching the
+ * Interest, without the face the Interest came from. The function moves
+ * the chosen entries to the front of @p nh and returns their number. It
+ * is also called for the retransmissions, i->retries tells which one.
+ *
+ * @param[in] relay  the relay
+ * @param[in] i      the PIT entry to forward
+ * @param[in,out] nh the candidates
+ * @param[in] cnt    the number of candidates, at least 1
+ *
+ * @return the number of next hops to use, from the front of @p nh
+ */
+typedef int (*ccnl_strategy_func)(struct ccnl_relay_s *relay,
+                                  struct ccnl_interest_s *i,
+                                  struct ccnl_forward_s **nh, int cnt);
+
+/**
+ * @brief A registered forwarding strategy
+ */
+struct ccnl_strategy_s {
+    const char *name;                   /**< name to select the strategy */
+    ccnl_strategy_func choose;          /**< chooses the next hops */
+};
+
+/**
+ * @brief Registers a forwarding strategy
+ *
+ * Built in are "multicast" (all next hops, the default), "best-route"
+ * (the next hop with the lowest RTO, retransmissions try the others in
+ * turn), "round-robin" (the least used next hop) and "weighted" (one next
+ * hop, each with a share of the Interests inverse to its RTO).
+ *
+ * @param[in] name    the name of the strategy, must stay valid
+ * @param[in] choose  the function choosing the next hops
+ *
+ * @return the strategy
+ * @return NULL if the name is taken or there is no room left
+ */
+const struct ccnl_strategy_s*
+ccnl_strategy_register(const char *name, ccnl_strategy_func choose);
+
+/**
+ * @brief Looks up a forwarding strategy by its name
+ *
+ * @param[in] name    the name
+ *
+ * @return the strategy, NULL if there is none of this name
+ */
+const struct ccnl_strategy_s*
+ccnl_strategy_find(const char *name);
+
+/**
+ * @brief Selects the forwarding strategy of a FIB prefix
+ *
+ * Applies to the next hops of the prefix known now and is taken over by
+ * those added later.
+ *
+ * @param[in] relay     the relay
+ * @param[in] pfx       the prefix
+ * @param[in] strategy  the strategy, NULL for the default of the relay
+ *
+ * @return 0 on success
+ * @return -1 if the FIB has no entry for @p pfx
+ */
+int
+ccnl_fib_set_strategy(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx,
+                      const struct ccnl_strategy_s *strategy);
+
+/**
+ * @brief Chooses the next hops of an Interest
+ *
+ * @param[in] relay     the relay
+ * @param[in] strategy  the strategy of the matched prefix, NULL for the
+ *                      default strategy of the relay
+ * @param[in] i         the PIT entry to forward
+ * @param[in,out] nh    the candidates, see \ref ccnl_strategy_func
+ * @param[in] cnt       the number of candidates, at least 1
+ *
+ * @return the number of next hops to use, from the front of @p nh
+ */
+int
+ccnl_strategy_choose(struct ccnl_relay_s *relay,
+                     const struct ccnl_strategy_s *strategy,
+                     struct ccnl_interest_s *i,
+                     struct ccnl_forward_s **nh, int cnt);
+
+#endif // CCNL_STRATEGY_H
@@ -0,0 +1,126 @@
+/*
+ * @f ccnl-ageing.c
+ * @b CCN lite (CCNL), expiry queues for the ageing
+ *
+ * Copyright (C) 2011-17, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifndef CCNL_LINUXKERNEL
+#include <stddef.h>
+#include "ccnl-ageing.h"
+#else
+#include "../include/ccnl-ageing.h"
+#endif
+
+// t1 is not before t2, also across a wrap of the clock
+#define CCNL_AGEQ_NOT_BEFORE(t1, t2)    ((int32_t) ((t1) - (t2)) >= 0)
+
+void
+ccnl_ageq_add(struct ccnl_ageq_s *q, struct ccnl_ageq_entry_s *e,
+              uint32_t due, void *obj)
+{
+    if (q->tail && !CCNL_AGEQ_NOT_BEFORE(due, q->tail->due)) {
+        due = q->tail->due;
+    }
+    e->due = due;
+    e->obj = obj;
+    e->next = NULL;
+    e->prev = q->tail;
+    if (q->tail) {
+        q->tail->next = e;
+    } else {
+        q->head = e;
+    }
+    q->tail = e;
+    q->count++;
+}
+
+void
+ccnl_ageq_insert(struct ccnl_ageq_s *q, struct ccnl_ageq_entry_s *e,
+                 uint32_t due, void *obj)
+{
+    struct ccnl_ageq_entry_s *p = q->tail;
+
+    // entries are mostly due late: search the position from the tail
+    while (p && !CCNL_AGEQ_NOT_BEFORE(due, p->due)) {
+        p = p->prev;
+    }
+    e->due = due;
+    e->obj = obj;
+    e->prev = p;
+    e->next = p ? p->next : q->head;
+    if (e->next) {
+        e->next->prev = e;
+    } else {
+        q->tail = e;
+    }
+    if (p) {
+        p->next = e;
+    } else {
+        q->head = e;
+    }
+    q->count++;
+}
+
+void
+ccnl_ageq_remove(struct ccnl_ageq_s *q, struct ccnl_ageq_entry_s *e)
+{
+    if (!e->obj) {
+        return;
+    }
+    if (e->prev) {
+        e->prev->next = e->next;
+    } else {
+        q->head = e->next;
+    }
+    if (e->next) {
+        e->next->prev = e->prev;
+    } else {
+        q->tail = e->prev;
+    }
+    e->next = e->prev = NULL;
+    e->obj = NULL;
+    q->count--;
+}
+
+void*
+ccnl_ageq_due(struct ccnl_ageq_s *q, uint32_t now)
+{
+    if (q->head && CCNL_AGEQ_NOT_BEFORE(now, q->head->due)) {
+        return q->head->obj;
+    }
+    return NULL;
+}
+
+void
+ccnl_ageing_record(struct ccnl_ageing_stats_s *stats, long usec)
+{
+    int k = 0;
+
+    if (usec < 0) {
+        usec = 0;
+    }
+    while (k < CCNL_AGEING_HIST - 1 && usec >= (16L << (2 * k))) {
+        k++;
+    }
+    stats->hist[k]++;
+    stats->ticks++;
+    if ((unsigned long) usec > stats->max_usec) {
+        stats->max_usec = (uint32_t) usec;
+    }
+}
@@ -29,6 +29,7 @@
 #include "ccnl-forward.h"
 #include "ccnl-prefix.h"
 #include "ccnl-malloc.h"
+#include "ccnl-pool.h"
 #else
 #include "../include/ccnl-os-time.h"
 #include "../include/ccnl-buf.h"
@@ -37,6 +38,7 @@
 #include "../include/ccnl-forward.h"
 #include "../include/ccnl-prefix.h"
 #include "../include/ccnl-malloc.h"
+#include "../include/ccnl-pool.h"
 #endif
 
 struct ccnl_buf_s*
@@ -48,6 +50,7 @@ ccnl_buf_new(void *data, size_t len)
         return NULL;
     }
     b->next = NULL;
+    b->refcnt = 1;
     b->datalen = len;
     if (data) {
         memcpy(b->data, data, len);
@@ -55,6 +58,23 @@ ccnl_buf_new(void *data, size_t len)
     return b;
 }
 
+struct ccnl_buf_s*
+ccnl_buf_ref(struct ccnl_buf_s *buf)
+{
+    if (buf) {
+        buf->refcnt++;
+    }
+    return buf;
+}
+
+void
+ccnl_buf_free(struct ccnl_buf_s *buf)
+{
+    if (buf && --buf->refcnt == 0) {
+        ccnl_free(buf);
+    }
+}
+
 void
 ccnl_core_cleanup(struct ccnl_relay_s *ccnl)
 {
@@ -64,21 +84,26 @@ ccnl_core_cleanup(struct ccnl_relay_s *ccnl)
 
     while (ccnl->pit)
         ccnl_interest_remove(ccnl, ccnl->pit);
+    ccnl_htable_cleanup(&ccnl->pit_index);
+    ccnl_htable_cleanup(&ccnl->pit_digest_index);
     while (ccnl->faces)
         ccnl_face_remove(ccnl, ccnl->faces); // removes allmost all FWD entries
+    ccnl_htable_cleanup(&ccnl->face_index);
+    ccnl_htable_cleanup(&ccnl->faceid_index);
     while (ccnl->fib) {
-        struct ccnl_forward_s *fwd = ccnl->fib->next;
-        ccnl_prefix_free(ccnl->fib->prefix);
-        ccnl_free(ccnl->fib);
-        ccnl->fib = fwd;
+        struct ccnl_forward_s *fwd = ccnl->fib;
+        ccnl_fib_unlink(ccnl, fwd);
+        ccnl_prefix_free(fwd->prefix);
+        ccnl_free(fwd);
     }
+    ccnl_htable_cleanup(&ccnl->fib_index);
     while (ccnl->contents)
         ccnl_content_remove(ccnl, ccnl->contents);
-    while (ccnl->nonces) {
-        struct ccnl_buf_s *tmp = ccnl->nonces->next;
-        ccnl_free(ccnl->nonces);
-        ccnl->nonces = tmp;
-    }
+    ccnl_htable_cleanup(&ccnl->cs_index);
+    ccnl_cs_policy_cleanup(ccnl);
+    ccnl_cs_set_admission(ccnl, 0);
+    ccnl_nonce_filter_cleanup(&ccnl->nonce_filter);
     for (k = 0; k < ccnl->ifcount; k++)
         ccnl_interface_cleanup(ccnl->ifs + k);
+    ccnl_pool_cleanup();
 }
@@ -23,14 +23,19 @@
 #ifndef CCNL_LINUXKERNEL
 #include "ccnl-content.h"
 #include "ccnl-malloc.h"
+#include "ccnl-pool.h"
 #include "ccnl-prefix.h"
 #include "ccnl-pkt.h"
 #include "ccnl-os-time.h"
 #include "ccnl-logging.h"
 #include "ccnl-defs.h"
+#if defined(USE_CCNxDIGEST) && !defined(CCNL_RIOT) && !defined(CCNL_ANDROID)
+#include <openssl/sha.h>
+#endif
 #else
 #include "../include/ccnl-content.h"
 #include "../include/ccnl-malloc.h"
+#include "../include/ccnl-pool.h"
 #include "../include/ccnl-prefix.h"
 #include "../include/ccnl-pkt.h"
 #include "../include/ccnl-os-time.h"
@@ -54,7 +59,10 @@ ccnl_content_new(struct ccnl_pkt_s **pkt)
              (void*) *pkt, ccnl_prefix_to_str((*pkt)->pfx, s, CCNL_MAX_PREFIX_SIZE),
              ((*pkt)->pfx->chunknum) ? (long unsigned) *((*pkt)->pfx->chunknum) : (long unsigned) 0);
 
-    c = (struct ccnl_content_s *) ccnl_calloc(1, sizeof(struct ccnl_content_s));
+    if (ccnl_pkt_own(pkt)) {
+        return NULL;
+    }
+    c = (struct ccnl_content_s *) ccnl_pool_alloc(&ccnl_pool_content);
     if (!c)
         return NULL;
     c->pkt = *pkt;
@@ -65,6 +73,32 @@ ccnl_content_new(struct ccnl_pkt_s **pkt)
     return c;
 }
 
+int
+ccnl_content_is_stale(struct ccnl_content_s *c)
+{
+#ifdef USE_SUITE_NDNTLV
+    if (!(c->flags & (CCNL_CONTENT_FLAGS_STALE | CCNL_CONTENT_FLAGS_STATIC)) &&
+        c->pkt->suite == CCNL_SUITE_NDNTLV &&
+        (c->last_used + (c->pkt->s.ndntlv.freshnessperiod / 1000)) <= (uint32_t) CCNL_NOW()) {
+        c->flags |= CCNL_CONTENT_FLAGS_STALE;
+    }
+#endif
+    return (c->flags & CCNL_CONTENT_FLAGS_STALE) != 0;
+}
+
+unsigned char*
+ccnl_content_digest(struct ccnl_content_s *c)
+{
+    if (!(c->flags & CCNL_CONTENT_FLAGS_DIGEST)) {
+        // OpenSSL picks the SHA extensions or AVX2 code of the CPU
+        if (!compute_ccnx_digest(c->pkt->buf, c->digest)) {
+            return NULL;
+        }
+        c->flags |= CCNL_CONTENT_FLAGS_DIGEST;
+    }
+    return c->digest;
+}
+
 int 
 ccnl_content_free(struct ccnl_content_s *content) 
 {
@@ -73,10 +107,38 @@ ccnl_content_free(struct ccnl_content_s *content)
             ccnl_pkt_free(content->pkt);
         }
         
-        ccnl_free(content);
+        ccnl_pool_free(content);
 
         return 0;
     }
 
     return -1;
 }
+
+size_t
+ccnl_content_size(struct ccnl_content_s *content)
+{
+    struct ccnl_prefix_s *pfx;
+    size_t size = sizeof(*content);
+    uint32_t i;
+
+    if (!content->pkt) {
+        return size;
+    }
+    size += sizeof(*content->pkt);
+    if (content->pkt->buf) {
+        size += sizeof(*content->pkt->buf) + content->pkt->buf->datalen;
+    }
+    pfx = content->pkt->pfx;
+    if (pfx) {
+        size += sizeof(*pfx) + pfx->compcnt * (sizeof(*pfx->comp) + sizeof(*pfx->complen));
+        for (i = 0; i < pfx->compcnt; i++) {
+            size += pfx->complen[i];
+        }
+        if (pfx->chunknum) {
+            size += sizeof(*pfx->chunknum);
+        }
+    }
+
+    return size;
+}
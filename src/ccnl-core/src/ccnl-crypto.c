@@ -402,12 +402,7 @@ ccnl_mgmt_crypto(struct ccnl_relay_s *ccnl, char *type, unsigned char *buf, int
       len2 +=len;
       msg2[len2++] = 0;
 
-      from = ccnl->faces;
-      while(from){
-          if(from->faceid == seqnum)
-              break;
-          from = from->next;
-      }
+      from = ccnl_face_find(ccnl, seqnum);
 
       buf1 = ccnl_ccnb_extract(&msg2, &len2, &scope, &aok, &minsfx,
                          &maxsfx, &p, &nonce, &ppkd, &content, &contlen);
@@ -439,12 +434,7 @@ ccnl_mgmt_crypto(struct ccnl_relay_s *ccnl, char *type, unsigned char *buf, int
       len1 +=len;
 
       out[len1++] = 0; // end-of-interest
-      from = ccnl->faces;
-      while(from){
-          if(from->faceid == seqnum)
-              break;
-          from = from->next;
-      }
+      from = ccnl_face_find(ccnl, seqnum);
 
       retbuf = ccnl_buf_new((char *)out, len1);
       if(seqnum >= 0){
@@ -479,8 +469,10 @@ ccnl_mgmt_crypto(struct ccnl_relay_s *ccnl, char *type, unsigned char *buf, int
                                 content, contlen);
           if (!c) goto Done;
 
-          ccnl_content_serve_pending(ccnl, c);
-          ccnl_content_add2cache(ccnl, c);
+          ccnl_content_serve_pending(ccnl, NULL, c);
+          if (!ccnl_content_add2cache(ccnl, c)) {
+              ccnl_content_free(c);
+          }
       }
       Done:
       ccnl_free(out);
@@ -0,0 +1,512 @@
+/*
+ * @f ccnl-cs-policy.c
+ * @b CCN lite (CCNL), core source file (content store replacement policies)
+ *
+ * Copyright (C) 2011-17, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifndef CCNL_LINUXKERNEL
+#include <string.h>
+#include "ccnl-cs-policy.h"
+#include "ccnl-content.h"
+#include "ccnl-relay.h"
+#include "ccnl-malloc.h"
+#include "ccnl-pkt.h"
+#include "ccnl-prefix.h"
+#else
+#include "../include/ccnl-cs-policy.h"
+#include "../include/ccnl-content.h"
+#include "../include/ccnl-relay.h"
+#include "../include/ccnl-malloc.h"
+#include "../include/ccnl-pkt.h"
+#include "../include/ccnl-prefix.h"
+#endif
+
+// S3-FIFO: share of the content store given to the small queue (percent),
+// and the maximum use count remembered per entry
+#define CCNL_CS_S3FIFO_SMALL    10
+#define CCNL_CS_S3FIFO_MAXFREQ  3
+
+// admission filter: the counters are halved after this many Interests
+// per counter, about ten times the number of cached entries
+#define CCNL_CS_SKETCH_PERIOD   5
+
+static const char *ccnl_cs_policy_names[CCNL_CS_POLICY_MAX] = {
+    "lru", "lfu", "s3fifo", "arc"
+};
+
+// ----------------------------------------------------------------------
+// queues
+
+static void
+ccnl_cs_q_push(struct ccnl_cs_policy_s *p, int qi, struct ccnl_content_s *c)
+{
+    struct ccnl_cs_queue_s *q = &p->q[qi];
+
+    c->cs_qprev = NULL;
+    c->cs_qnext = q->head;
+    if (q->head) {
+        q->head->cs_qprev = c;
+    } else {
+        q->tail = c;
+    }
+    q->head = c;
+    q->cnt++;
+    c->cs_queue = qi + 1;
+}
+
+static void
+ccnl_cs_q_unlink(struct ccnl_cs_policy_s *p, struct ccnl_content_s *c)
+{
+    struct ccnl_cs_queue_s *q;
+
+    if (!c->cs_queue) {
+        return;
+    }
+    q = &p->q[c->cs_queue - 1];
+    if (c->cs_qprev) {
+        c->cs_qprev->cs_qnext = c->cs_qnext;
+    } else {
+        q->head = c->cs_qnext;
+    }
+    if (c->cs_qnext) {
+        c->cs_qnext->cs_qprev = c->cs_qprev;
+    } else {
+        q->tail = c->cs_qprev;
+    }
+    q->cnt--;
+    c->cs_qnext = c->cs_qprev = NULL;
+    c->cs_queue = 0;
+}
+
+// returns the oldest entry of a queue, static content found on the way
+// is dropped from the policy for good
+static struct ccnl_content_s*
+ccnl_cs_q_tail(struct ccnl_cs_policy_s *p, int qi)
+{
+    struct ccnl_content_s *c;
+
+    while ((c = p->q[qi].tail) && (c->flags & CCNL_CONTENT_FLAGS_STATIC)) {
+        ccnl_cs_q_unlink(p, c);
+    }
+    return c;
+}
+
+// ----------------------------------------------------------------------
+// ghost queues
+
+static void
+ccnl_cs_ghost_add(struct ccnl_relay_s *relay, struct ccnl_cs_ghost_s *g,
+                  uint32_t hash)
+{
+    struct ccnl_hentry_s *e;
+
+    if (!g->size) {
+        // remember as many names as the content store holds when full
+        g->size = relay->contentcnt > 0 ? (uint32_t) relay->contentcnt : 1;
+        g->ring = (struct ccnl_hentry_s *) ccnl_calloc(g->size, sizeof(*e));
+        if (!g->ring) {
+            g->size = 0;
+            return;
+        }
+    }
+    e = &g->ring[g->pos];
+    ccnl_htable_remove(&g->index, e);
+    ccnl_htable_add(&g->index, e, hash, e);
+    g->pos = (g->pos + 1) % g->size;
+}
+
+// forgets a name, returns 1 if it was remembered
+static int
+ccnl_cs_ghost_take(struct ccnl_cs_ghost_s *g, uint32_t hash)
+{
+    struct ccnl_hentry_s *e = ccnl_htable_lookup(&g->index, hash);
+
+    if (!e) {
+        return 0;
+    }
+    ccnl_htable_remove(&g->index, e);
+    return 1;
+}
+
+static void
+ccnl_cs_ghost_cleanup(struct ccnl_cs_ghost_s *g)
+{
+    ccnl_htable_cleanup(&g->index);
+    ccnl_free(g->ring);
+    memset(g, 0, sizeof(*g));
+}
+
+// ----------------------------------------------------------------------
+// LRU: one queue, entries move to the head when used
+
+static void
+ccnl_cs_lru_hit(struct ccnl_cs_policy_s *p, struct ccnl_content_s *c)
+{
+    ccnl_cs_q_unlink(p, c);
+    ccnl_cs_q_push(p, 0, c);
+}
+
+// ----------------------------------------------------------------------
+// LFU: one queue per use count, LRU order within a queue
+
+static void
+ccnl_cs_lfu_hit(struct ccnl_cs_policy_s *p, struct ccnl_content_s *c)
+{
+    if (c->cs_freq < CCNL_CS_QUEUES - 1) {
+        c->cs_freq++;
+    }
+    ccnl_cs_q_unlink(p, c);
+    ccnl_cs_q_push(p, c->cs_freq, c);
+}
+
+static struct ccnl_content_s*
+ccnl_cs_lfu_victim(struct ccnl_cs_policy_s *p)
+{
+    struct ccnl_content_s *c;
+    int qi;
+
+    for (qi = 0; qi < CCNL_CS_QUEUES; qi++) {
+        if ((c = ccnl_cs_q_tail(p, qi))) {
+            return c;
+        }
+    }
+    return NULL;
+}
+
+// ----------------------------------------------------------------------
+// S3-FIFO: new content enters the small queue q[0]. Content used while
+// in there moves on to the main queue q[1] instead of being evicted, and
+// the names of evicted content are kept in a ghost queue: content coming
+// back while its name is still known goes straight to the main queue.
+// The main queue evicts in FIFO order, giving used entries another round.
+
+static void
+ccnl_cs_s3fifo_insert(struct ccnl_relay_s *relay, struct ccnl_content_s *c)
+{
+    struct ccnl_cs_policy_s *p = &relay->cs_policy;
+
+    c->cs_freq = 0;
+    if (ccnl_cs_ghost_take(&p->ghost[0], c->cs_entry.hash)) {
+        ccnl_cs_q_push(p, 1, c);
+    } else {
+        ccnl_cs_q_push(p, 0, c);
+    }
+}
+
+static struct ccnl_content_s*
+ccnl_cs_s3fifo_victim(struct ccnl_relay_s *relay)
+{
+    struct ccnl_cs_policy_s *p = &relay->cs_policy;
+    struct ccnl_content_s *c;
+    uint32_t small = (uint32_t) relay->contentcnt * CCNL_CS_S3FIFO_SMALL / 100;
+
+    for (;;) {
+        if (ccnl_cs_q_tail(p, 0) && (p->q[0].cnt > small || !ccnl_cs_q_tail(p, 1))) {
+            c = p->q[0].tail;
+            if (c->cs_freq) {
+                c->cs_freq = 0;
+                ccnl_cs_q_unlink(p, c);
+                ccnl_cs_q_push(p, 1, c);
+                continue;
+            }
+            ccnl_cs_ghost_add(relay, &p->ghost[0], c->cs_entry.hash);
+            return c;
+        }
+        if (!(c = ccnl_cs_q_tail(p, 1))) {
+            return NULL;
+        }
+        if (!c->cs_freq) {
+            return c;
+        }
+        c->cs_freq--;
+        ccnl_cs_q_unlink(p, c);
+        ccnl_cs_q_push(p, 1, c);
+    }
+}
+
+// ----------------------------------------------------------------------
+// ARC: q[0] holds content used once, q[1] content used more than once.
+// The names evicted from either queue are kept in a ghost queue each, a
+// miss on a remembered name shifts the target size of q[0] towards the
+// queue which would have kept it.
+
+static void
+ccnl_cs_arc_insert(struct ccnl_relay_s *relay, struct ccnl_content_s *c)
+{
+    struct ccnl_cs_policy_s *p = &relay->cs_policy;
+    uint32_t b1 = p->ghost[0].index.count, b2 = p->ghost[1].index.count;
+    uint32_t delta;
+
+    if (ccnl_cs_ghost_take(&p->ghost[0], c->cs_entry.hash)) {
+        delta = b2 > b1 ? b2 / b1 : 1;
+        p->target += delta;
+        if (p->target > (uint32_t) relay->contentcnt) {
+            p->target = relay->contentcnt;
+        }
+        ccnl_cs_q_push(p, 1, c);
+    } else if (ccnl_cs_ghost_take(&p->ghost[1], c->cs_entry.hash)) {
+        delta = b1 > b2 ? b1 / b2 : 1;
+        p->target = p->target > delta ? p->target - delta : 0;
+        ccnl_cs_q_push(p, 1, c);
+    } else {
+        ccnl_cs_q_push(p, 0, c);
+    }
+}
+
+static struct ccnl_content_s*
+ccnl_cs_arc_victim(struct ccnl_relay_s *relay)
+{
+    struct ccnl_cs_policy_s *p = &relay->cs_policy;
+    struct ccnl_content_s *c;
+
+    c = ccnl_cs_q_tail(p, 0);
+    if (c && (p->q[0].cnt > p->target || !ccnl_cs_q_tail(p, 1))) {
+        ccnl_cs_ghost_add(relay, &p->ghost[0], c->cs_entry.hash);
+        return c;
+    }
+    if ((c = ccnl_cs_q_tail(p, 1))) {
+        ccnl_cs_ghost_add(relay, &p->ghost[1], c->cs_entry.hash);
+    }
+    return c;
+}
+
+// ----------------------------------------------------------------------
+// admission filter
+
+static uint32_t
+ccnl_cs_sketch_index(struct ccnl_cs_sketch_s *s, uint32_t hash, uint32_t i)
+{
+    // double hashing, the odd step reaches all counters
+    uint32_t h = hash * 0x9e3779b1U;
+    uint32_t step = ((h >> 16) | (h << 16)) | 1;
+
+    return (h + i * step) & s->mask;
+}
+
+static uint32_t
+ccnl_cs_sketch_estimate(struct ccnl_cs_sketch_s *s, uint32_t hash)
+{
+    uint32_t i, v, min = CCNL_CS_SKETCH_MAX;
+
+    for (i = 0; i < CCNL_CS_SKETCH_DEPTH; i++) {
+        v = s->counters[ccnl_cs_sketch_index(s, hash, i)];
+        if (v < min) {
+            min = v;
+        }
+    }
+    return min;
+}
+
+int
+ccnl_cs_set_admission(struct ccnl_relay_s *relay, uint32_t size)
+{
+    struct ccnl_cs_sketch_s *s = &relay->cs_sketch;
+    uint32_t n = 64;
+
+    ccnl_free(s->counters);
+    memset(s, 0, sizeof(*s));
+    if (!size) {
+        return 0;
+    }
+    while (n < size && n < (1UL << 30)) {
+        n <<= 1;
+    }
+    s->counters = (uint8_t *) ccnl_calloc(n, 1);
+    if (!s->counters) {
+        return -1;
+    }
+    s->mask = n - 1;
+    s->period = n * CCNL_CS_SKETCH_PERIOD;
+    return 0;
+}
+
+void
+ccnl_cs_admission_record(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx)
+{
+    struct ccnl_cs_sketch_s *s = &relay->cs_sketch;
+    uint32_t hash, i, k, min;
+
+    if (!s->counters) {
+        return;
+    }
+    hash = ccnl_prefix_hash(pfx, pfx->compcnt);
+    // conservative update: only the smallest counters grow
+    min = ccnl_cs_sketch_estimate(s, hash);
+    if (min < CCNL_CS_SKETCH_MAX) {
+        for (i = 0; i < CCNL_CS_SKETCH_DEPTH; i++) {
+            k = ccnl_cs_sketch_index(s, hash, i);
+            if (s->counters[k] == min) {
+                s->counters[k]++;
+            }
+        }
+    }
+    if (++s->samples >= s->period) {
+        for (k = 0; k <= s->mask; k++) {
+            s->counters[k] >>= 1;
+        }
+        s->samples /= 2;
+    }
+}
+
+uint32_t
+ccnl_cs_admission_estimate(struct ccnl_relay_s *relay, struct ccnl_content_s *c)
+{
+    struct ccnl_prefix_s *pfx = c->pkt->pfx;
+
+    if (!relay->cs_sketch.counters) {
+        return CCNL_CS_SKETCH_MAX;
+    }
+    return ccnl_cs_sketch_estimate(&relay->cs_sketch,
+                                   ccnl_prefix_hash(pfx, pfx->compcnt));
+}
+
+int
+ccnl_cs_admit(struct ccnl_relay_s *relay, struct ccnl_content_s *c,
+              struct ccnl_content_s *victim)
+{
+    if (!relay->cs_sketch.counters ||
+        (c->flags & (CCNL_CONTENT_FLAGS_STATIC | CCNL_CONTENT_FLAGS_STORED))) {
+        return 1;
+    }
+    return ccnl_cs_admission_estimate(relay, c) >
+           ccnl_cs_admission_estimate(relay, victim);
+}
+
+// ----------------------------------------------------------------------
+
+int
+ccnl_cs_set_policy(struct ccnl_relay_s *relay, ccnl_cs_policy type)
+{
+    struct ccnl_cs_policy_s *p = &relay->cs_policy;
+    struct ccnl_content_s *c;
+
+    if ((int) type < 0 || type >= CCNL_CS_POLICY_MAX) {
+        return -1;
+    }
+    ccnl_cs_policy_cleanup(relay);
+    memset(p, 0, sizeof(*p));
+    p->type = type;
+
+    // hand over the content, oldest first
+    for (c = relay->contents; c && c->next; c = c->next);
+    for (; c; c = c->prev) {
+        c->cs_queue = 0;
+        ccnl_cs_policy_insert(relay, c);
+    }
+    return 0;
+}
+
+int
+ccnl_cs_policy_from_str(const char *name)
+{
+    int i;
+
+    for (i = 0; i < CCNL_CS_POLICY_MAX; i++) {
+        if (!strcmp(name, ccnl_cs_policy_names[i])) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+const char*
+ccnl_cs_policy_to_str(ccnl_cs_policy type)
+{
+    if ((int) type < 0 || type >= CCNL_CS_POLICY_MAX) {
+        return "?";
+    }
+    return ccnl_cs_policy_names[type];
+}
+
+void
+ccnl_cs_policy_insert(struct ccnl_relay_s *relay, struct ccnl_content_s *c)
+{
+    if (c->flags & CCNL_CONTENT_FLAGS_STATIC) {
+        return;
+    }
+    switch (relay->cs_policy.type) {
+    case CCNL_CS_POLICY_S3FIFO:
+        ccnl_cs_s3fifo_insert(relay, c);
+        break;
+    case CCNL_CS_POLICY_ARC:
+        ccnl_cs_arc_insert(relay, c);
+        break;
+    default:
+        c->cs_freq = 0;
+        ccnl_cs_q_push(&relay->cs_policy, 0, c);
+        break;
+    }
+}
+
+void
+ccnl_cs_policy_hit(struct ccnl_relay_s *relay, struct ccnl_content_s *c)
+{
+    struct ccnl_cs_policy_s *p = &relay->cs_policy;
+
+    if (!c->cs_queue) {
+        return;
+    }
+    switch (p->type) {
+    case CCNL_CS_POLICY_LFU:
+        ccnl_cs_lfu_hit(p, c);
+        break;
+    case CCNL_CS_POLICY_S3FIFO:
+        if (c->cs_freq < CCNL_CS_S3FIFO_MAXFREQ) {
+            c->cs_freq++;
+        }
+        break;
+    case CCNL_CS_POLICY_ARC:
+        ccnl_cs_q_unlink(p, c);
+        ccnl_cs_q_push(p, 1, c);
+        break;
+    default:
+        ccnl_cs_lru_hit(p, c);
+        break;
+    }
+}
+
+void
+ccnl_cs_policy_remove(struct ccnl_relay_s *relay, struct ccnl_content_s *c)
+{
+    ccnl_cs_q_unlink(&relay->cs_policy, c);
+}
+
+struct ccnl_content_s*
+ccnl_cs_policy_victim(struct ccnl_relay_s *relay)
+{
+    switch (relay->cs_policy.type) {
+    case CCNL_CS_POLICY_LFU:
+        return ccnl_cs_lfu_victim(&relay->cs_policy);
+    case CCNL_CS_POLICY_S3FIFO:
+        return ccnl_cs_s3fifo_victim(relay);
+    case CCNL_CS_POLICY_ARC:
+        return ccnl_cs_arc_victim(relay);
+    default:
+        return ccnl_cs_q_tail(&relay->cs_policy, 0);
+    }
+}
+
+void
+ccnl_cs_policy_cleanup(struct ccnl_relay_s *relay)
+{
+    ccnl_cs_ghost_cleanup(&relay->cs_policy.ghost[0]);
+    ccnl_cs_ghost_cleanup(&relay->cs_policy.ghost[1]);
+}
+
+// eof
@@ -123,6 +123,15 @@ ccnl_dump(int lev, int typ, void *p)
                 CONSOLE("pit:\n");
                 ccnl_dump(lev + 1, CCNL_INTEREST, top->pit);
             }
+            INDENT(lev);
+            CONSOLE("cache: %d entries (max=%d), %zu bytes (max=%zu)\n",
+                    top->contentcnt, top->max_cache_entries,
+                    top->cache_bytes, top->max_cache_bytes);
+            INDENT(lev);
+            CONSOLE("cache lookups: %u, %u hits, %u from the store, "
+                    "%u not admitted, %u spilled\n", top->cs_stats.lookups,
+                    top->cs_stats.hits, top->cs_stats.store_hits,
+                    top->cs_stats.rejected, top->cs_stats.spilled);
             if (top->contents) {
                 INDENT(lev);
                 CONSOLE("contents:\n");
@@ -0,0 +1,137 @@
+/*
+ * @f ccnl-htable.c
+ * @b CCN lite (CCNL), core source file (internal data structures)
+ *
+ * Copyright (C) 2011-17, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifndef CCNL_LINUXKERNEL
+#include <stddef.h>
+#include "ccnl-htable.h"
+#include "ccnl-malloc.h"
+#else
+#include "../include/ccnl-htable.h"
+#include "../include/ccnl-malloc.h"
+#endif
+
+// grow the table to newsize buckets; on allocation failure the table
+// keeps its current buckets (and longer chains)
+static void
+ccnl_htable_resize(struct ccnl_htable_s *table, uint32_t newsize)
+{
+    struct ccnl_hentry_s **buckets, *e, *next;
+    uint32_t i;
+
+    buckets = (struct ccnl_hentry_s **) ccnl_calloc(newsize, sizeof(*buckets));
+    if (!buckets) {
+        return;
+    }
+    for (i = 0; i < table->size; i++) {
+        for (e = table->buckets[i]; e; e = next) {
+            next = e->next;
+            e->next = buckets[e->hash & (newsize - 1)];
+            buckets[e->hash & (newsize - 1)] = e;
+        }
+    }
+    ccnl_free(table->buckets);
+    table->buckets = buckets;
+    table->size = newsize;
+}
+
+int
+ccnl_htable_add(struct ccnl_htable_s *table, struct ccnl_hentry_s *entry,
+                uint32_t hash, void *obj)
+{
+    struct ccnl_hentry_s **bucket;
+
+    if (!table->size) {
+        ccnl_htable_resize(table, CCNL_HTABLE_MIN_SIZE);
+        if (!table->size) {
+            return -1;
+        }
+    } else if (table->count >= table->size && table->size < 0x80000000UL) {
+        ccnl_htable_resize(table, table->size << 1);
+    }
+
+    entry->hash = hash;
+    entry->obj = obj;
+    bucket = &table->buckets[hash & (table->size - 1)];
+    entry->next = *bucket;
+    *bucket = entry;
+    table->count++;
+
+    return 0;
+}
+
+void
+ccnl_htable_remove(struct ccnl_htable_s *table, struct ccnl_hentry_s *entry)
+{
+    struct ccnl_hentry_s **pp;
+
+    if (!entry->obj || !table->size) {
+        return;
+    }
+    for (pp = &table->buckets[entry->hash & (table->size - 1)]; *pp;
+                                                      pp = &(*pp)->next) {
+        if (*pp == entry) {
+            *pp = entry->next;
+            table->count--;
+            break;
+        }
+    }
+    entry->next = NULL;
+    entry->obj = NULL;
+}
+
+struct ccnl_hentry_s*
+ccnl_htable_lookup(struct ccnl_htable_s *table, uint32_t hash)
+{
+    struct ccnl_hentry_s *e;
+
+    if (!table->size) {
+        return NULL;
+    }
+    for (e = table->buckets[hash & (table->size - 1)]; e; e = e->next) {
+        if (e->hash == hash) {
+            return e;
+        }
+    }
+    return NULL;
+}
+
+struct ccnl_hentry_s*
+ccnl_htable_next(struct ccnl_hentry_s *entry)
+{
+    uint32_t hash = entry->hash;
+
+    for (entry = entry->next; entry; entry = entry->next) {
+        if (entry->hash == hash) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+void
+ccnl_htable_cleanup(struct ccnl_htable_s *table)
+{
+    ccnl_free(table->buckets);
+    table->buckets = NULL;
+    table->size = 0;
+    table->count = 0;
+}
@@ -106,13 +106,13 @@ ccnl_http_anteselect(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http,
 
 
 int
-ccnl_http_postselect(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http,
-                     fd_set *readfs, fd_set *writefs)
+ccnl_http_io(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http,
+             int server_readable, int client_readable, int client_writable)
 {
     if (!http)
         return -1;
     // accept only one client at the time:
-    if (!http->client && FD_ISSET(http->server, readfs)) {
+    if (!http->client && server_readable) {
         struct sockaddr_in peer;
         socklen_t len = sizeof(peer);
         http->client = accept(http->server, (struct sockaddr*) &peer, &len);
@@ -124,7 +124,7 @@ ccnl_http_postselect(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http,
             http->inlen = http->outlen = http->inoffs = http->outoffs = 0;
         }
     }
-    if (http->client && FD_ISSET(http->client, readfs)) {
+    if (http->client && client_readable) {
         int len = sizeof(http->in) - http->inlen - 1;
         len = recv(http->client, http->in + http->inlen, len, 0);
         if (len == 0) {
@@ -136,7 +136,7 @@ ccnl_http_postselect(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http,
             ccnl_http_status(ccnl, http);
         }
     }
-    if (http->client && FD_ISSET(http->client, writefs) && http->out) {
+    if (http->client && client_writable && http->out) {
         int len = send(http->client, http->out + http->outoffs,
                        http->outlen, 0);
         if (len > 0) {
@@ -151,6 +151,18 @@ ccnl_http_postselect(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http,
     return 0;
 }
 
+
+int
+ccnl_http_postselect(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http,
+                     fd_set *readfs, fd_set *writefs)
+{
+    if (!http)
+        return -1;
+    return ccnl_http_io(ccnl, http, FD_ISSET(http->server, readfs),
+                        http->client && FD_ISSET(http->client, readfs),
+                        http->client && FD_ISSET(http->client, writefs));
+}
+
 int
 ccnl_cmpfaceid(const void *a, const void *b)
 {
@@ -208,6 +220,7 @@ ccnl_http_status(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http)
     struct ccnl_forward_s *fwd;
     struct ccnl_interest_s *ipt;
     struct ccnl_buf_s *bpt;
+    struct ccnl_pool_s **pool;
     char s[CCNL_MAX_PREFIX_SIZE];
 
     strcpy(txt, hdr);
@@ -252,8 +265,12 @@ ccnl_http_status(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http)
             else
                 sprintf(fname, "?");
             len += snprintf(txt+len, sizeof(txt) - len,
-                           "<li>via %4s: <font face=courier>%s</font>\n",
+                           "<li>via %4s: <font face=courier>%s</font>",
                            fname, ccnl_prefix_to_str(fwda[i]->prefix,s,CCNL_MAX_PREFIX_SIZE));
+            if (fwda[i]->strategy)
+                len += snprintf(txt+len, sizeof(txt) - len, " &nbsp;(%s)",
+                                fwda[i]->strategy->name);
+            len += snprintf(txt+len, sizeof(txt) - len, "\n");
         }
         ccnl_free(fwda);
     }
@@ -280,7 +297,16 @@ ccnl_http_status(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http)
                 len += snprintf(txt+len, sizeof(txt) - len, "%.1fsec",
                         fa[i]->last_used + CCNL_FACE_TIMEOUT - CCNL_NOW());
             for (j = 0, bpt = fa[i]->outq; bpt; bpt = bpt->next, j++);
-            len += snprintf(txt+len, sizeof(txt) - len, " &nbsp;qlen=%d\n", j);
+            len += snprintf(txt+len, sizeof(txt) - len, " &nbsp;qlen=%d", j);
+            if (fa[i]->perf.rtt.samples)
+                len += snprintf(txt+len, sizeof(txt) - len,
+                        " &nbsp;srtt=%lums rto=%lums",
+                        (unsigned long) fa[i]->perf.rtt.srtt,
+                        (unsigned long) fa[i]->perf.rtt.rto);
+            len += snprintf(txt+len, sizeof(txt) - len,
+                    " &nbsp;satisfied=%lu/%lu\n",
+                    (unsigned long) fa[i]->perf.satisfied,
+                    (unsigned long) fa[i]->perf.forwarded);
         }
         ccnl_free(fa);
     }
@@ -289,34 +315,69 @@ ccnl_http_status(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http)
     len += snprintf(txt+len, sizeof(txt) - len, "\n<p><table borders=0 width=100%% bgcolor=#e0e0ff>"
                    "<tr><td><em>Interfaces</em></table><ul>\n");
     for (i = 0; i < ccnl->ifcount; i++) {
+        struct ccnl_ring_s *q = ccnl->ifs[i].txq;
 #ifdef USE_STATS
         len += snprintf(txt+len, sizeof(txt) - len, "<li><strong>i%d</strong>&nbsp;&nbsp;"
                        "addr=<font face=courier>%s</font>&nbsp;&nbsp;"
-                       "qlen=%zu/%d"
+                       "qlen=%zu/%u&nbsp;(max=%u&nbsp;drops=%u)"
                        "&nbsp;&nbsp;rx=%u&nbsp;&nbsp;tx=%u"
+                       "&nbsp;&nbsp;rxbatch=%.1f&nbsp;&nbsp;txbatch=%.1f"
                        "\n",
                        i, ccnl_addr2ascii(&ccnl->ifs[i].addr),
-                       ccnl->ifs[i].qlen, CCNL_MAX_IF_QLEN,
-                       ccnl->ifs[i].rx_cnt, ccnl->ifs[i].tx_cnt);
+                       ccnl_interface_qlen(ccnl->ifs + i),
+                       q ? q->depth : 0, q ? (unsigned) q->highwater : 0,
+                       q ? (unsigned) q->drops : 0,
+                       ccnl->ifs[i].rx_cnt, ccnl->ifs[i].tx_cnt,
+                       ccnl->ifs[i].rx_batch_cnt ?
+                       (double) ccnl->ifs[i].rx_batch_pkts / ccnl->ifs[i].rx_batch_cnt : 0.0,
+                       ccnl->ifs[i].tx_batch_cnt ?
+                       (double) ccnl->ifs[i].tx_batch_pkts / ccnl->ifs[i].tx_batch_cnt : 0.0);
 #else
         len += snprintf(txt+len, sizeof(txt) - len, "<li><strong>i%d</strong>&nbsp;&nbsp;"
                        "addr=<font face=courier>%s</font>&nbsp;&nbsp;"
-                       "qlen=%d/%d"
+                       "qlen=%zu/%u&nbsp;(max=%u&nbsp;drops=%u)"
                        "\n",
                        i, ccnl_addr2ascii(&ccnl->ifs[i].addr),
-                       ccnl->ifs[i].qlen, CCNL_MAX_IF_QLEN);
+                       ccnl_interface_qlen(ccnl->ifs + i),
+                       q ? q->depth : 0, q ? (unsigned) q->highwater : 0,
+                       q ? (unsigned) q->drops : 0);
 #endif
     }
     len += snprintf(txt+len, sizeof(txt) - len, "</ul>\n");
 
     len += snprintf(txt+len, sizeof(txt) - len, "\n<p><table borders=0 width=100%% bgcolor=#e0e0ff>"
                    "<tr><td><em>Misc stats</em></table><ul>\n");
-    for (cnt = 0, bpt = ccnl->nonces; bpt; bpt = bpt->next, cnt++);
-    len += snprintf(txt+len, sizeof(txt) - len, "<li>Nonces: %d\n", cnt);
+    len += snprintf(txt+len, sizeof(txt) - len, "<li>Nonces: %u (%u checked, "
+                    "%u loops suppressed)\n",
+                    ccnl_nonce_filter_count(&ccnl->nonce_filter),
+                    ccnl->nonce_filter.checked, ccnl->nonce_filter.dups);
     for (cnt = 0, ipt = ccnl->pit; ipt; ipt = ipt->next, cnt++);
     len += snprintf(txt+len, sizeof(txt) - len, "<li>Pending interests: %d\n", cnt);
     len += snprintf(txt+len, sizeof(txt) - len, "<li>Content chunks: %d (max=%d)\n",
                    ccnl->contentcnt, ccnl->max_cache_entries);
+    len += snprintf(txt+len, sizeof(txt) - len, "<li>Content bytes: %zu (max=%zu)\n",
+                   ccnl->cache_bytes, ccnl->max_cache_bytes);
+    len += snprintf(txt+len, sizeof(txt) - len, "<li>Content lookups: %u "
+                    "(%u hits, %u from the store, %u not admitted, %u spilled)\n",
+                    ccnl->cs_stats.lookups, ccnl->cs_stats.hits,
+                    ccnl->cs_stats.store_hits, ccnl->cs_stats.rejected,
+                    ccnl->cs_stats.spilled);
+    len += snprintf(txt+len, sizeof(txt) - len, "<li>Ageing: %u ticks (%u capped, "
+                    "max %u us), by duration:", ccnl->ageing.ticks,
+                    ccnl->ageing.capped, ccnl->ageing.max_usec);
+    for (cnt = 0; cnt < CCNL_AGEING_HIST; cnt++) {
+        len += snprintf(txt+len, sizeof(txt) - len, " %s%ldus:%u",
+                        cnt < CCNL_AGEING_HIST - 1 ? "&lt;" : "&ge;",
+                        16L << (2 * (cnt < CCNL_AGEING_HIST - 1 ? cnt : cnt - 1)),
+                        ccnl->ageing.hist[cnt]);
+    }
+    len += snprintf(txt+len, sizeof(txt) - len, "\n");
+    for (pool = ccnl_pool_list(); *pool; pool++) {
+        len += snprintf(txt+len, sizeof(txt) - len, "<li>Pool %s: %u in use, "
+                        "%u slabs (%u allocs, %u fallbacks)\n", (*pool)->name,
+                        (*pool)->inuse, (*pool)->nslabs, (*pool)->allocs,
+                        (*pool)->fallbacks);
+    }
     len += snprintf(txt+len, sizeof(txt) - len, "</ul>\n");
 
     len += snprintf(txt+len, sizeof(txt) - len, "\n<p><table borders=0 width=100%% bgcolor=#e0e0ff>"
@@ -329,8 +390,12 @@ ccnl_http_status(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http)
                    "<td align=right> %d<td>\n", CCNL_MAX_INTEREST_RETRANSMIT);
     len += snprintf(txt+len, sizeof(txt) - len, "<tr><td>interest.timeout:"
                    "<td align=right> %d<td>\n", CCNL_INTEREST_TIMEOUT);
-    len += snprintf(txt+len, sizeof(txt) - len, "<tr><td>nonces.max:"
-                   "<td align=right> %d<td>\n", CCNL_MAX_NONCES);
+    len += snprintf(txt+len, sizeof(txt) - len, "<tr><td>nonces.capacity:"
+                   "<td align=right> %u<td>\n", ccnl->nonce_filter.capacity ?
+                   ccnl->nonce_filter.capacity : CCNL_NONCE_CAPACITY);
+    len += snprintf(txt+len, sizeof(txt) - len, "<tr><td>nonces.window:"
+                   "<td align=right> %u<td>\n", ccnl->nonce_filter.window ?
+                   ccnl->nonce_filter.window : CCNL_NONCE_WINDOW);
 
     //len += sprintf(txt+len, "<tr><td>compile.featureset:<td><td> %s\n",
     //               compile_string);
@@ -23,6 +23,7 @@
 
 #ifndef CCNL_LINUXKERNEL
 #include "ccnl-if.h"
+#include "ccnl-buf.h"
 #include "ccnl-os-time.h"
 #include "ccnl-malloc.h"
 #include "ccnl-logging.h"
@@ -33,8 +34,12 @@
 #include "net/packet.h"
 #endif
 #include <unistd.h>
+#ifdef CCNL_IF_RING
+#include <stdlib.h>
+#endif
 #else
 #include "../include/ccnl-if.h"
+#include "../include/ccnl-buf.h"
 #include "../include/ccnl-os-time.h"
 #include "../include/ccnl-malloc.h"
 #include "../include/ccnl-logging.h"
@@ -43,19 +48,132 @@
 void
 ccnl_interface_cleanup(struct ccnl_if_s *i)
 {
-    size_t j;
+    struct ccnl_txrequest_s *r;
     DEBUGMSG_CORE(TRACE, "ccnl_interface_cleanup\n");
 
     ccnl_sched_destroy(i->sched);
-    for (j = 0; j < i->qlen; j++) {
-        struct ccnl_txrequest_s *r = i->queue + (i->qfront+j)%CCNL_MAX_IF_QLEN;
-        ccnl_free(r->buf);
+    while ((r = ccnl_interface_qpeek(i, 0)) != NULL) {
+        ccnl_buf_free(r->buf);
+        ccnl_interface_qrelease(i);
+    }
+#ifdef CCNL_IF_RING
+    if (i->txq) {
+        ccnl_ring_cleanup(i->txq);
+        free(i->txq);
+        i->txq = NULL;
     }
+#endif
 #if !defined(CCNL_RIOT) && !defined(CCNL_ANDROID) && !defined(CCNL_LINUXKERNEL)
     ccnl_close_socket(i->sock);
 #endif
 }
 
+#ifdef CCNL_IF_RING
+
+int
+ccnl_interface_qinit(struct ccnl_if_s *i, uint32_t depth)
+{
+    if (!depth) {
+        depth = CCNL_MAX_IF_QLEN;
+    }
+    i->txq = (struct ccnl_ring_s *) aligned_alloc(CCNL_RING_CACHELINE,
+                                                  sizeof(*i->txq));
+    if (!i->txq || ccnl_ring_init(i->txq, depth,
+                                  sizeof(struct ccnl_txrequest_s))) {
+        DEBUGMSG_CORE(ERROR, "no memory for a transmit queue of %u packets\n",
+                      depth);
+        free(i->txq);
+        i->txq = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+struct ccnl_txrequest_s*
+ccnl_interface_qreserve(struct ccnl_if_s *i)
+{
+    // an interface set up without ccnl_interface_qinit(): default depth
+    if (!i->txq && ccnl_interface_qinit(i, 0)) {
+        return NULL;
+    }
+    return (struct ccnl_txrequest_s *) ccnl_ring_reserve(i->txq);
+}
+
+void
+ccnl_interface_qcommit(struct ccnl_if_s *i, struct ccnl_txrequest_s *r)
+{
+    ccnl_ring_commit(i->txq, r);
+}
+
+struct ccnl_txrequest_s*
+ccnl_interface_qpeek(struct ccnl_if_s *i, uint32_t n)
+{
+    return i->txq ? (struct ccnl_txrequest_s *) ccnl_ring_peek_nth(i->txq, n) : NULL;
+}
+
+void
+ccnl_interface_qrelease(struct ccnl_if_s *i)
+{
+    ccnl_ring_release(i->txq);
+}
+
+size_t
+ccnl_interface_qlen(struct ccnl_if_s *i)
+{
+    return i->txq ? ccnl_ring_count(i->txq) : 0;
+}
+
+#else // !CCNL_IF_RING
+
+int
+ccnl_interface_qinit(struct ccnl_if_s *i, uint32_t depth)
+{
+    (void) depth;
+    i->qlen = 0;
+    i->qfront = 0;
+    return 0;
+}
+
+struct ccnl_txrequest_s*
+ccnl_interface_qreserve(struct ccnl_if_s *i)
+{
+    if (i->qlen >= CCNL_MAX_IF_QLEN) {
+        return NULL;
+    }
+    return i->queue + (i->qfront + i->qlen) % CCNL_MAX_IF_QLEN;
+}
+
+void
+ccnl_interface_qcommit(struct ccnl_if_s *i, struct ccnl_txrequest_s *r)
+{
+    (void) r;
+    i->qlen++;
+}
+
+struct ccnl_txrequest_s*
+ccnl_interface_qpeek(struct ccnl_if_s *i, uint32_t n)
+{
+    if (n >= i->qlen) {
+        return NULL;
+    }
+    return i->queue + (i->qfront + n) % CCNL_MAX_IF_QLEN;
+}
+
+void
+ccnl_interface_qrelease(struct ccnl_if_s *i)
+{
+    i->qfront = (i->qfront + 1) % CCNL_MAX_IF_QLEN;
+    i->qlen--;
+}
+
+size_t
+ccnl_interface_qlen(struct ccnl_if_s *i)
+{
+    return i->qlen;
+}
+
+#endif // CCNL_IF_RING
+
 #if !defined(CCNL_RIOT) && !defined(CCNL_ANDROID) && !defined(CCNL_LINUXKERNEL)
 int
 ccnl_close_socket(int s)
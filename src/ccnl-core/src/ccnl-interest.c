@@ -25,6 +25,7 @@
 #include "ccnl-interest.h"
 #include "ccnl-relay.h"
 #include "ccnl-malloc.h"
+#include "ccnl-pool.h"
 #include "ccnl-os-time.h"
 #include "ccnl-prefix.h"
 #include "ccnl-logging.h"
@@ -33,6 +34,7 @@
 #include "../include/ccnl-relay.h"
 #include "../include/ccnl-interest.h"
 #include "../include/ccnl-malloc.h"
+#include "../include/ccnl-pool.h"
 #include "../include/ccnl-os-time.h"
 #include "../include/ccnl-prefix.h"
 #include "../include/ccnl-logging.h"
@@ -43,6 +45,19 @@
 #include "ccn-lite-riot.h"
 #endif
 
+// an interest can only match content by its implicit digest if the
+// suite supports it and the last name component is a SHA256 digest
+static int
+ccnl_interest_has_digest(struct ccnl_interest_s *i)
+{
+    struct ccnl_prefix_s *pfx = i->pkt->pfx;
+
+    if (pfx->suite != CCNL_SUITE_NDNTLV && pfx->suite != CCNL_SUITE_CCNB) {
+        return 0;
+    }
+    return pfx->compcnt > 0 && pfx->complen[pfx->compcnt - 1] == 32; // SHA256_DIGEST_LEN
+}
+
 struct ccnl_interest_s*
 ccnl_interest_new(struct ccnl_relay_s *ccnl, struct ccnl_face_s *from,
                   struct ccnl_pkt_s **pkt)
@@ -50,8 +65,8 @@ ccnl_interest_new(struct ccnl_relay_s *ccnl, struct ccnl_face_s *from,
     char s[CCNL_MAX_PREFIX_SIZE];
     (void) s;
 
-    struct ccnl_interest_s *i = (struct ccnl_interest_s *) ccnl_calloc(1,
-                                            sizeof(struct ccnl_interest_s));
+    struct ccnl_interest_s *i = (struct ccnl_interest_s *)
+                                        ccnl_pool_alloc(&ccnl_pool_interest);
     DEBUGMSG_CORE(TRACE,
                   "ccnl_new_interest(prefix=%s, suite=%s)\n",
                   ccnl_prefix_to_str((*pkt)->pfx, s, CCNL_MAX_PREFIX_SIZE),
@@ -59,13 +74,18 @@ ccnl_interest_new(struct ccnl_relay_s *ccnl, struct ccnl_face_s *from,
 
     if (!i)
         return NULL;
+    if (ccnl_pkt_own(pkt)) {
+        ccnl_pool_free(i);
+        return NULL;
+    }
     i->pkt = *pkt;
     /* currently, the aging function relies on seconds rather than on milli seconds */
     i->lifetime = ccnl_pkt_interest_lifetime(*pkt);
 
     *pkt = NULL;
-    i->from = from;
     i->last_used = CCNL_NOW();
+    i->sent = ccnl_rtt_now();
+    i->rto = CCNL_RTO_INITIAL;
 
     /** default value for max_pit_entries is defined in ccn-iribu-defs.h as
      * CCNL_DEFAULT_MAX_PIT_ENTRIES
@@ -74,11 +94,28 @@ ccnl_interest_new(struct ccnl_relay_s *ccnl, struct ccnl_face_s *from,
      * value against the pitcnt value */
     if ((ccnl->max_pit_entries != -1) && (ccnl->pitcnt >= ccnl->max_pit_entries)) {
         ccnl_pkt_free(i->pkt);
-        ccnl_free(i);
+        ccnl_pool_free(i);
+        return NULL;
+    }
+
+    if (ccnl_htable_add(&ccnl->pit_index, &i->pit_entry,
+                ccnl_prefix_hash(i->pkt->pfx, i->pkt->pfx->compcnt), i)) {
+        ccnl_pkt_free(i->pkt);
+        ccnl_pool_free(i);
+        return NULL;
+    }
+    if (ccnl_interest_has_digest(i) &&
+        ccnl_htable_add(&ccnl->pit_digest_index, &i->digest_entry,
+                ccnl_prefix_hash(i->pkt->pfx, i->pkt->pfx->compcnt - 1), i)) {
+        ccnl_htable_remove(&ccnl->pit_index, &i->pit_entry);
+        ccnl_pkt_free(i->pkt);
+        ccnl_pool_free(i);
         return NULL;
     }
 
     DBL_LINKED_LIST_ADD(ccnl->pit, i);
+    ccnl_interest_set_from(i, from);
+    ccnl_ageq_insert(&ccnl->pit_ageq, &i->age_entry, i->sent + i->rto, i);
 
     ccnl->pitcnt++;
 
@@ -90,6 +127,22 @@ ccnl_interest_new(struct ccnl_relay_s *ccnl, struct ccnl_face_s *from,
     return i;
 }
 
+struct ccnl_interest_s*
+ccnl_interest_find(struct ccnl_relay_s *ccnl, struct ccnl_pkt_s *pkt)
+{
+    struct ccnl_hentry_s *e;
+
+    for (e = ccnl_htable_lookup(&ccnl->pit_index,
+                                ccnl_prefix_hash(pkt->pfx, pkt->pfx->compcnt));
+         e; e = ccnl_htable_next(e)) {
+        if (ccnl_interest_isSame((struct ccnl_interest_s *) e->obj, pkt) == 1) {
+            return (struct ccnl_interest_s *) e->obj;
+        }
+    }
+
+    return NULL;
+}
+
 int
 ccnl_interest_isSame(struct ccnl_interest_s *i, struct ccnl_pkt_s *pkt)
 {
@@ -146,7 +199,7 @@ ccnl_interest_append_pending(struct ccnl_interest_s *i,  struct ccnl_face_s *fro
                     }
                     last = pi;
             }
-            pi = (struct ccnl_pendint_s *) ccnl_calloc(1,sizeof(struct ccnl_pendint_s));
+            pi = (struct ccnl_pendint_s *) ccnl_pool_alloc(&ccnl_pool_pendint);
             if (!pi) {
                     DEBUGMSG_CORE(DEBUG, "  no mem\n");
                     return -1;
@@ -157,6 +210,11 @@ ccnl_interest_append_pending(struct ccnl_interest_s *i,  struct ccnl_face_s *fro
                             (void *) i->pkt->pfx);
             pi->face = from;
             pi->last_used = CCNL_NOW();
+            pi->interest = i;
+            pi->face_next = from->pendints;
+            if (from->pendints)
+                    from->pendints->face_prev = pi;
+            from->pendints = pi;
             if (last)
                     last->next = pi;
             else
@@ -197,11 +255,11 @@ ccnl_interest_remove_pending(struct ccnl_interest_s *interest, struct ccnl_face_
                     result++; 
                     if (prev) { 
                         prev->next = pend->next;
-                        ccnl_free(pend);
+                        ccnl_pendint_free(pend);
                         pend = prev->next;
                     } else {
                         interest->pending = pend->next;
-                        ccnl_free(pend);
+                        ccnl_pendint_free(pend);
                         pend = interest->pending;
                     }
                 } else {
@@ -219,3 +277,41 @@ ccnl_interest_remove_pending(struct ccnl_interest_s *interest, struct ccnl_face_
     /** interest was NULL */
     return result;
 }
+
+void
+ccnl_interest_set_from(struct ccnl_interest_s *i, struct ccnl_face_s *from)
+{
+    if (i->from) {
+        if (i->from_prev) {
+            i->from_prev->from_next = i->from_next;
+        } else {
+            i->from->interests = i->from_next;
+        }
+        if (i->from_next) {
+            i->from_next->from_prev = i->from_prev;
+        }
+        i->from_next = i->from_prev = NULL;
+    }
+    i->from = from;
+    if (from) {
+        i->from_next = from->interests;
+        if (from->interests) {
+            from->interests->from_prev = i;
+        }
+        from->interests = i;
+    }
+}
+
+void
+ccnl_pendint_free(struct ccnl_pendint_s *pi)
+{
+    if (pi->face_prev) {
+        pi->face_prev->face_next = pi->face_next;
+    } else if (pi->face && pi->face->pendints == pi) {
+        pi->face->pendints = pi->face_next;
+    }
+    if (pi->face_next) {
+        pi->face_next->face_prev = pi->face_prev;
+    }
+    ccnl_pool_free(pi);
+}
@@ -26,6 +26,8 @@
 
 #ifdef USE_DEBUG_MALLOC
 
+CCNL_THREAD_LOCAL struct mhdr *mem;
+
 #ifdef CCNL_ARDUINO
 void* debug_malloc(size_t s, const char *fn, int lno, double tstamp)
 #else
@@ -259,8 +259,10 @@ ccnl_mgmt_send_return_split(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
                 if (!c) {
                     goto Bail;
                 }
-                ccnl_content_serve_pending(ccnl, c);
-                ccnl_content_add2cache(ccnl, c);
+                ccnl_content_serve_pending(ccnl, NULL, c);
+                if (!ccnl_content_add2cache(ccnl, c)) {
+                    ccnl_content_free(c);
+                }
 /*
                 //put to cache
                 struct ccnl_prefix_s *prefix_a = 0;
@@ -288,8 +290,10 @@ ccnl_mgmt_send_return_split(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
                                      NULL, content, contlen);
                 //if (!c) goto Done;
 
-                ccnl_content_serve_pending(ccnl, c);
-                ccnl_content_add2cache(ccnl, c);
+                ccnl_content_serve_pending(ccnl, NULL, c);
+                if (!ccnl_content_add2cache(ccnl, c)) {
+                    ccnl_content_free(c);
+                }
                 //Done:
                 //continue;
 */
@@ -1650,7 +1654,7 @@ ccnl_mgmt_setfrag(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
         long lmtu = 0;
         (void) lmtu;
 
-        for (f = ccnl->faces; f && f->faceid != fi; f = f->next);
+        f = ccnl_face_find(ccnl, fi);
         if (!f) {
             goto Error;
         }
@@ -1822,7 +1826,7 @@ ccnl_mgmt_destroyface(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
             goto SoftBail;
         }
         fi = (int) lfi;
-        for (f = ccnl->faces; f && f->faceid != fi; f = f->next);
+        f = ccnl_face_find(ccnl, fi);
         if (!f) {
             DEBUGMSG(TRACE, "  could not find face=%s\n", faceid);
             goto SoftBail;
@@ -2030,6 +2034,7 @@ ccnl_mgmt_newdev(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
         if (ccnl->defaultInterfaceScheduler) {
             i->sched = ccnl->defaultInterfaceScheduler(ccnl, ccnl_interface_CTS);
         }
+        ccnl_interface_qinit(i, ccnl->if_qlen);
         ccnl->ifcount++;
 
         goto SoftBail;
@@ -2134,6 +2139,7 @@ ccnl_mgmt_newdev(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
         if (ccnl->defaultInterfaceScheduler) {
             i->sched = ccnl->defaultInterfaceScheduler(ccnl, ccnl_interface_CTS);
         }
+        ccnl_interface_qinit(i, ccnl->if_qlen);
         ccnl->ifcount++;
 
         //cp = "newdevice cmd worked";
@@ -2560,7 +2566,6 @@ ccnl_mgmt_prefixreg(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
     // should (re)verify that action=="prefixreg"
     if (faceid && p->compcnt > 0) {
         struct ccnl_face_s *f = NULL;
-        struct ccnl_forward_s **fwd2 = NULL;
         long faceid_l;
 
         errno = 0;
@@ -2576,7 +2581,7 @@ ccnl_mgmt_prefixreg(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
         DEBUGMSG(TRACE, "mgmt: adding prefix %s to faceid=%s, suite=%s\n",
                  ccnl_prefix_to_str(p,s,CCNL_MAX_PREFIX_SIZE), faceid, ccnl_suite2str(suite[0]));
 
-        for (f = ccnl->faces; f && f->faceid != fi; f = f->next);
+        f = ccnl_face_find(ccnl, fi);
         if (!f) {
             goto SoftBail;
         }
@@ -2592,11 +2597,11 @@ ccnl_mgmt_prefixreg(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
             fwd->suite = suite[0];
         }
 
-        fwd2 = &ccnl->fib;
-        while (*fwd2) {
-            fwd2 = &((*fwd2)->next);
+        if (ccnl_fib_link(ccnl, fwd)) {
+            ccnl_prefix_free(fwd->prefix);
+            ccnl_free(fwd);
+            goto SoftBail;
         }
-        *fwd2 = fwd;
         cp = "prefixreg cmd worked";
     } else {
         DEBUGMSG(TRACE, "mgmt: ignored prefixreg faceid=%s\n", faceid);
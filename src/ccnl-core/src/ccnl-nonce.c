@@ -0,0 +1,178 @@
+/*
+ * @f ccnl-nonce.c
+ * @b CCN lite (CCNL), duplicate nonce detection
+ *
+ * Copyright (C) 2011-17, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifndef CCNL_LINUXKERNEL
+#include <string.h>
+#include "ccnl-nonce.h"
+#include "ccnl-buf.h"
+#include "ccnl-prefix.h"
+#include "ccnl-malloc.h"
+#else
+#include "../include/ccnl-nonce.h"
+#include "../include/ccnl-buf.h"
+#include "../include/ccnl-prefix.h"
+#include "../include/ccnl-malloc.h"
+#endif
+
+// keeps the sets at most half full
+#define CCNL_NONCE_MAX_CAPACITY (1UL << 24)
+
+int
+ccnl_nonce_filter_config(struct ccnl_nonce_filter_s *f, uint32_t capacity,
+                         uint32_t window)
+{
+    if (capacity < 1 || capacity > CCNL_NONCE_MAX_CAPACITY || window < 1) {
+        return -1;
+    }
+    ccnl_nonce_filter_cleanup(f);
+    f->capacity = capacity;
+    f->window = window;
+    return 0;
+}
+
+uint32_t
+ccnl_nonce_hash(struct ccnl_prefix_s *pfx, struct ccnl_buf_s *nonce)
+{
+    uint32_t h = pfx ? ccnl_prefix_hash(pfx, pfx->compcnt) : 0;
+    size_t i;
+
+    // continue the FNV-1a hash of the name with the nonce
+    for (i = 0; i < nonce->datalen; i++) {
+        h = (h ^ nonce->data[i]) * 16777619UL;
+    }
+    // the low bits select the slot: mix in the high ones (murmur3 finalizer)
+    h ^= h >> 16;
+    h *= 0x85ebca6bUL;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35UL;
+    h ^= h >> 16;
+
+    return h ? h : 1;
+}
+
+static int
+ccnl_nonce_filter_alloc(struct ccnl_nonce_filter_s *f, uint32_t now)
+{
+    uint32_t size = 2;
+
+    if (!f->capacity) {
+        f->capacity = CCNL_NONCE_CAPACITY;
+    }
+    if (!f->window) {
+        f->window = CCNL_NONCE_WINDOW;
+    }
+    while (size < 2 * f->capacity) {
+        size <<= 1;
+    }
+    f->set[0] = (uint32_t *) ccnl_calloc(size, sizeof(uint32_t));
+    f->set[1] = (uint32_t *) ccnl_calloc(size, sizeof(uint32_t));
+    if (!f->set[0] || !f->set[1]) {
+        ccnl_nonce_filter_cleanup(f);
+        return -1;
+    }
+    f->size = size;
+    f->rotated = now;
+    return 0;
+}
+
+static void
+ccnl_nonce_filter_clear(struct ccnl_nonce_filter_s *f, uint32_t k)
+{
+    memset(f->set[k], 0, f->size * sizeof(uint32_t));
+    f->count[k] = 0;
+}
+
+// the previous set is forgotten, the current one becomes the previous
+static void
+ccnl_nonce_filter_rotate(struct ccnl_nonce_filter_s *f, uint32_t now)
+{
+    f->cur ^= 1;
+    ccnl_nonce_filter_clear(f, f->cur);
+    f->rotated = now;
+    f->rotations++;
+}
+
+// returns the slot of hash in set k, or the empty slot where it belongs
+static uint32_t*
+ccnl_nonce_filter_slot(struct ccnl_nonce_filter_s *f, uint32_t k,
+                       uint32_t hash)
+{
+    uint32_t mask = f->size - 1, i = hash & mask;
+
+    while (f->set[k][i] && f->set[k][i] != hash) {
+        i = (i + 1) & mask;
+    }
+    return f->set[k] + i;
+}
+
+int
+ccnl_nonce_filter_check(struct ccnl_nonce_filter_s *f, uint32_t hash,
+                        uint32_t now)
+{
+    uint32_t *slot;
+
+    if (!f->size && ccnl_nonce_filter_alloc(f, now)) {
+        return 0;
+    }
+    f->checked++;
+
+    if (now - f->rotated >= f->window) {
+        if (now - f->rotated >= 2 * f->window) { // both sets are stale
+            ccnl_nonce_filter_clear(f, f->cur);
+        }
+        ccnl_nonce_filter_rotate(f, now);
+    }
+
+    if (*ccnl_nonce_filter_slot(f, f->cur ^ 1, hash)) {
+        f->dups++;
+        return 1;
+    }
+    slot = ccnl_nonce_filter_slot(f, f->cur, hash);
+    if (*slot) {
+        f->dups++;
+        return 1;
+    }
+    if (f->count[f->cur] >= f->capacity) {
+        ccnl_nonce_filter_rotate(f, now);
+        slot = ccnl_nonce_filter_slot(f, f->cur, hash);
+    }
+    *slot = hash;
+    f->count[f->cur]++;
+    return 0;
+}
+
+uint32_t
+ccnl_nonce_filter_count(struct ccnl_nonce_filter_s *f)
+{
+    return f->count[0] + f->count[1];
+}
+
+void
+ccnl_nonce_filter_cleanup(struct ccnl_nonce_filter_s *f)
+{
+    ccnl_free(f->set[0]);
+    ccnl_free(f->set[1]);
+    f->set[0] = f->set[1] = NULL;
+    f->size = 0;
+    f->count[0] = f->count[1] = 0;
+    f->cur = 0;
+}
@@ -23,6 +23,7 @@
 #ifndef CCNL_LINUXKERNEL
 #include "ccnl-os-time.h"
 #include "ccnl-malloc.h"
+#include <limits.h>
 #include <stdio.h>
 #include <string.h>
 #include <time.h>
@@ -32,11 +33,6 @@
 #endif
 
 
-
-
-struct ccnl_timer_s *eventqueue;
-
-
 #if defined(CCNL_RIOT) && !(defined(__FreeBSD__) || defined(__APPLE__) || defined(__linux__))
 #include <ztimer64.h>
 #include <timex.h>
@@ -101,7 +97,8 @@ current_time(void)
 char*
 timestamp(void)
 {
-    static char ts[16], *cp;
+    static CCNL_THREAD_LOCAL char ts[16];
+    char *cp;
 
     snprintf(ts, sizeof(ts), "%.4g", CCNL_NOW());
     cp = strchr(ts, '.');
@@ -132,50 +129,214 @@ ccnl_get_timeval(struct timeval *tv)
     gettimeofday(tv, NULL);
 }
 
-void*
-ccnl_set_timer(uint64_t usec, void (*fct)(void *aux1, void *aux2),
-                 void *aux1, void *aux2)
+// The pending timers are kept in a hierarchical timing wheel: level L has
+// CCNL_TIMER_SLOTS slots of CCNL_TIMER_SLOTS^L ticks each. A timer sits in
+// the lowest level whose range covers its expiry and moves down a level
+// ("cascades") when the wheel reaches its slot, so setting and removing a
+// timer take constant time. Timers fire at the first tick boundary after
+// their timeout, i.e. never early but up to one tick late.
+
+#define CCNL_TIMER_BITS         6
+#define CCNL_TIMER_SLOTS        (1 << CCNL_TIMER_BITS)
+#define CCNL_TIMER_MASK         (CCNL_TIMER_SLOTS - 1)
+#define CCNL_TIMER_DUE          (CCNL_TIMER_LEVELS * CCNL_TIMER_SLOTS)
+
+static CCNL_THREAD_LOCAL struct ccnl_timer_s *timer_slots[CCNL_TIMER_DUE + 1]; // + list of due timers
+static CCNL_THREAD_LOCAL struct ccnl_timer_s **timer_tails[CCNL_TIMER_DUE + 1]; // last next link, NULL if empty
+static CCNL_THREAD_LOCAL uint64_t timer_bitmap[CCNL_TIMER_LEVELS];           // non-empty slots
+static CCNL_THREAD_LOCAL uint64_t timer_tick;     // the wheel has processed all ticks up to here
+static CCNL_THREAD_LOCAL int timer_started;
+static CCNL_THREAD_LOCAL unsigned int timer_count;
+static CCNL_THREAD_LOCAL struct ccnl_timer_s *timer_pool; // released timers, linked by next
+
+static uint64_t
+ccnl_timer_now(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    if (!timer_started) {
+        timer_tick = ((uint64_t) tv.tv_sec * 1000000 + tv.tv_usec) / CCNL_TIMER_TICK;
+        timer_started = 1;
+    }
+    return (uint64_t) tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+static void
+ccnl_timer_link(struct ccnl_timer_s *t)
 {
-    struct ccnl_timer_s *t, **pp;
-    //    static int handlercnt;
+    uint64_t delta, e = t->expires;
+    int level = 0, slot;
+
+    if (e <= timer_tick) {
+        slot = CCNL_TIMER_DUE;
+    } else {
+        delta = e - timer_tick;
+        while (level < CCNL_TIMER_LEVELS - 1 &&
+               delta >> (CCNL_TIMER_BITS * (level + 1))) {
+            level++;
+        }
+        if (delta >> (CCNL_TIMER_BITS * (level + 1))) {
+            // beyond the wheel: park in the last slot, it cascades again
+            e = timer_tick + ((uint64_t) 1 << (CCNL_TIMER_BITS * CCNL_TIMER_LEVELS)) - 1;
+        }
+        slot = (e >> (CCNL_TIMER_BITS * level)) & CCNL_TIMER_MASK;
+        timer_bitmap[level] |= (uint64_t) 1 << slot;
+        slot += level * CCNL_TIMER_SLOTS;
+    }
+
+    // appended, so that timers of the same tick fire in the order they were set
+    t->slot = slot;
+    t->next = NULL;
+    t->pprev = timer_tails[slot] ? timer_tails[slot] : &timer_slots[slot];
+    *t->pprev = t;
+    timer_tails[slot] = &t->next;
+}
 
-    t = (struct ccnl_timer_s *) ccnl_calloc(1, sizeof(*t));
-    if (!t)
-        return 0;
+static void
+ccnl_timer_unlink(struct ccnl_timer_s *t)
+{
+    *t->pprev = t->next;
+    if (t->next) {
+        t->next->pprev = t->pprev;
+    } else {
+        timer_tails[t->slot] = t->pprev;
+    }
+    if (t->slot < CCNL_TIMER_DUE && !timer_slots[t->slot]) {
+        timer_bitmap[t->slot / CCNL_TIMER_SLOTS] &=
+            ~((uint64_t) 1 << (t->slot & CCNL_TIMER_MASK));
+    }
+    t->next = NULL;
+    t->pprev = NULL;
+}
+
+static void
+ccnl_timer_release(struct ccnl_timer_s *t)
+{
+    t->next = timer_pool;
+    timer_pool = t;
+    timer_count--;
+}
+
+// returns the tick at which the wheel has to do something next
+static uint64_t
+ccnl_timer_next_tick(void)
+{
+    uint64_t next = UINT64_MAX, base, bits, t;
+    int level, rot;
+
+    if (timer_slots[CCNL_TIMER_DUE]) {
+        return timer_tick;
+    }
+    for (level = 0; level < CCNL_TIMER_LEVELS; level++) {
+        if (!timer_bitmap[level]) {
+            continue;
+        }
+        // first non-empty slot after the current one, wrapping around
+        base = timer_tick >> (CCNL_TIMER_BITS * level);
+        rot = (int) ((base + 1) & CCNL_TIMER_MASK);
+        bits = rot ? (timer_bitmap[level] >> rot) | (timer_bitmap[level] << (64 - rot))
+                   : timer_bitmap[level];
+        t = (base + 1 + __builtin_ctzll(bits)) << (CCNL_TIMER_BITS * level);
+        if (t < next) {
+            next = t;
+        }
+    }
+    return next;
+}
+
+// moves the timers of a slot down the wheel
+static void
+ccnl_timer_cascade(int level, int slot)
+{
+    struct ccnl_timer_s *t = timer_slots[level * CCNL_TIMER_SLOTS + slot], *next;
+
+    timer_slots[level * CCNL_TIMER_SLOTS + slot] = NULL;
+    timer_tails[level * CCNL_TIMER_SLOTS + slot] = NULL;
+    timer_bitmap[level] &= ~((uint64_t) 1 << slot);
+    for (; t; t = next) {
+        next = t->next;
+        ccnl_timer_link(t);
+    }
+}
+
+static void
+ccnl_timer_fire(struct ccnl_timer_s *t)
+{
+    void (*fct)(char,int) = t->fct;
+    void (*fct2)(void*,void*) = t->fct2;
+    char node = t->node;
+    int intarg = t->intarg;
+    void *aux1 = t->aux1, *aux2 = t->aux2;
+
+    ccnl_timer_unlink(t);
+    ccnl_timer_release(t);
+    if (fct) {
+        (fct)(node, intarg);
+    } else if (fct2) {
+        (fct2)(aux1, aux2);
+    }
+}
+
+static void*
+ccnl_timer_add(uint64_t usec, void (*fct)(void *aux1, void *aux2),
+               void *aux1, void *aux2)
+{
+    struct ccnl_timer_s *t = timer_pool;
+
+    if (t) {
+        timer_pool = t->next;
+        memset(t, 0, sizeof(*t));
+    } else {
+        t = (struct ccnl_timer_s *) ccnl_calloc(1, sizeof(*t));
+        if (!t)
+            return NULL;
+    }
     t->fct2 = fct;
-    gettimeofday(&t->timeout, NULL);
-    usec += t->timeout.tv_usec;
-    t->timeout.tv_sec += usec / 1000000;
-    t->timeout.tv_usec = usec % 1000000;
     t->aux1 = aux1;
     t->aux2 = aux2;
+    t->expires = (usec + CCNL_TIMER_TICK - 1) / CCNL_TIMER_TICK;
+    timer_count++;
+    ccnl_timer_link(t);
 
-    for (pp = &eventqueue; ; pp = &((*pp)->next)) {
-    if (!*pp || (*pp)->timeout.tv_sec > t->timeout.tv_sec ||
-        ((*pp)->timeout.tv_sec == t->timeout.tv_sec &&
-         (*pp)->timeout.tv_usec > t->timeout.tv_usec)) {
-        t->next = *pp;
-        //        t->handler = handlercnt++;
-        *pp = t;
-        return t;
-    }
-    }
-    return NULL; // ?
+    return t;
+}
+
+void*
+ccnl_set_timer(uint64_t usec, void (*fct)(void *aux1, void *aux2),
+                 void *aux1, void *aux2)
+{
+    return ccnl_timer_add(ccnl_timer_now() + usec, fct, aux1, aux2);
 }
 
 void
 ccnl_rem_timer(void *h)
 {
-    struct ccnl_timer_s **pp;
+    struct ccnl_timer_s *t = (struct ccnl_timer_s *) h;
 
-    for (pp = &eventqueue; *pp; pp = &((*pp)->next)) {
-        if ((void*)*pp == h) {
-            struct ccnl_timer_s *e = *pp;
-            *pp = e->next;
-            ccnl_free(e);
-            break;
+    if (!t || !t->pprev) {
+        return;
+    }
+    ccnl_timer_unlink(t);
+    ccnl_timer_release(t);
+}
+
+void
+ccnl_timer_cleanup(void)
+{
+    struct ccnl_timer_s *t;
+    int i;
+
+    for (i = 0; i <= CCNL_TIMER_DUE; i++) {
+        while ((t = timer_slots[i])) {
+            ccnl_timer_unlink(t);
+            ccnl_timer_release(t);
         }
     }
+    while ((t = timer_pool)) {
+        timer_pool = t->next;
+        ccnl_free(t);
+    }
 }
 
 #endif
@@ -272,26 +433,34 @@ ccnl_rem_timer(void *p)
 int
 ccnl_run_events(void)
 {
-    static struct timeval now;
-    long usec;
-
-    gettimeofday(&now, 0);
-    while (eventqueue) {
-        struct ccnl_timer_s *t = eventqueue;
-
-        usec = timevaldelta(&(t->timeout), &now);
-        if (usec >= 0)
-            return usec;
-
-        if (t->fct)
-            (t->fct)(t->node, t->intarg);
-        else if (t->fct2)
-            (t->fct2)(t->aux1, t->aux2);
-        eventqueue = t->next;
-        ccnl_free(t);
+    uint64_t now = ccnl_timer_now(), next;
+    int level;
+
+    for (;;) {
+        while (timer_slots[CCNL_TIMER_DUE]) {
+            ccnl_timer_fire(timer_slots[CCNL_TIMER_DUE]);
+        }
+        if (!timer_count) {
+            return -1;
+        }
+        next = ccnl_timer_next_tick();
+        if (next > now / CCNL_TIMER_TICK) {
+            break;
+        }
+        // advance to the next tick with work, skipping the idle ones
+        timer_tick = next;
+        for (level = CCNL_TIMER_LEVELS - 1; level > 0; level--) {
+            if (!(next & (((uint64_t) 1 << (CCNL_TIMER_BITS * level)) - 1))) {
+                ccnl_timer_cascade(level, (next >> (CCNL_TIMER_BITS * level)) & CCNL_TIMER_MASK);
+            }
+        }
+        while (timer_slots[next & CCNL_TIMER_MASK]) {
+            ccnl_timer_fire(timer_slots[next & CCNL_TIMER_MASK]);
+        }
     }
 
-    return -1;
+    next = next * CCNL_TIMER_TICK - now;
+    return next > INT_MAX ? INT_MAX : (int) next;
 }
 
 #endif // CCNL_LINUXKERNEL
@@ -304,28 +473,9 @@ void*
 ccnl_set_absolute_timer(struct timeval abstime, void (*fct)(void *aux1, void *aux2),
          void *aux1, void *aux2)
 {
-    struct ccnl_timer_s *t, **pp;
-    //    static int handlercnt;
-
-    t = (struct ccnl_timer_s *) ccnl_calloc(1, sizeof(*t));
-    if (!t)
-    return 0;
-    t->fct2 = fct;
-    t->timeout = abstime;
-    t->aux1 = aux1;
-    t->aux2 = aux2;
-
-    for (pp = &eventqueue; ; pp = &((*pp)->next)) {
-    if (!*pp || (*pp)->timeout.tv_sec > t->timeout.tv_sec ||
-        ((*pp)->timeout.tv_sec == t->timeout.tv_sec &&
-         (*pp)->timeout.tv_usec > t->timeout.tv_usec)) {
-        t->next = *pp;
-        //        t->handler = handlercnt++;
-        *pp = t;
-        return t;
-    }
-    }
-    return NULL; // ?
+    ccnl_timer_now();
+    return ccnl_timer_add((uint64_t) abstime.tv_sec * 1000000 + abstime.tv_usec,
+                          fct, aux1, aux2);
 }
 
 #endif
@@ -28,6 +28,7 @@
 
 #include "ccnl-prefix.h"
 #include "ccnl-malloc.h"
+#include "ccnl-pool.h"
 
 #include "ccnl-logging.h"
 #else
@@ -39,6 +40,7 @@
 
 #include "../include/ccnl-prefix.h"
 #include "../include/ccnl-malloc.h"
+#include "../include/ccnl-pool.h"
 
 #include "../include/ccnl-logging.h"
 #endif
@@ -46,7 +48,7 @@
 void
 ccnl_pkt_free(struct ccnl_pkt_s *pkt)
 {
-    if (pkt) {
+    if (pkt && !(pkt->flags & CCNL_PKT_VIEW)) { // a view owns no memory
         if (pkt->pfx) {
             switch (pkt->pfx->suite) {
 #ifdef USE_SUITE_CCNB
@@ -74,23 +76,19 @@ ccnl_pkt_free(struct ccnl_pkt_s *pkt)
             }
             ccnl_prefix_free(pkt->pfx);
         }
-        if(pkt->buf){
-            ccnl_free(pkt->buf);
-        }
-        ccnl_free(pkt);
+        ccnl_buf_free(pkt->buf);
+        ccnl_pool_free(pkt);
     }
 }
 
 
 struct ccnl_pkt_s *
 ccnl_pkt_dup(struct ccnl_pkt_s *pkt){
-    struct ccnl_pkt_s * ret = ccnl_malloc(sizeof(struct ccnl_pkt_s));
+    struct ccnl_pkt_s * ret;
     if(!pkt){
-        if (ret) {
-            ccnl_free(ret);
-        }
         return NULL;
     }
+    ret = ccnl_pool_alloc(&ccnl_pool_pkt);
     if(!ret){
         return NULL;
     }
@@ -128,13 +126,103 @@ ccnl_pkt_dup(struct ccnl_pkt_s *pkt){
         }
         ret->pfx->suite = pkt->pfx->suite;
         ret->suite = pkt->suite;
-        ret->buf = buf_dup(pkt->buf);
+        ret->buf = ccnl_buf_ref(pkt->buf);
         ret->content = ret->buf->data + (pkt->content - pkt->buf->data);
         ret->contlen = pkt->contlen;
     }
     return ret;
 }
 
+void
+ccnl_pkt_view_init(struct ccnl_pkt_view_s *view, char suite)
+{
+    // the component arrays are left uninitialized, they are large
+    memset(&view->pkt, 0, sizeof(view->pkt));
+    memset(&view->pfx, 0, sizeof(view->pfx));
+    view->pkt.flags = CCNL_PKT_VIEW;
+    view->pkt.suite = suite;
+    view->pfx.suite = suite;
+    view->pfx.comp = view->comp;
+    view->pfx.complen = view->complen;
+    view->start = NULL;
+    view->len = 0;
+}
+
+// moves a pointer into the received bytes of a view to the copy
+#define CCNL_PKT_REBASE(ptr, view, buf) \
+    ((ptr) ? (buf)->data + ((ptr) - (view)->start) : NULL)
+
+int
+ccnl_pkt_own(struct ccnl_pkt_s **pkt)
+{
+    struct ccnl_pkt_view_s *view = (struct ccnl_pkt_view_s *) *pkt;
+    struct ccnl_pkt_s *p;
+    struct ccnl_prefix_s *pfx = NULL;
+    uint32_t i;
+
+    if (!*pkt || !((*pkt)->flags & CCNL_PKT_VIEW)) {
+        return 0;
+    }
+    p = (struct ccnl_pkt_s *) ccnl_pool_alloc(&ccnl_pool_pkt);
+    if (!p) {
+        return -1;
+    }
+    *p = view->pkt;
+    p->flags &= ~CCNL_PKT_VIEW;
+    p->pfx = NULL;
+    p->buf = ccnl_buf_new(view->start, view->len);
+    if (!p->buf) {
+        goto Bail;
+    }
+    p->content = CCNL_PKT_REBASE(view->pkt.content, view, p->buf);
+#ifdef USE_HMAC256
+    p->hmacStart = CCNL_PKT_REBASE(view->pkt.hmacStart, view, p->buf);
+    p->hmacSignature = CCNL_PKT_REBASE(view->pkt.hmacSignature, view, p->buf);
+#endif
+#ifdef USE_SUITE_NDNTLV
+    if (p->suite == CCNL_SUITE_NDNTLV) {
+        // copied below, ccnl_pkt_free() releases it only with a prefix
+        p->s.ndntlv.nonce = NULL;
+    }
+#endif
+
+    if (view->pkt.pfx) {
+        pfx = ccnl_prefix_new(view->pfx.suite, view->pfx.compcnt);
+        if (!pfx) {
+            goto Bail;
+        }
+        p->pfx = pfx;
+        for (i = 0; i < pfx->compcnt; i++) {
+            pfx->comp[i] = CCNL_PKT_REBASE(view->comp[i], view, p->buf);
+            pfx->complen[i] = view->complen[i];
+        }
+        pfx->nameptr = CCNL_PKT_REBASE(view->pfx.nameptr, view, p->buf);
+        pfx->namelen = view->pfx.namelen;
+        if (view->pfx.chunknum) {
+            pfx->chunknum = (uint32_t *) ccnl_malloc(sizeof(uint32_t));
+            if (!pfx->chunknum) {
+                goto Bail;
+            }
+            *pfx->chunknum = view->chunknum;
+        }
+    }
+#ifdef USE_SUITE_NDNTLV
+    if (pfx && p->suite == CCNL_SUITE_NDNTLV && view->pkt.s.ndntlv.nonce) {
+        p->s.ndntlv.nonce = ccnl_buf_new(view->nonce.buf.data,
+                                         view->nonce.buf.datalen);
+        if (!p->s.ndntlv.nonce) {
+            goto Bail;
+        }
+    }
+#endif
+
+    *pkt = p;
+    return 0;
+Bail:
+    ccnl_pkt_free(p);
+    return -1;
+}
+
 size_t
 ccnl_pkt_mkComponent(int suite, uint8_t *dst, char *src, size_t srclen)
 {
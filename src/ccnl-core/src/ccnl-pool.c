@@ -0,0 +1,218 @@
+/*
+ * @f ccnl-pool.c
+ * @b CCN lite (CCNL), fixed-size object pools for the hot relay objects
+ *
+ * Copyright (C) 2011-17, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifndef CCNL_LINUXKERNEL
+#include <stdlib.h>
+#include <string.h>
+#include "ccnl-pool.h"
+#include "ccnl-htable.h"
+#include "ccnl-content.h"
+#include "ccnl-interest.h"
+#include "ccnl-pkt.h"
+#include "ccnl-prefix.h"
+#include "ccnl-malloc.h"
+#else
+#include "../include/ccnl-pool.h"
+#include "../include/ccnl-htable.h"
+#include "../include/ccnl-content.h"
+#include "../include/ccnl-interest.h"
+#include "../include/ccnl-pkt.h"
+#include "../include/ccnl-prefix.h"
+#include "../include/ccnl-malloc.h"
+#endif
+
+// slabs need an aligned allocator, the embedded platforms use plain
+// ccnl_calloc() objects
+#if !defined(CCNL_LINUXKERNEL) && !defined(CCNL_RIOT) && !defined(CCNL_ARDUINO)
+#define CCNL_POOL_SLABS
+#endif
+
+// each thread of a sharded relay allocates from its own pools
+#define CCNL_POOL_DEFINE(var, nm, sz) \
+    CCNL_THREAD_LOCAL struct ccnl_pool_s var = { nm, sz, NULL, NULL, 0, 0, 0, 0 }
+
+CCNL_POOL_DEFINE(ccnl_pool_pkt, "pkt", sizeof(struct ccnl_pkt_s));
+CCNL_POOL_DEFINE(ccnl_pool_prefix, "prefix", sizeof(struct ccnl_prefix_s) +
+                 CCNL_POOL_PREFIX_COMP * (sizeof(uint8_t*) + sizeof(size_t)));
+CCNL_POOL_DEFINE(ccnl_pool_interest, "interest", sizeof(struct ccnl_interest_s));
+CCNL_POOL_DEFINE(ccnl_pool_pendint, "pendint", sizeof(struct ccnl_pendint_s));
+CCNL_POOL_DEFINE(ccnl_pool_content, "content", sizeof(struct ccnl_content_s));
+
+// the addresses of thread local pools are not constant: filled on first use
+static CCNL_THREAD_LOCAL struct ccnl_pool_s *ccnl_pools[6];
+
+struct ccnl_pool_s**
+ccnl_pool_list(void)
+{
+    if (!ccnl_pools[0]) {
+        ccnl_pools[0] = &ccnl_pool_pkt;
+        ccnl_pools[1] = &ccnl_pool_prefix;
+        ccnl_pools[2] = &ccnl_pool_interest;
+        ccnl_pools[3] = &ccnl_pool_pendint;
+        ccnl_pools[4] = &ccnl_pool_content;
+    }
+    return ccnl_pools;
+}
+
+#ifdef CCNL_POOL_SLABS
+
+#define CCNL_POOL_ALIGN         16
+#define CCNL_POOL_ROUNDUP(n)    (((n) + CCNL_POOL_ALIGN - 1) & \
+                                 ~((size_t) CCNL_POOL_ALIGN - 1))
+
+// header at the start of each slab, the objects follow
+struct ccnl_pool_slab_s {
+    struct ccnl_hentry_s entry;    // in the slab registry
+    struct ccnl_pool_s *pool;
+    struct ccnl_pool_slab_s *next; // next slab of the same pool
+};
+
+// all slabs, by their address: this is how ccnl_pool_free() finds the
+// pool of an object without a per-object header
+static CCNL_THREAD_LOCAL struct ccnl_htable_s ccnl_pool_slabs;
+
+static uint32_t
+ccnl_pool_slab_hash(uintptr_t base)
+{
+    return (uint32_t) (base / CCNL_POOL_SLAB_SIZE);
+}
+
+static struct ccnl_pool_slab_s*
+ccnl_pool_slab_of(void *obj)
+{
+    uintptr_t base = (uintptr_t) obj & ~((uintptr_t) CCNL_POOL_SLAB_SIZE - 1);
+    struct ccnl_hentry_s *e;
+
+    for (e = ccnl_htable_lookup(&ccnl_pool_slabs, ccnl_pool_slab_hash(base));
+                                                e; e = ccnl_htable_next(e)) {
+        if ((uintptr_t) e->obj == base) {
+            return (struct ccnl_pool_slab_s *) e->obj;
+        }
+    }
+    return NULL;
+}
+
+static void
+ccnl_pool_grow(struct ccnl_pool_s *pool)
+{
+    struct ccnl_pool_slab_s *slab;
+    void *mem;
+    uint8_t *obj, *end;
+    size_t size = CCNL_POOL_ROUNDUP(pool->size);
+
+    mem = aligned_alloc(CCNL_POOL_SLAB_SIZE, CCNL_POOL_SLAB_SIZE);
+    if (!mem) {
+        return;
+    }
+    slab = (struct ccnl_pool_slab_s *) mem;
+    memset(slab, 0, sizeof(*slab));
+    if (ccnl_htable_add(&ccnl_pool_slabs, &slab->entry,
+                        ccnl_pool_slab_hash((uintptr_t) slab), slab)) {
+        free(mem);
+        return;
+    }
+    slab->pool = pool;
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+    pool->nslabs++;
+
+    end = (uint8_t *) mem + CCNL_POOL_SLAB_SIZE;
+    for (obj = (uint8_t *) mem + CCNL_POOL_ROUNDUP(sizeof(*slab));
+                                        obj + size <= end; obj += size) {
+        *(void **) obj = pool->freelist;
+        pool->freelist = obj;
+    }
+}
+
+#endif // CCNL_POOL_SLABS
+
+void*
+ccnl_pool_alloc(struct ccnl_pool_s *pool)
+{
+    void *obj;
+
+#ifdef CCNL_POOL_SLABS
+    if (!pool->freelist) {
+        ccnl_pool_grow(pool);
+    }
+    obj = pool->freelist;
+    if (obj) {
+        pool->freelist = *(void **) obj;
+        memset(obj, 0, pool->size);
+        pool->inuse++;
+        pool->allocs++;
+        return obj;
+    }
+#endif
+    obj = ccnl_calloc(1, pool->size);
+    if (obj) {
+        pool->fallbacks++;
+    }
+    return obj;
+}
+
+void
+ccnl_pool_free(void *obj)
+{
+#ifdef CCNL_POOL_SLABS
+    struct ccnl_pool_slab_s *slab;
+
+    if (!obj) {
+        return;
+    }
+    slab = ccnl_pool_slab_of(obj);
+    if (slab) {
+        *(void **) obj = slab->pool->freelist;
+        slab->pool->freelist = obj;
+        slab->pool->inuse--;
+        return;
+    }
+#endif
+    ccnl_free(obj);
+}
+
+void
+ccnl_pool_cleanup(void)
+{
+#ifdef CCNL_POOL_SLABS
+    struct ccnl_pool_s **pp;
+
+    for (pp = ccnl_pool_list(); *pp; pp++) {
+        struct ccnl_pool_s *pool = *pp;
+
+        if (pool->inuse) {
+            continue;
+        }
+        while (pool->slabs) {
+            struct ccnl_pool_slab_s *slab = pool->slabs;
+            pool->slabs = slab->next;
+            ccnl_htable_remove(&ccnl_pool_slabs, &slab->entry);
+            free(slab);
+        }
+        pool->freelist = NULL;
+        pool->nslabs = 0;
+    }
+    if (!ccnl_pool_slabs.count) {
+        ccnl_htable_cleanup(&ccnl_pool_slabs);
+    }
+#endif
+}
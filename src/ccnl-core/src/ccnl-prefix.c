@@ -23,6 +23,7 @@
 
 #ifndef CCNL_LINUXKERNEL
 #include "ccnl-prefix.h"
+#include "ccnl-pool.h"
 #include "ccnl-pkt-ndntlv.h"
 #include "ccnl-pkt-ccntlv.h"
 #include <string.h>
@@ -33,27 +34,33 @@
 #endif // !defined(CCNL_RIOT) && !defined(CCNL_ANDROID)
 #else //CCNL_LINUXKERNEL
 #include "../include/ccnl-prefix.h"
+#include "../include/ccnl-pool.h"
 #include "../../ccnl-pkt/include/ccnl-pkt-ndntlv.h"
 #include "../../ccnl-pkt/include/ccnl-pkt-ccntlv.h"
 
 #endif //CCNL_LINUXKERNEL
 
 
+// the component arrays of a prefix from ccnl_prefix_new() follow the
+// struct in the same block
+#define CCNL_PREFIX_COMPACT(p) ((void *) (p)->comp == (void *) ((p) + 1))
+
 struct ccnl_prefix_s*
 ccnl_prefix_new(char suite, uint32_t cnt)
 {
     struct ccnl_prefix_s *p;
 
-    p = (struct ccnl_prefix_s *) ccnl_calloc(1, sizeof(struct ccnl_prefix_s));
-    if (!p){
-        return NULL;
+    if (cnt <= CCNL_POOL_PREFIX_COMP) {
+        p = (struct ccnl_prefix_s *) ccnl_pool_alloc(&ccnl_pool_prefix);
+    } else {
+        p = (struct ccnl_prefix_s *) ccnl_calloc(1, sizeof(struct ccnl_prefix_s) +
+                                      cnt * (sizeof(uint8_t*) + sizeof(size_t)));
     }
-    p->comp = (uint8_t **) ccnl_malloc(cnt * sizeof(uint8_t*));
-    p->complen = (size_t *) ccnl_malloc(cnt * sizeof(size_t));
-    if (!p->comp || !p->complen) {
-        ccnl_prefix_free(p);
+    if (!p){
         return NULL;
     }
+    p->comp = (uint8_t **) (p + 1);
+    p->complen = (size_t *) (p->comp + cnt);
     p->compcnt = cnt;
     p->suite = suite;
     p->chunknum = NULL;
@@ -65,10 +72,12 @@ void
 ccnl_prefix_free(struct ccnl_prefix_s *p)
 {
     ccnl_free(p->bytes);
-    ccnl_free(p->comp);
-    ccnl_free(p->complen);
+    if (!CCNL_PREFIX_COMPACT(p)) {
+        ccnl_free(p->comp);
+        ccnl_free(p->complen);
+    }
     ccnl_free(p->chunknum);
-    ccnl_free(p);
+    ccnl_pool_free(p);
 }
 
 struct ccnl_prefix_s*
@@ -163,8 +172,10 @@ ccnl_prefix_appendCmp(struct ccnl_prefix_s *prefix, uint8_t *cmp,
     prefix->comp[lastcmp] = &prefix->bytes[prefixlen];
     prefix->complen[lastcmp] = cmplen;
 
-    ccnl_free(oldcomp);
-    ccnl_free(oldcomplen);
+    if ((void *) oldcomp != (void *) (prefix + 1)) {
+        ccnl_free(oldcomp);
+        ccnl_free(oldcomplen);
+    }
     ccnl_free(oldbytes);
 
     return 0;
@@ -365,6 +376,74 @@ ccnl_URItoPrefix(char* uri, int suite, uint32_t *chunknum)
     return p;
 }
 
+// FNV-1a over the suite and all (length, component) pairs
+#define CCNL_PREFIX_HASH_BASIS  2166136261UL
+#define CCNL_PREFIX_HASH_PRIME  16777619UL
+
+static uint32_t
+ccnl_prefix_hash_comp(uint32_t h, uint8_t *comp, size_t len)
+{
+    size_t j;
+
+    h = (h ^ (uint8_t) len) * CCNL_PREFIX_HASH_PRIME;
+    h = (h ^ (uint8_t) (len >> 8)) * CCNL_PREFIX_HASH_PRIME;
+    for (j = 0; j < len; j++) {
+        h = (h ^ comp[j]) * CCNL_PREFIX_HASH_PRIME;
+    }
+    return h;
+}
+
+void
+ccnl_prefix_hashes(struct ccnl_prefix_s *prefix, uint32_t *hashes, uint32_t cnt)
+{
+    uint32_t i;
+
+    if (cnt > prefix->compcnt) {
+        cnt = prefix->compcnt;
+    }
+    hashes[0] = (CCNL_PREFIX_HASH_BASIS ^ (uint8_t) prefix->suite) * CCNL_PREFIX_HASH_PRIME;
+    for (i = 0; i < cnt; i++) {
+        hashes[i + 1] = ccnl_prefix_hash_comp(hashes[i], prefix->comp[i],
+                                              prefix->complen[i]);
+    }
+}
+
+uint32_t
+ccnl_prefix_hash(struct ccnl_prefix_s *prefix, uint32_t compcnt)
+{
+    uint32_t h, i;
+
+    if (compcnt > prefix->compcnt) {
+        compcnt = prefix->compcnt;
+    }
+    h = (CCNL_PREFIX_HASH_BASIS ^ (uint8_t) prefix->suite) * CCNL_PREFIX_HASH_PRIME;
+    for (i = 0; i < compcnt; i++) {
+        h = ccnl_prefix_hash_comp(h, prefix->comp[i], prefix->complen[i]);
+    }
+
+    return h;
+}
+
+int
+ccnl_prefix_is_head(struct ccnl_prefix_s *prefix, struct ccnl_prefix_s *name,
+                    uint32_t compcnt)
+{
+    uint32_t i;
+
+    if (prefix->suite != name->suite || prefix->compcnt != compcnt ||
+        compcnt > name->compcnt) {
+        return 0;
+    }
+    for (i = 0; i < compcnt; i++) {
+        if (prefix->complen[i] != name->complen[i] ||
+            memcmp(prefix->comp[i], name->comp[i], prefix->complen[i])) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
 #ifdef NEEDS_PREFIX_MATCHING
 
 const char*
@@ -420,7 +499,7 @@ ccnl_prefix_cmp(struct ccnl_prefix_s *pfx, unsigned char *md,
 
     for (i = 0; i < plen && i < nam->compcnt; ++i) {
         comp = i < pfx->compcnt ? pfx->comp[i] : md;
-        clen = i < pfx->compcnt ? pfx->complen[i] : 32; // SHA256_DIGEST_LEN
+        clen = i < pfx->compcnt ? pfx->complen[i] : CCNL_CONTENT_DIGEST_LEN;
         if (clen != nam->complen[i] || memcmp(comp, nam->comp[i], nam->complen[i])) {
             rc = mode == CMP_EXACT ? -1 : (int32_t) i;
             DEBUGMSG(VERBOSE, "component mismatch: %lu\n", (long unsigned) i);
@@ -463,7 +542,12 @@ ccnl_i_prefixof_c(struct ccnl_prefix_s *prefix,
     unsigned char *md = NULL;
 
     if ((prefix->compcnt - p->compcnt) == 1) {
-        md = compute_ccnx_digest(c->pkt->buf);
+        // only a last component of the digest's length can match it
+        if (prefix->complen[prefix->compcnt - 1] != CCNL_CONTENT_DIGEST_LEN) {
+            DEBUGMSG(TRACE, "  last component is no digest\n");
+            return -1;
+        }
+        md = ccnl_content_digest(c);
 
         /* computing the ccnx digest failed */
         if (!md) {
@@ -598,7 +682,7 @@ ccnl_prefix_to_str_detailed(struct ccnl_prefix_s *pr, int ccntlv_skip, int escap
 char*
 ccnl_prefix_to_path(struct ccnl_prefix_s *pr)
 {
-    static char prefix_buf[4096];
+    static CCNL_THREAD_LOCAL char prefix_buf[4096];
     int len= 0, i;
     int result;
 
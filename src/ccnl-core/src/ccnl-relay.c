@@ -45,6 +45,16 @@ static ccnl_cache_strategy_func _cs_remove_func = NULL;
  */
 static ccnl_cache_strategy_func _cs_decision_func = NULL;
 
+// key of the face index: the interface and the peer address, a local
+// client (ifndx -1) has none
+static uint32_t
+ccnl_face_hash(int ifndx, sockunion *peer)
+{
+    uint32_t h = peer ? ccnl_addr_hash(peer) : 0;
+
+    return (h ^ (uint32_t) ifndx) * 16777619UL;
+}
+
 struct ccnl_face_s*
 ccnl_get_face_or_create(struct ccnl_relay_s *ccnl, int ifndx,
                         struct sockaddr *sa, size_t addrlen)
@@ -52,26 +62,37 @@ ccnl_get_face_or_create(struct ccnl_relay_s *ccnl, int ifndx,
 // sa!=NULL && ifndx==-1: search suitable interface for given sa_family
 // sa!=NULL && ifndx!=-1: use this (incoming) interface for outgoing
 {
-    static int seqno;
+    static CCNL_THREAD_LOCAL int seqno;
     int i;
+    uint32_t hash;
     struct ccnl_face_s *f;
+    struct ccnl_hentry_s *e;
 
     DEBUGMSG_CORE(TRACE, "ccnl_get_face_or_create src=%s\n",
              ccnl_addr2ascii((sockunion*)sa));
 
-    for (f = ccnl->faces; f; f = f->next) {
-        if (!sa) {
-            if (f->ifndx == -1)
+    if (!sa) {
+        hash = ccnl_face_hash(-1, NULL);
+        for (e = ccnl_htable_lookup(&ccnl->face_index, hash); e;
+                                                e = ccnl_htable_next(e)) {
+            f = (struct ccnl_face_s *) e->obj;
+            if (f->ifndx == -1) {
                 return f;
-            continue;
+            }
         }
-        if (ifndx != -1 && (f->ifndx == ifndx) &&
-            !ccnl_addr_cmp(&f->peer, (sockunion*)sa)) {
-            f->last_used = CCNL_NOW();
+    } else if (ifndx != -1) {
+        hash = ccnl_face_hash(ifndx, (sockunion*)sa);
+        for (e = ccnl_htable_lookup(&ccnl->face_index, hash); e;
+                                                e = ccnl_htable_next(e)) {
+            f = (struct ccnl_face_s *) e->obj;
+            if (f->ifndx == ifndx &&
+                !ccnl_addr_cmp(&f->peer, (sockunion*)sa)) {
+                f->last_used = CCNL_NOW();
 #ifdef CCNL_RIOT
-            ccnl_evtimer_reset_face_timeout(f);
+                ccnl_evtimer_reset_face_timeout(f);
 #endif
-            return f;
+                return f;
+            }
         }
     }
 
@@ -116,8 +137,20 @@ ccnl_get_face_or_create(struct ccnl_relay_s *ccnl, int ifndx,
     } else {  // local client
         f->ifndx = -1;
     }
+    if (ccnl_htable_add(&ccnl->face_index, &f->peer_entry,
+                        ccnl_face_hash(f->ifndx, sa ? &f->peer : NULL), f) ||
+        ccnl_htable_add(&ccnl->faceid_index, &f->id_entry,
+                        (uint32_t) f->faceid, f)) {
+        DEBUGMSG_CORE(VERBOSE, "  could not index face\n");
+        ccnl_htable_remove(&ccnl->face_index, &f->peer_entry);
+        ccnl_sched_destroy(f->sched);
+        ccnl_free(f);
+        return NULL;
+    }
     f->last_used = CCNL_NOW();
     DBL_LINKED_LIST_ADD(ccnl->faces, f);
+    ccnl_ageq_add(&ccnl->face_ageq, &f->age_entry,
+                  f->last_used + CCNL_FACE_TIMEOUT, f);
 
     TRACEOUT();
 
@@ -133,53 +166,51 @@ ccnl_face_remove(struct ccnl_relay_s *ccnl, struct ccnl_face_s *f)
 {
     struct ccnl_face_s *f2;
     struct ccnl_interest_s *pit;
-    struct ccnl_forward_s **ppfwd;
+    struct ccnl_pendint_s *pend;
+    struct ccnl_forward_s *fwd;
 
     DEBUGMSG_CORE(DEBUG, "face_remove relay=%p face=%p\n",
              (void*)ccnl, (void*)f);
 
+    ccnl_ageq_remove(&ccnl->face_ageq, &f->age_entry);
+    ccnl_htable_remove(&ccnl->face_index, &f->peer_entry);
+    ccnl_htable_remove(&ccnl->faceid_index, &f->id_entry);
     ccnl_sched_destroy(f->sched);
 #ifdef USE_FRAG
     ccnl_frag_destroy(f->frag);
 #endif
+    // only the PIT and FIB entries which refer to the face are visited
     DEBUGMSG_CORE(TRACE, "face_remove: cleaning PIT\n");
-    for (pit = ccnl->pit; pit; ) {
-        struct ccnl_pendint_s **ppend, *pend;
-        if (pit->from == f) {
-            pit->from = NULL;
-        }
-        for (ppend = &pit->pending; *ppend;) {
-            if ((*ppend)->face == f) {
-                pend = *ppend;
-                *ppend = pend->next;
-                ccnl_free(pend);
-            } else {
-                ppend = &(*ppend)->next;
-            }
-        }
-        if (pit->pending) {
-            pit = pit->next;
-        } else {
+    while ((pend = f->pendints) != NULL) {
+        struct ccnl_pendint_s **ppend;
+
+        pit = pend->interest;
+        for (ppend = &pit->pending; *ppend != pend; ppend = &(*ppend)->next);
+        *ppend = pend->next;
+        ccnl_pendint_free(pend);
+        if (!pit->pending) {
             DEBUGMSG_CORE(TRACE, "before interest_remove 0x%p\n",
                           (void*)pit);
-            pit = ccnl_interest_remove(ccnl, pit);
+            ccnl_interest_remove(ccnl, pit);
         }
     }
-    DEBUGMSG_CORE(TRACE, "face_remove: cleaning fwd table\n");
-    for (ppfwd = &ccnl->fib; *ppfwd;) {
-        if ((*ppfwd)->face == f) {
-            struct ccnl_forward_s *pfwd = *ppfwd;
-            ccnl_prefix_free(pfwd->prefix);
-            *ppfwd = pfwd->next;
-            ccnl_free(pfwd);
+    while ((pit = f->interests) != NULL) {
+        if (pit->pending) {
+            ccnl_interest_set_from(pit, NULL);
         } else {
-            ppfwd = &(*ppfwd)->next;
+            ccnl_interest_remove(ccnl, pit);
         }
     }
+    DEBUGMSG_CORE(TRACE, "face_remove: cleaning fwd table\n");
+    while ((fwd = f->fwds) != NULL) {
+        ccnl_fib_unlink(ccnl, fwd);
+        ccnl_prefix_free(fwd->prefix);
+        ccnl_free(fwd);
+    }
     DEBUGMSG_CORE(TRACE, "face_remove: cleaning pkt queue\n");
     while (f->outq) {
         struct ccnl_buf_s *tmp = f->outq->next;
-        ccnl_free(f->outq);
+        ccnl_buf_free(f->outq);
         f->outq = tmp;
     }
     DEBUGMSG_CORE(TRACE, "face_remove: unlinking1 %p %p\n",
@@ -194,6 +225,21 @@ ccnl_face_remove(struct ccnl_relay_s *ccnl, struct ccnl_face_s *f)
     return f2;
 }
 
+struct ccnl_face_s*
+ccnl_face_find(struct ccnl_relay_s *ccnl, int faceid)
+{
+    struct ccnl_hentry_s *e;
+
+    for (e = ccnl_htable_lookup(&ccnl->faceid_index, (uint32_t) faceid); e;
+                                                    e = ccnl_htable_next(e)) {
+        struct ccnl_face_s *f = (struct ccnl_face_s *) e->obj;
+        if (f->faceid == faceid) {
+            return f;
+        }
+    }
+    return NULL;
+}
+
 void
 ccnl_interface_enqueue(void (tx_done)(void*, int, int), struct ccnl_face_s *f,
                        struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc,
@@ -205,28 +251,32 @@ ccnl_interface_enqueue(void (tx_done)(void*, int, int), struct ccnl_face_s *f,
         if (buf) { 
             DEBUGMSG_CORE(TRACE, "enqueue interface=%p buf=%p len=%zu (qlen=%zu)\n",
                   (void*)ifc, (void*)buf,
-                  buf ? buf->datalen : 0, ifc ? ifc->qlen : 0);
+                  buf ? buf->datalen : 0, ccnl_interface_qlen(ifc));
         }
 
-        if (ifc->qlen >= CCNL_MAX_IF_QLEN) {
+        r = ccnl_interface_qreserve(ifc);
+        if (!r) {
             if (buf) {
                 DEBUGMSG_CORE(WARNING, "  DROPPING buf=%p\n", (void*)buf); 
-                ccnl_free(buf); 
-                return;
+                ccnl_buf_free(buf); 
             }
+            return;
         }
-        
-        r = ifc->queue + ((ifc->qfront + ifc->qlen) % CCNL_MAX_IF_QLEN); 
         r->buf = buf;
         memcpy(&r->dst, dest, sizeof(sockunion));
         r->txdone = tx_done;
         r->txdone_face = f;
-        ifc->qlen++;
+        ccnl_interface_qcommit(ifc, r);
 
 #ifdef USE_SCHEDULER
         ccnl_sched_RTS(ifc->sched, 1, buf->datalen, ccnl, ifc);
 #else 
-        ccnl_interface_CTS(ccnl, ifc);
+        if (!ccnl->ccnl_ll_TXv_ptr) {
+            ccnl_interface_CTS(ccnl, ifc);
+        } else if (ccnl_interface_qlen(ifc) >= CCNL_MAX_IF_QLEN) {
+            // a full batch, otherwise the queue is sent by ccnl_interface_flush()
+            ccnl_interface_flush(ccnl, ifc);
+        }
 #endif
     }
 }
@@ -299,7 +349,7 @@ int
 ccnl_send_pkt(struct ccnl_relay_s *ccnl, struct ccnl_face_s *to,
                 struct ccnl_pkt_s *pkt)
 {
-    return ccnl_face_enqueue(ccnl, to, buf_dup(pkt->buf));
+    return ccnl_face_enqueue(ccnl, to, ccnl_buf_ref(pkt->buf));
 }
 
 int
@@ -317,10 +367,21 @@ ccnl_face_enqueue(struct ccnl_relay_s *ccnl, struct ccnl_face_s *to,
     for (msg = to->outq; msg; msg = msg->next) { // already in the queue?
         if (buf_equal(msg, buf)) {
             DEBUGMSG_CORE(VERBOSE, "    not enqueued because already there\n");
-            ccnl_free(buf);
+            ccnl_buf_free(buf);
             return -1;
         }
     }
+#ifdef USE_SCHEDULER
+    if (buf->refcnt > 1) {
+        // waits in the queue, which is linked through the buffer
+        struct ccnl_buf_s *copy = buf_dup(buf);
+        ccnl_buf_free(buf);
+        if (!copy) {
+            return -1;
+        }
+        buf = copy;
+    }
+#endif
     buf->next = NULL;
     if (to->outqend) {
         to->outqend->next = buf;
@@ -363,36 +424,56 @@ ccnl_interest_remove(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i)
 
     while (i->pending) {
         struct ccnl_pendint_s *tmp = i->pending->next;          \
-        ccnl_free(i->pending);
+        ccnl_pendint_free(i->pending);
         i->pending = tmp;
     }
+    ccnl_interest_set_from(i, NULL);
     i2 = i->next;
 
     ccnl->pitcnt--;
 
     DBL_LINKED_LIST_REMOVE(ccnl->pit, i);
+    ccnl_ageq_remove(&ccnl->pit_ageq, &i->age_entry);
+    ccnl_htable_remove(&ccnl->pit_index, &i->pit_entry);
+    ccnl_htable_remove(&ccnl->pit_digest_index, &i->digest_entry);
 
     if (i->pkt) {
         ccnl_pkt_free(i->pkt);
     }
     if (i) {
-        ccnl_free(i);
+        ccnl_pool_free(i);
     }
     return i2;
 }
 
+// queues a PIT entry for its next retransmission, at the latest when its
+// lifetime ends
+static void
+ccnl_interest_schedule(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i)
+{
+    uint32_t t = (uint32_t) CCNL_NOW();
+    uint32_t delay = ccnl_rtt_backoff(i->rto, i->retries), left = 0;
+
+    if (i->last_used + i->lifetime > t) {
+        left = (i->last_used + i->lifetime - t) * 1000;
+    }
+    if (delay > left) {
+        delay = left;
+    }
+    ccnl_ageq_remove(&ccnl->pit_ageq, &i->age_entry);
+    ccnl_ageq_insert(&ccnl->pit_ageq, &i->age_entry, ccnl_rtt_now() + delay, i);
+}
+
 void
 ccnl_interest_propagate(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i)
 {
-    struct ccnl_forward_s *fwd;
-    int rc = 0;
+    struct ccnl_forward_s *fwd, *nh[CCNL_MAX_NEXTHOPS];
+    const struct ccnl_strategy_s *strategy = NULL;
+    int rc = 0, cnt = 0, n, k;
+    uint32_t rto = 0;
     char s[CCNL_MAX_PREFIX_SIZE];
     (void) s;
 
-#if defined(USE_RONR)
-    int matching_face = 0;
-#endif
-
     if (!i) {
         return;
     }
@@ -400,66 +481,75 @@ ccnl_interest_propagate(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i)
 
     // CONFORM: "A node MUST implement some strategy rule, even if it is only to
     // transmit an Interest Message on all listed dest faces in sequence."
-    // CCNL strategy: we forward on all FWD entries with a prefix match
-
-    for (fwd = ccnl->fib; fwd; fwd = fwd->next) {
-        if (!fwd->prefix) {
-            continue;
-        }
-
-        //Only for matching suite
-        if (!i->pkt->pfx || fwd->suite != i->pkt->pfx->suite) {
-            DEBUGMSG_CORE(VERBOSE, "  not same suite (%d/%d)\n",
-                     fwd->suite, i->pkt->pfx ? i->pkt->pfx->suite : -1);
-            continue;
-        }
-
-        rc = ccnl_prefix_cmp(fwd->prefix, NULL, i->pkt->pfx, CMP_LONGEST);
+    // CCNL strategy: the strategy of the longest matching prefix chooses
+    // among its next hops, by default we forward on all of them
 
+    fwd = i->pkt->pfx ? ccnl_fib_longest_match(ccnl, i->pkt->pfx) : NULL;
+    if (fwd) {
+        rc = (int) fwd->prefix->compcnt;
+    }
+    for (; fwd; fwd = ccnl_fib_lookup(ccnl, i->pkt->pfx, (uint32_t) rc, fwd)) {
         DEBUGMSG_CORE(DEBUG, "  ccnl_interest_propagate, rc=%ld/%ld\n",
-                 (long) rc, (long) fwd->prefix->compcnt);
-        if (rc < (signed) fwd->prefix->compcnt) {
-            continue;
-        }
-
+                 (long) rc, (long) i->pkt->pfx->compcnt);
         DEBUGMSG_CORE(DEBUG, "  ccnl_interest_propagate, fwd==%p\n", (void*)fwd);
+        if (!strategy) {
+            strategy = fwd->strategy;
+        }
         // suppress forwarding to origin of interest, except wireless
         if (!i->from || fwd->face != i->from ||
                                 (i->from->flags & CCNL_FACE_FLAGS_REFLECT)) {
-            int nonce = 0;
-            if (i->pkt != NULL && i->pkt->s.ndntlv.nonce != NULL) {
-                if (i->pkt->s.ndntlv.nonce->datalen == 4) {
-                    memcpy(&nonce, i->pkt->s.ndntlv.nonce->data, 4);
-                }
+            if (cnt < CCNL_MAX_NEXTHOPS) {
+                nh[cnt++] = fwd;
+            } else {
+                DEBUGMSG_CORE(WARNING, "  too many next hops, ignoring %p\n",
+                              (void*)fwd);
             }
+        } else {
+            DEBUGMSG_CORE(DEBUG, "  no matching fib entry found\n");
+        }
+    }
 
-            DEBUGMSG_CFWD(INFO, "  outgoing interest=<%s> nonce=%i to=%s\n",
-                          ccnl_prefix_to_str(i->pkt->pfx,s,CCNL_MAX_PREFIX_SIZE), nonce,
-                          fwd->face ? ccnl_addr2ascii(&fwd->face->peer)
-                                    : "<tap>");
+    n = cnt ? ccnl_strategy_choose(ccnl, strategy, i, nh, cnt) : 0;
+    for (k = 0; k < n; k++) {
+        int nonce = 0;
 
-            // DEBUGMSG(DEBUG, "%p %p %p\n", (void*)i, (void*)i->pkt, (void*)i->pkt->buf);
-            if (fwd->tap) {
-                (fwd->tap)(ccnl, i->from, i->pkt->pfx, i->pkt->buf);
+        fwd = nh[k];
+        if (i->pkt != NULL && i->pkt->s.ndntlv.nonce != NULL) {
+            if (i->pkt->s.ndntlv.nonce->datalen == 4) {
+                memcpy(&nonce, i->pkt->s.ndntlv.nonce->data, 4);
             }
-            if (fwd->face) {
-                ccnl_send_pkt(ccnl, fwd->face, i->pkt);
+        }
+
+        DEBUGMSG_CFWD(INFO, "  outgoing interest=<%s> nonce=%i to=%s\n",
+                      ccnl_prefix_to_str(i->pkt->pfx,s,CCNL_MAX_PREFIX_SIZE), nonce,
+                      fwd->face ? ccnl_addr2ascii(&fwd->face->peer)
+                                : "<tap>");
+
+        // DEBUGMSG(DEBUG, "%p %p %p\n", (void*)i, (void*)i->pkt, (void*)i->pkt->buf);
+        if (fwd->tap) {
+            (fwd->tap)(ccnl, i->from, i->pkt->pfx, i->pkt->buf);
+        }
+        if (fwd->face) {
+            ccnl_send_pkt(ccnl, fwd->face, i->pkt);
+            fwd->face->perf.forwarded++;
+            // wait for the slowest of the next hops
+            if (ccnl_rtt_rto(&fwd->face->perf.rtt) > rto) {
+                rto = ccnl_rtt_rto(&fwd->face->perf.rtt);
             }
-#if defined(USE_RONR)
-            matching_face = 1;
-#endif
-        } else {
-            DEBUGMSG_CORE(DEBUG, "  no matching fib entry found\n");
         }
+        fwd->uses++;
     }
 
 #ifdef USE_RONR
-    if (!matching_face) {
+    if (!cnt) {
         ccnl_interest_broadcast(ccnl, i);
     }
 #endif
 
-    return;
+    if (rto) {
+        i->rto = rto;
+    }
+    ccnl_interest_schedule(ccnl, i);
 }
 
 void
@@ -532,6 +622,10 @@ ccnl_content_remove(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
 
     c2 = c->next;
     DBL_LINKED_LIST_REMOVE(ccnl->contents, c);
+    ccnl_ageq_remove(&ccnl->cs_ageq, &c->age_entry);
+    ccnl_htable_remove(&ccnl->cs_index, &c->cs_entry);
+    ccnl_cs_policy_remove(ccnl, c);
+    ccnl->cache_bytes -= ccnl_content_size(c);
 
 #ifdef CCNL_RIOT
     evtimer_del((evtimer_t *)(&ccnl_evtimer), (evtimer_event_t *)&c->evtmsg_cstimeout);
@@ -540,11 +634,11 @@ ccnl_content_remove(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
 //    free_content(c);
     if (c->pkt) {
         ccnl_prefix_free(c->pkt->pfx);
-        ccnl_free(c->pkt->buf);
-        ccnl_free(c->pkt);
+        ccnl_buf_free(c->pkt->buf);
+        ccnl_pool_free(c->pkt);
     }
     //    ccnl_prefix_free(c->name);
-    ccnl_free(c);
+    ccnl_pool_free(c);
 
     ccnl->contentcnt--;
     return c2;
@@ -554,6 +648,7 @@ struct ccnl_content_s*
 ccnl_content_add2cache(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
 {
     struct ccnl_content_s *cit;
+    size_t size;
     char s[CCNL_MAX_PREFIX_SIZE];
     (void) s;
 
@@ -561,153 +656,219 @@ ccnl_content_add2cache(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
                   ccnl->contentcnt, ccnl->max_cache_entries,
                   (void*)c, ccnl_prefix_to_str(c->pkt->pfx,s,CCNL_MAX_PREFIX_SIZE), (c->pkt->pfx->chunknum)? (signed) *(c->pkt->pfx->chunknum) : -1);
 
-    for (cit = ccnl->contents; cit; cit = cit->next) {
+    for (cit = ccnl_content_lookup(ccnl, c->pkt->pfx, c->pkt->pfx->compcnt, NULL);
+         cit; cit = ccnl_content_lookup(ccnl, c->pkt->pfx, c->pkt->pfx->compcnt, cit)) {
         if (ccnl_prefix_cmp(c->pkt->pfx, NULL, cit->pkt->pfx, CMP_EXACT) == 0) {
             DEBUGMSG_CORE(DEBUG, "--- Already in cache ---\n");
             return NULL;
         }
     }
 
-    if (ccnl->max_cache_entries > 0 &&
-        ccnl->contentcnt >= ccnl->max_cache_entries && !cache_strategy_remove(ccnl, c)) {
-        // remove oldest content
-        struct ccnl_content_s *c2, *oldest = NULL;
-        uint32_t age = 0;
-        for (c2 = ccnl->contents; c2; c2 = c2->next) {
-             if (!(c2->flags & CCNL_CONTENT_FLAGS_STATIC)) {
-                 if ((age == 0) || c2->last_used < age) {
-                     age = c2->last_used;
-                     oldest = c2;
-                 }
-             }
-         }
-         if (oldest) {
-             DEBUGMSG_CORE(DEBUG, " remove old entry from cache\n");
-             ccnl_content_remove(ccnl, oldest);
-         }
-    }
-    if ((ccnl->max_cache_entries <= 0) ||
-         (ccnl->contentcnt <= ccnl->max_cache_entries)) {
+    size = ccnl_content_size(c);
+    if (ccnl->max_cache_bytes && size > ccnl->max_cache_bytes) {
+        DEBUGMSG_CORE(DEBUG, "  content exceeds the cache budget\n");
+        return NULL;
+    }
+
+    while ((ccnl->max_cache_entries > 0 && ccnl->contentcnt >= ccnl->max_cache_entries) ||
+           (ccnl->max_cache_bytes && ccnl->cache_bytes + size > ccnl->max_cache_bytes)) {
+        int cnt = ccnl->contentcnt;
+
+        if (!cache_strategy_remove(ccnl, c)) {
+            // let the replacement policy pick the entry to evict
+            struct ccnl_content_s *victim = ccnl_cs_policy_victim(ccnl);
+            if (!victim) {
+                break;
+            }
+            if (!ccnl_cs_admit(ccnl, c, victim)) {
+                DEBUGMSG_CORE(DEBUG, "  content not admitted\n");
+                ccnl->cs_stats.rejected++;
+                return NULL;
+            }
+            DEBUGMSG_CORE(DEBUG, " remove old entry from cache\n");
+            if (ccnl->ccnl_cs_evict_ptr) {
+                ccnl->ccnl_cs_evict_ptr(ccnl, victim);
+            }
+            ccnl_content_remove(ccnl, victim);
+        }
+        if (ccnl->contentcnt >= cnt) {
+            break;
+        }
+    }
+    if (((ccnl->max_cache_entries <= 0) ||
+         (ccnl->contentcnt <= ccnl->max_cache_entries)) &&
+        (!ccnl->max_cache_bytes ||
+         (ccnl->cache_bytes + size <= ccnl->max_cache_bytes))) {
+            if (ccnl_htable_add(&ccnl->cs_index, &c->cs_entry,
+                    ccnl_prefix_hash(c->pkt->pfx, c->pkt->pfx->compcnt), c)) {
+                DEBUGMSG_CORE(WARNING, "  could not index content\n");
+                return NULL;
+            }
             DBL_LINKED_LIST_ADD(ccnl->contents, c);
+            // static content is dropped from the queue when it is due
+            ccnl_ageq_add(&ccnl->cs_ageq, &c->age_entry,
+                          c->last_used + CCNL_CONTENT_TIMEOUT, c);
             ccnl->contentcnt++;
+            ccnl->cache_bytes += size;
+            ccnl_cs_policy_insert(ccnl, c);
 #ifdef CCNL_RIOT
             /* set cache timeout timer if content is not static */
             if (!(c->flags & CCNL_CONTENT_FLAGS_STATIC)) {
                 ccnl_evtimer_set_cs_timeout(c);
             }
 #endif
+            return c;
     }
 
-    return c;
+    DEBUGMSG_CORE(DEBUG, "  no room in the cache\n");
+    return NULL;
+}
+
+struct ccnl_content_s*
+ccnl_content_lookup(struct ccnl_relay_s *ccnl, struct ccnl_prefix_s *pfx,
+                    uint32_t compcnt, struct ccnl_content_s *prev)
+{
+    struct ccnl_hentry_s *e;
+
+    if (compcnt > pfx->compcnt) {
+        return NULL;
+    }
+    e = prev ? ccnl_htable_next(&prev->cs_entry) :
+               ccnl_htable_lookup(&ccnl->cs_index, ccnl_prefix_hash(pfx, compcnt));
+    for (; e; e = ccnl_htable_next(e)) {
+        if (ccnl_prefix_is_head(((struct ccnl_content_s *) e->obj)->pkt->pfx,
+                                pfx, compcnt)) {
+            return (struct ccnl_content_s *) e->obj;
+        }
+    }
+
+    return NULL;
 }
 
 int
-ccnl_content_serve_pending(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
+ccnl_content_serve_pending(struct ccnl_relay_s *ccnl, struct ccnl_face_s *from,
+                           struct ccnl_content_s *c)
 {
     struct ccnl_interest_s *i;
     struct ccnl_face_s *f;
-    int cnt = 0;
+    struct ccnl_hentry_s *e, *enext;
+    uint32_t h;
+    int cnt = 0, k;
     DEBUGMSG_CORE(TRACE, "ccnl_content_serve_pending\n");
     char s[CCNL_MAX_PREFIX_SIZE];
 
     for (f = ccnl->faces; f; f = f->next){
                 f->flags &= ~CCNL_FACE_FLAGS_SERVED; // reply on a face only once
     }
-    for (i = ccnl->pit; i;) {
-        struct ccnl_pendint_s *pi;
-        if (!i->pkt->pfx) {
-            continue;
-        }
 
-        switch (i->pkt->pfx->suite) {
-#ifdef USE_SUITE_CCNB
-        case CCNL_SUITE_CCNB:
-            if (ccnl_i_prefixof_c(i->pkt->pfx, i->pkt->s.ccnb.minsuffix,
-                       i->pkt->s.ccnb.maxsuffix, c) < 0) {
-                // XX must also check i->ppkd
-                i = i->next;
+    // candidates are the PIT entries with the name of the content, and
+    // those whose name is the content name plus an implicit digest
+    h = ccnl_prefix_hash(c->pkt->pfx, c->pkt->pfx->compcnt);
+    for (k = 0; k < 2; k++) {
+        for (e = ccnl_htable_lookup(k ? &ccnl->pit_digest_index : &ccnl->pit_index, h);
+             e; e = enext) {
+            struct ccnl_pendint_s *pi;
+            enext = ccnl_htable_next(e);
+            i = (struct ccnl_interest_s *) e->obj;
+            if (!i->pkt->pfx) {
                 continue;
             }
-            break;
+
+            switch (i->pkt->pfx->suite) {
+#ifdef USE_SUITE_CCNB
+            case CCNL_SUITE_CCNB:
+                if (ccnl_i_prefixof_c(i->pkt->pfx, i->pkt->s.ccnb.minsuffix,
+                           i->pkt->s.ccnb.maxsuffix, c) < 0) {
+                    // XX must also check i->ppkd
+                    continue;
+                }
+                break;
 #endif
 #ifdef USE_SUITE_CCNTLV
-        case CCNL_SUITE_CCNTLV:
-            if (ccnl_prefix_cmp(c->pkt->pfx, NULL, i->pkt->pfx, CMP_EXACT)) {
-                // XX must also check keyid
-                i = i->next;
-                continue;
-            }
-            break;
+            case CCNL_SUITE_CCNTLV:
+                if (ccnl_prefix_cmp(c->pkt->pfx, NULL, i->pkt->pfx, CMP_EXACT)) {
+                    // XX must also check keyid
+                    continue;
+                }
+                break;
 #endif
 #ifdef USE_SUITE_NDNTLV
-        case CCNL_SUITE_NDNTLV:
-            if (ccnl_i_prefixof_c(i->pkt->pfx, i->pkt->s.ndntlv.minsuffix,
-                    i->pkt->s.ndntlv.maxsuffix, c) < 0) {
-                // XX must also check i->ppkl,
-                i = i->next;
+            case CCNL_SUITE_NDNTLV:
+                if (ccnl_i_prefixof_c(i->pkt->pfx, i->pkt->s.ndntlv.minsuffix,
+                        i->pkt->s.ndntlv.maxsuffix, c) < 0) {
+                    // XX must also check i->ppkl,
+                    continue;
+                }
+                break;
+#endif
+            default:
                 continue;
             }
-            break;
-#endif
-        default:
-            i = i->next;
-            continue;
-        }
-
-        //Hook for add content to cache by callback:
-        if(i && ! i->pending){
-            DEBUGMSG_CORE(WARNING, "releasing interest 0x%p OK?\n", (void*)i);
-            c->flags |= CCNL_CONTENT_FLAGS_STATIC;
-            i = ccnl_interest_remove(ccnl, i);
 
-            c->served_cnt++;
-            cnt++;
-            continue;
-            //return 1;
+            // the answer to a retransmitted interest could be to any of
+            // its transmissions: only measure the first (Karn)
+            if (from) {
+                from->perf.satisfied++;
+                if (!i->retries) {
+                    ccnl_rtt_sample(&from->perf.rtt, ccnl_rtt_now() - i->sent);
+                }
+            }
 
-        }
+            //Hook for add content to cache by callback:
+            if(i && ! i->pending){
+                DEBUGMSG_CORE(WARNING, "releasing interest 0x%p OK?\n", (void*)i);
+                c->flags |= CCNL_CONTENT_FLAGS_STATIC;
+                ccnl_interest_remove(ccnl, i);
 
-        // CONFORM: "Data MUST only be transmitted in response to
-        // an Interest that matches the Data."
-        for (pi = i->pending; pi; pi = pi->next) {
-            if (pi->face->flags & CCNL_FACE_FLAGS_SERVED) {
+                c->served_cnt++;
+                cnt++;
                 continue;
+                //return 1;
+
             }
-            pi->face->flags |= CCNL_FACE_FLAGS_SERVED;
-            if (pi->face->ifndx >= 0) {
-                int32_t nonce = 0;
-                if (i->pkt != NULL && i->pkt->s.ndntlv.nonce != NULL) {
-                    if (i->pkt->s.ndntlv.nonce->datalen == 4) {
-                        memcpy(&nonce, i->pkt->s.ndntlv.nonce->data, 4);
-                    }
+
+            // CONFORM: "Data MUST only be transmitted in response to
+            // an Interest that matches the Data."
+            for (pi = i->pending; pi; pi = pi->next) {
+                if (pi->face->flags & CCNL_FACE_FLAGS_SERVED) {
+                    continue;
                 }
+                pi->face->flags |= CCNL_FACE_FLAGS_SERVED;
+                if (pi->face->ifndx >= 0) {
+                    int32_t nonce = 0;
+                    if (i->pkt != NULL && i->pkt->s.ndntlv.nonce != NULL) {
+                        if (i->pkt->s.ndntlv.nonce->datalen == 4) {
+                            memcpy(&nonce, i->pkt->s.ndntlv.nonce->data, 4);
+                        }
+                    }
 
 #ifndef CCNL_LINUXKERNEL
-                DEBUGMSG_CFWD(INFO, "  outgoing data=<%s>%s nonce=%"PRIi32" to=%s\n",
-                          ccnl_prefix_to_str(i->pkt->pfx,s,CCNL_MAX_PREFIX_SIZE),
-                          ccnl_suite2str(i->pkt->pfx->suite), nonce,
-                          ccnl_addr2ascii(&pi->face->peer));
+                    DEBUGMSG_CFWD(INFO, "  outgoing data=<%s>%s nonce=%"PRIi32" to=%s\n",
+                              ccnl_prefix_to_str(i->pkt->pfx,s,CCNL_MAX_PREFIX_SIZE),
+                              ccnl_suite2str(i->pkt->pfx->suite), nonce,
+                              ccnl_addr2ascii(&pi->face->peer));
 #else
-                DEBUGMSG_CFWD(INFO, "  outgoing data=<%s>%s nonce=%d to=%s\n",
-                          ccnl_prefix_to_str(i->pkt->pfx,s,CCNL_MAX_PREFIX_SIZE),
-                          ccnl_suite2str(i->pkt->pfx->suite), nonce,
-                          ccnl_addr2ascii(&pi->face->peer));
+                    DEBUGMSG_CFWD(INFO, "  outgoing data=<%s>%s nonce=%d to=%s\n",
+                              ccnl_prefix_to_str(i->pkt->pfx,s,CCNL_MAX_PREFIX_SIZE),
+                              ccnl_suite2str(i->pkt->pfx->suite), nonce,
+                              ccnl_addr2ascii(&pi->face->peer));
 #endif
-                DEBUGMSG_CORE(VERBOSE, "    Serve to face: %d (pkt=%p)\n",
-                         pi->face->faceid, (void*) c->pkt);
+                    DEBUGMSG_CORE(VERBOSE, "    Serve to face: %d (pkt=%p)\n",
+                             pi->face->faceid, (void*) c->pkt);
 
-                ccnl_send_pkt(ccnl, pi->face, c->pkt);
+                    ccnl_send_pkt(ccnl, pi->face, c->pkt);
 
 
-            } else {// upcall to deliver content to local client
+                } else {// upcall to deliver content to local client
 #ifdef CCNL_APP_RX
-                ccnl_app_RX(ccnl, c);
+                    ccnl_app_RX(ccnl, c);
 #endif
+                }
+                c->served_cnt++;
+                cnt++;
             }
-            c->served_cnt++;
-            cnt++;
+            ccnl_interest_remove(ccnl, i);
         }
-        i = ccnl_interest_remove(ccnl, i);
     }
 
     return cnt;
@@ -722,119 +883,108 @@ DEBUGMSG_CORE(DEBUG, " %s 0x%p <%s>\n", (debug),       \
 void
 ccnl_do_ageing(void *ptr, void *dummy)
 {
-
     struct ccnl_relay_s *relay = (struct ccnl_relay_s*) ptr;
-    struct ccnl_content_s *c = relay->contents;
-    struct ccnl_interest_s *i = relay->pit;
-    struct ccnl_face_s *f = relay->faces;
-    time_t t = CCNL_NOW();
+    struct ccnl_content_s *c;
+    struct ccnl_interest_s *i;
+    struct ccnl_face_s *f;
+    uint32_t t = (uint32_t) CCNL_NOW(), now = ccnl_rtt_now();
+    struct timeval start, end;
+    int budget, capped = 0;
     DEBUGMSG_CORE(VERBOSE, "ageing t=%d\n", (int)t);
     (void) dummy;
     char s[CCNL_MAX_PREFIX_SIZE];
     (void) s;
 
-    while (c) {
-        if ((c->last_used + CCNL_CONTENT_TIMEOUT) <= (uint32_t) t &&
-                                !(c->flags & CCNL_CONTENT_FLAGS_STATIC)){
-            DEBUGMSG_CORE(TRACE, "AGING: CONTENT REMOVE %p\n", (void*) c);
-            c = ccnl_content_remove(relay, c);
+    ccnl_get_timeval(&start);
+
+    // the queues are ordered by the time their entries are due: stop at
+    // the first entry which is not, or when the budget is used up
+    for (budget = CCNL_AGEING_BUDGET;
+                (c = ccnl_ageq_due(&relay->cs_ageq, t)); budget--) {
+        if (!budget) {
+            capped = 1;
+            break;
         }
-        else {
-#ifdef USE_SUITE_NDNTLV
-            if (c->pkt->suite == CCNL_SUITE_NDNTLV) {
-                // Mark content as stale if its freshness period expired and it is not static
-                if ((c->last_used + (c->pkt->s.ndntlv.freshnessperiod / 1000)) <= (uint32_t) t &&
-                        !(c->flags & CCNL_CONTENT_FLAGS_STATIC)) {
-                    c->flags |= CCNL_CONTENT_FLAGS_STALE;
-                }
-            }
-#endif
-            c = c->next;
+        if (c->flags & CCNL_CONTENT_FLAGS_STATIC) {
+            ccnl_ageq_remove(&relay->cs_ageq, &c->age_entry);
+        } else {
+            DEBUGMSG_CORE(TRACE, "AGING: CONTENT REMOVE %p\n", (void*) c);
+            ccnl_content_remove(relay, c);
         }
     }
-    while (i) { // CONFORM: "Entries in the PIT MUST timeout rather
-                // than being held indefinitely."
-        if ((i->last_used + i->lifetime) <= (uint32_t) t ||
+    for (budget = CCNL_AGEING_BUDGET;
+                (i = ccnl_ageq_due(&relay->pit_ageq, now)); budget--) {
+        if (!budget) {
+            capped = 1;
+            break;
+        }
+        // CONFORM: "Entries in the PIT MUST timeout rather
+        // than being held indefinitely."
+        if ((i->last_used + i->lifetime) <= t ||
                                 i->retries >= CCNL_MAX_INTEREST_RETRANSMIT) {
                 DEBUGMSG_AGEING("AGING: REMOVE INTEREST", "timeout: remove interest", s, CCNL_MAX_PREFIX_SIZE);
-                i = ccnl_interest_remove(relay, i);
+                ccnl_interest_remove(relay, i);
         } else {
             // CONFORM: "A node MUST retransmit Interest Messages
             // periodically for pending PIT entries."
+            // The entry is due after the RTO of its next hops, doubled
+            // with each retransmission
             DEBUGMSG_CORE(DEBUG, " retransmit %d <%s>\n", i->retries,
                      ccnl_prefix_to_str(i->pkt->pfx,s,CCNL_MAX_PREFIX_SIZE));
-                DEBUGMSG_CORE(TRACE, "AGING: PROPAGATING INTEREST %p\n", (void*) i);
-                ccnl_interest_propagate(relay, i);
-
+            DEBUGMSG_CORE(TRACE, "AGING: PROPAGATING INTEREST %p\n", (void*) i);
             i->retries++;
-            i = i->next;
-        }
-    }
-    while (f) {
-        if (!(f->flags & CCNL_FACE_FLAGS_STATIC) &&
-                (f->last_used + CCNL_FACE_TIMEOUT) <= (uint32_t) t){
-            DEBUGMSG_CORE(TRACE, "AGING: FACE REMOVE %p\n", (void*) f);
-            f = ccnl_face_remove(relay, f);
-        } else {
-            f = f->next;
+            ccnl_interest_propagate(relay, i);
         }
     }
-}
-
-int
-ccnl_nonce_find_or_append(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *nonce)
-{
-    struct ccnl_buf_s *n, *n2 = 0;
-    int i;
-    DEBUGMSG_CORE(TRACE, "ccnl_nonce_find_or_append\n");
-
-    for (n = ccnl->nonces, i = 0; n; n = n->next, i++) {
-        if (buf_equal(n, nonce)) {
-            return -1;
+    for (budget = CCNL_AGEING_BUDGET;
+                (f = ccnl_ageq_due(&relay->face_ageq, t)); budget--) {
+        if (!budget) {
+            capped = 1;
+            break;
         }
-        if (n->next) {
-            n2 = n;
+        ccnl_ageq_remove(&relay->face_ageq, &f->age_entry);
+        if (f->flags & CCNL_FACE_FLAGS_STATIC) {
+            continue;
         }
-    }
-    n = ccnl_buf_new(nonce->data, nonce->datalen);
-    if (n) {
-        n->next = ccnl->nonces;
-        ccnl->nonces = n;
-        if (i >= CCNL_MAX_NONCES && n2) {
-            ccnl_free(n2->next);
-            n2->next = 0;
+        if ((f->last_used + CCNL_FACE_TIMEOUT) <= t) {
+            DEBUGMSG_CORE(TRACE, "AGING: FACE REMOVE %p\n", (void*) f);
+            ccnl_face_remove(relay, f);
+        } else { // used since it was queued
+            ccnl_ageq_add(&relay->face_ageq, &f->age_entry,
+                          f->last_used + CCNL_FACE_TIMEOUT, f);
         }
     }
-    return 0;
+
+    ccnl_get_timeval(&end);
+    relay->ageing.capped += capped;
+    ccnl_ageing_record(&relay->ageing, timevaldelta(&end, &start));
 }
 
 int
 ccnl_nonce_isDup(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt)
 {
-    if(CCNL_MAX_NONCES < 0){
-        struct ccnl_interest_s *i = NULL;
-        for (i = relay->pit; i; i = i->next) {
-            if(buf_equal(i->pkt->s.ndntlv.nonce, pkt->s.ndntlv.nonce)){
-                return 1;
-            }
-        }
-        return 0;
-    }
+    struct ccnl_buf_s *nonce = NULL;
+
     switch (pkt->suite) {
 #ifdef USE_SUITE_CCNB
     case CCNL_SUITE_CCNB:
-        return pkt->s.ccnb.nonce &&
-            ccnl_nonce_find_or_append(relay, pkt->s.ccnb.nonce);
+        nonce = pkt->s.ccnb.nonce;
+        break;
 #endif
 #ifdef USE_SUITE_NDNTLV
     case CCNL_SUITE_NDNTLV:
-        return pkt->s.ndntlv.nonce &&
-            ccnl_nonce_find_or_append(relay, pkt->s.ndntlv.nonce);
+        nonce = pkt->s.ndntlv.nonce;
+        break;
 #endif
     default:
         break;
     }
-    return 0;
+    if (!nonce) {
+        return 0;
+    }
+    return ccnl_nonce_filter_check(&relay->nonce_filter,
+                                   ccnl_nonce_hash(pkt->pfx, nonce),
+                                   (uint32_t) CCNL_NOW());
 }
 
 #ifdef NEEDS_PREFIX_MATCHING
@@ -844,36 +994,39 @@ int
 ccnl_fib_add_entry(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx,
                    struct ccnl_face_s *face)
 {
-    struct ccnl_forward_s *fwd, **fwd2;
+    struct ccnl_forward_s *fwd;
     char s[CCNL_MAX_PREFIX_SIZE];
     (void) s;
 
     DEBUGMSG_CUTL(INFO, "adding FIB for <%s>, suite %s\n",
              ccnl_prefix_to_str(pfx,s,CCNL_MAX_PREFIX_SIZE), ccnl_suite2str(pfx->suite));
 
-    for (fwd = relay->fib; fwd; fwd = fwd->next) {
-        if (fwd->suite == pfx->suite &&
-                        !ccnl_prefix_cmp(fwd->prefix, NULL, pfx, CMP_EXACT)) {
-            ccnl_prefix_free(fwd->prefix);
-            fwd->prefix = NULL;
-            break;
+    // one entry per (prefix, next hop): refresh a known next hop
+    for (fwd = ccnl_fib_lookup(relay, pfx, pfx->compcnt, NULL); fwd;
+         fwd = ccnl_fib_lookup(relay, pfx, pfx->compcnt, fwd)) {
+        if (fwd->face == face) {
+            if (fwd->prefix != pfx) {
+                ccnl_prefix_free(fwd->prefix);
+                fwd->prefix = pfx;
+            }
+            return 0;
         }
     }
+
+    fwd = (struct ccnl_forward_s *) ccnl_calloc(1, sizeof(*fwd));
     if (!fwd) {
-        fwd = (struct ccnl_forward_s *) ccnl_calloc(1, sizeof(*fwd));
-        if (!fwd) {
-            return -1;
-        }
-        fwd2 = &relay->fib;
-        while (*fwd2) {
-            fwd2 = &((*fwd2)->next);
-        }
-        *fwd2 = fwd;
-        fwd->suite = pfx->suite;
+        return -1;
     }
+    fwd->suite = pfx->suite;
     fwd->prefix = pfx;
     fwd->face = face;
-    DEBUGMSG_CUTL(DEBUG, "added FIB via %s\n", ccnl_addr2ascii(&fwd->face->peer));
+    if (ccnl_fib_link(relay, fwd)) {
+        ccnl_free(fwd);
+        return -1;
+    }
+    if (fwd->face) {
+        DEBUGMSG_CUTL(DEBUG, "added FIB via %s\n", ccnl_addr2ascii(&fwd->face->peer));
+    }
 
     return 0;
 }
@@ -884,43 +1037,124 @@ ccnl_fib_rem_entry(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx,
                    struct ccnl_face_s *face)
 {
     struct ccnl_forward_s *fwd;
-    int res = -1;
-    struct ccnl_forward_s *last = NULL;
     char s[CCNL_MAX_PREFIX_SIZE];
     (void) s;
 
     if (pfx != NULL) {
-        char *s = NULL;
         DEBUGMSG_CUTL(INFO, "removing FIB for <%s>, suite %s\n",
                       ccnl_prefix_to_str(pfx,s,CCNL_MAX_PREFIX_SIZE), ccnl_suite2str(pfx->suite));
+        fwd = ccnl_fib_lookup(relay, pfx, pfx->compcnt, NULL);
+    } else {
+        fwd = relay->fib;
     }
 
-    for (fwd = relay->fib; fwd; last = fwd, fwd = fwd->next) {
-        if (((pfx == NULL) || (fwd->suite == pfx->suite)) &&
-            ((pfx == NULL) || !ccnl_prefix_cmp(fwd->prefix, NULL, pfx, CMP_EXACT)) &&
-            ((face == NULL) || (fwd->face == face))) {
-            res = 0;
-            if (!last) {
-                relay->fib = fwd->next;
-            }
-            else {
-                last->next = fwd->next;
-            }
+    while (fwd) {
+        if ((face == NULL) || (fwd->face == face)) {
+            ccnl_fib_unlink(relay, fwd);
             ccnl_prefix_free(fwd->prefix);
             ccnl_free(fwd);
-            return res;
+            return 0;
         }
+        fwd = pfx ? ccnl_fib_lookup(relay, pfx, pfx->compcnt, fwd) : fwd->next;
     }
 
-    if (fwd) {
-        if (fwd->face) {
-            DEBUGMSG_CUTL(DEBUG, "added FIB via %s\n", ccnl_addr2ascii(&fwd->face->peer));
+    return -1;
+}
+#endif
+
+int
+ccnl_fib_link(struct ccnl_relay_s *relay, struct ccnl_forward_s *fwd)
+{
+    if (fwd->prefix &&
+        ccnl_htable_add(&relay->fib_index, &fwd->fib_entry,
+                        ccnl_prefix_hash(fwd->prefix, fwd->prefix->compcnt), fwd)) {
+        return -1;
+    }
+    DBL_LINKED_LIST_ADD(relay->fib, fwd);
+    if (fwd->face) {
+        fwd->face_prev = NULL;
+        fwd->face_next = fwd->face->fwds;
+        if (fwd->face->fwds) {
+            fwd->face->fwds->face_prev = fwd;
         }
+        fwd->face->fwds = fwd;
     }
+    relay->fib_version++;
 
-    return res;
+    return 0;
+}
+
+void
+ccnl_fib_unlink(struct ccnl_relay_s *relay, struct ccnl_forward_s *fwd)
+{
+    DBL_LINKED_LIST_REMOVE(relay->fib, fwd);
+    fwd->next = fwd->prev = NULL;
+    if (fwd->face) {
+        if (fwd->face_prev) {
+            fwd->face_prev->face_next = fwd->face_next;
+        } else if (fwd->face->fwds == fwd) {
+            fwd->face->fwds = fwd->face_next;
+        }
+        if (fwd->face_next) {
+            fwd->face_next->face_prev = fwd->face_prev;
+        }
+        fwd->face_next = fwd->face_prev = NULL;
+    }
+    ccnl_htable_remove(&relay->fib_index, &fwd->fib_entry);
+    relay->fib_version++;
+}
+
+static struct ccnl_forward_s*
+ccnl_fib_lookup_hash(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx,
+                     uint32_t compcnt, uint32_t hash, struct ccnl_forward_s *prev)
+{
+    struct ccnl_hentry_s *e;
+
+    e = prev ? ccnl_htable_next(&prev->fib_entry) :
+               ccnl_htable_lookup(&relay->fib_index, hash);
+    for (; e; e = ccnl_htable_next(e)) {
+        struct ccnl_forward_s *fwd = (struct ccnl_forward_s *) e->obj;
+
+        if (fwd->suite == pfx->suite &&
+            ccnl_prefix_is_head(fwd->prefix, pfx, compcnt)) {
+            return fwd;
+        }
+    }
+
+    return NULL;
+}
+
+struct ccnl_forward_s*
+ccnl_fib_lookup(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx,
+                uint32_t compcnt, struct ccnl_forward_s *prev)
+{
+    if (compcnt > pfx->compcnt) {
+        return NULL;
+    }
+    return ccnl_fib_lookup_hash(relay, pfx, compcnt,
+                                prev ? 0 : ccnl_prefix_hash(pfx, compcnt), prev);
+}
+
+struct ccnl_forward_s*
+ccnl_fib_longest_match(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx)
+{
+    uint32_t hashes[CCNL_MAX_NAME_COMP + 1];
+    uint32_t n = pfx->compcnt < CCNL_MAX_NAME_COMP ? pfx->compcnt : CCNL_MAX_NAME_COMP;
+    struct ccnl_forward_s *fwd;
+
+    if (!relay->fib_index.count) {
+        return NULL;
+    }
+    ccnl_prefix_hashes(pfx, hashes, n);
+    do {
+        fwd = ccnl_fib_lookup_hash(relay, pfx, n, hashes[n], NULL);
+        if (fwd) {
+            return fwd;
+        }
+    } while (n-- > 0);
+
+    return NULL;
 }
-#endif
 
 /* prints the current FIB */
 void
@@ -981,9 +1215,10 @@ ccnl_interface_CTS(void *aux1, void *aux2)
     struct ccnl_txrequest_s *r, req;
 
     DEBUGMSG_CORE(TRACE, "interface_CTS interface=%p, qlen=%zu, sched=%p\n",
-             (void*)ifc, ifc->qlen, (void*)ifc->sched);
+             (void*)ifc, ccnl_interface_qlen(ifc), (void*)ifc->sched);
 
-    if (ifc->qlen <= 0) {
+    r = ccnl_interface_qpeek(ifc, 0);
+    if (!r) {
         return;
     }
 
@@ -991,10 +1226,8 @@ ccnl_interface_CTS(void *aux1, void *aux2)
     ifc->tx_cnt++;
 #endif
 
-    r = ifc->queue + ifc->qfront;
     memcpy(&req, r, sizeof(req));
-    ifc->qfront = (ifc->qfront + 1) % CCNL_MAX_IF_QLEN;
-    ifc->qlen--;
+    ccnl_interface_qrelease(ifc);
 #ifndef CCNL_LINUXKERNEL
     assert(ccnl->ccnl_ll_TX_ptr != 0);
 #endif
@@ -1004,7 +1237,50 @@ ccnl_interface_CTS(void *aux1, void *aux2)
     if (req.txdone)
         req.txdone(req.txdone_face, 1, req.buf->datalen);
 #endif
-    ccnl_free(req.buf);
+    ccnl_buf_free(req.buf);
+}
+
+void
+ccnl_interface_flush(struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc)
+{
+    struct ccnl_txrequest_s *reqs[CCNL_MAX_IF_QLEN];
+
+    while (ccnl_interface_qlen(ifc) > 0) {
+        // up to a batch of the oldest packets
+        int cnt, sent;
+
+        if (!ccnl->ccnl_ll_TXv_ptr) {
+            if (!ccnl_interface_qpeek(ifc, 0)) {
+                break;
+            }
+            ccnl_interface_CTS(ccnl, ifc);
+            continue;
+        }
+        for (cnt = 0; cnt < CCNL_MAX_IF_QLEN; cnt++) {
+            reqs[cnt] = ccnl_interface_qpeek(ifc, (uint32_t) cnt);
+            if (!reqs[cnt]) {
+                break;
+            }
+        }
+        if (!cnt) { // reserved by another thread, but not yet committed
+            break;
+        }
+        sent = ccnl->ccnl_ll_TXv_ptr(ccnl, ifc, reqs, cnt);
+        DEBUGMSG_CORE(TRACE, "interface_flush interface=%p, %d of %d sent\n",
+                      (void*)ifc, sent, cnt);
+        if (sent <= 0) {
+            break;
+        }
+#ifdef USE_STATS
+        ifc->tx_cnt += (uint32_t) sent;
+#endif
+        while (sent-- > 0) {
+            struct ccnl_txrequest_s *r = ccnl_interface_qpeek(ifc, 0);
+            ccnl_buf_free(r->buf);
+            r->buf = NULL;
+            ccnl_interface_qrelease(ifc);
+        }
+    }
 }
 
 int
@@ -1014,7 +1290,7 @@ ccnl_cs_add(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
 
     content = ccnl_content_add2cache(ccnl, c);
     if (content) {
-        ccnl_content_serve_pending(ccnl, content);
+        ccnl_content_serve_pending(ccnl, NULL, content);
         return 0;
     }
 
@@ -0,0 +1,164 @@
+/*
+ * @f ccnl-ring.c
+ * @b CCN lite (CCNL), lock-free message rings
+ *
+ * Copyright (C) 2011-17, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#if !defined(CCNL_LINUXKERNEL) && !defined(CCNL_ARDUINO)
+
+#include <stdlib.h>
+#include <string.h>
+#include "ccnl-ring.h"
+
+// a slot: its sequence number, then the element
+//
+// The sequence number of slot k starts at k. A producer may fill the slot
+// for position p when it reads p, the consumer may read it when it reads
+// p + 1, and releasing it sets p + depth: the position of the next round.
+struct ccnl_ring_slot_s {
+    _Atomic uint32_t seq;
+    uint32_t pos;               // position the slot was reserved for
+};
+
+#define CCNL_RING_HDR           ((sizeof(struct ccnl_ring_slot_s) + 15) & ~(size_t) 15)
+#define CCNL_RING_SLOT(r, pos)  ((struct ccnl_ring_slot_s *) \
+                                 ((r)->slots + ((pos) & ((r)->depth - 1)) * (r)->stride))
+
+int
+ccnl_ring_init(struct ccnl_ring_s *r, uint32_t depth, size_t elemsize)
+{
+    uint32_t size = 2, k;
+
+    if (depth < 1 || depth > CCNL_RING_MAX_DEPTH || elemsize < 1) {
+        return -1;
+    }
+    while (size < depth) {
+        size <<= 1;
+    }
+    memset(r, 0, sizeof(*r));
+    r->stride = (CCNL_RING_HDR + elemsize + CCNL_RING_CACHELINE - 1) &
+                ~(size_t) (CCNL_RING_CACHELINE - 1);
+    r->slots = (uint8_t *) aligned_alloc(CCNL_RING_CACHELINE, size * r->stride);
+    if (!r->slots) {
+        return -1;
+    }
+    r->depth = size;
+    for (k = 0; k < size; k++) {
+        atomic_init(&CCNL_RING_SLOT(r, k)->seq, k);
+    }
+    atomic_init(&r->head, 0);
+    atomic_init(&r->tail, 0);
+    atomic_init(&r->drops, 0);
+    atomic_init(&r->highwater, 0);
+    return 0;
+}
+
+void
+ccnl_ring_cleanup(struct ccnl_ring_s *r)
+{
+    free(r->slots);
+    r->slots = NULL;
+    r->depth = 0;
+}
+
+void*
+ccnl_ring_reserve(struct ccnl_ring_s *r)
+{
+    struct ccnl_ring_slot_s *slot;
+    uint32_t pos, seq, cnt, high;
+
+    pos = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    for (;;) {
+        slot = CCNL_RING_SLOT(r, pos);
+        seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        if ((int32_t) (seq - pos) == 0) {
+            if (atomic_compare_exchange_weak_explicit(&r->tail, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                break;
+            }
+        } else if ((int32_t) (seq - pos) < 0) { // not yet released: full
+            atomic_fetch_add_explicit(&r->drops, 1, memory_order_relaxed);
+            return NULL;
+        } else { // reserved by another producer
+            pos = atomic_load_explicit(&r->tail, memory_order_relaxed);
+        }
+    }
+    slot->pos = pos;
+
+    cnt = pos + 1 - atomic_load_explicit(&r->head, memory_order_relaxed);
+    high = atomic_load_explicit(&r->highwater, memory_order_relaxed);
+    while (cnt > high && cnt <= r->depth &&
+           !atomic_compare_exchange_weak_explicit(&r->highwater, &high, cnt,
+                                                  memory_order_relaxed,
+                                                  memory_order_relaxed));
+
+    return (uint8_t *) slot + CCNL_RING_HDR;
+}
+
+void
+ccnl_ring_commit(struct ccnl_ring_s *r, void *elem)
+{
+    struct ccnl_ring_slot_s *slot;
+
+    (void) r;
+    slot = (struct ccnl_ring_slot_s *) ((uint8_t *) elem - CCNL_RING_HDR);
+    atomic_store_explicit(&slot->seq, slot->pos + 1, memory_order_release);
+}
+
+void*
+ccnl_ring_peek(struct ccnl_ring_s *r)
+{
+    return ccnl_ring_peek_nth(r, 0);
+}
+
+void*
+ccnl_ring_peek_nth(struct ccnl_ring_s *r, uint32_t n)
+{
+    uint32_t pos = atomic_load_explicit(&r->head, memory_order_relaxed) + n;
+    struct ccnl_ring_slot_s *slot;
+
+    if (n >= r->depth) {
+        return NULL;
+    }
+    slot = CCNL_RING_SLOT(r, pos);
+    if (atomic_load_explicit(&slot->seq, memory_order_acquire) != pos + 1) {
+        return NULL;
+    }
+    return (uint8_t *) slot + CCNL_RING_HDR;
+}
+
+void
+ccnl_ring_release(struct ccnl_ring_s *r)
+{
+    uint32_t pos = atomic_load_explicit(&r->head, memory_order_relaxed);
+    struct ccnl_ring_slot_s *slot = CCNL_RING_SLOT(r, pos);
+
+    atomic_store_explicit(&slot->seq, pos + r->depth, memory_order_release);
+    atomic_store_explicit(&r->head, pos + 1, memory_order_relaxed);
+}
+
+uint32_t
+ccnl_ring_count(struct ccnl_ring_s *r)
+{
+    return atomic_load_explicit(&r->tail, memory_order_relaxed) -
+           atomic_load_explicit(&r->head, memory_order_relaxed);
+}
+
+#endif // !CCNL_LINUXKERNEL && !CCNL_ARDUINO
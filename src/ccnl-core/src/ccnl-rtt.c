@@ -0,0 +1,84 @@
+/*
+ * @f ccnl-rtt.c
+ * @b CCN lite (CCNL), RTT and RTO estimation
+ *
+ * Copyright (C) 2011-17, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifndef CCNL_LINUXKERNEL
+#include "ccnl-rtt.h"
+#include "ccnl-os-time.h"
+#else
+#include "../include/ccnl-rtt.h"
+#include "../include/ccnl-os-time.h"
+#endif
+
+// granularity of the clock, the lower bound of the variation term
+#define CCNL_RTT_CLOCK_G        1
+
+uint32_t
+ccnl_rtt_now(void)
+{
+    struct timeval tv;
+
+    ccnl_get_timeval(&tv);
+    return (uint32_t) tv.tv_sec * 1000 + (uint32_t) tv.tv_usec / 1000;
+}
+
+void
+ccnl_rtt_sample(struct ccnl_rtt_s *r, uint32_t rtt)
+{
+    uint32_t k;
+
+    if (!r->samples) {
+        r->srtt = rtt;
+        r->rttvar = rtt / 2;
+    } else {
+        // alpha = 1/8, beta = 1/4
+        uint32_t delta = r->srtt > rtt ? r->srtt - rtt : rtt - r->srtt;
+        r->rttvar = r->rttvar - r->rttvar / 4 + delta / 4;
+        r->srtt = r->srtt - r->srtt / 8 + rtt / 8;
+    }
+    r->samples++;
+
+    k = 4 * r->rttvar;
+    if (k < CCNL_RTT_CLOCK_G) {
+        k = CCNL_RTT_CLOCK_G;
+    }
+    r->rto = r->srtt + k;
+    if (r->rto < CCNL_RTO_MIN) {
+        r->rto = CCNL_RTO_MIN;
+    } else if (r->rto > CCNL_RTO_MAX) {
+        r->rto = CCNL_RTO_MAX;
+    }
+}
+
+uint32_t
+ccnl_rtt_rto(const struct ccnl_rtt_s *r)
+{
+    return r && r->samples ? r->rto : CCNL_RTO_INITIAL;
+}
+
+uint32_t
+ccnl_rtt_backoff(uint32_t rto, int retries)
+{
+    while (retries-- > 0 && rto < CCNL_RTO_MAX) {
+        rto *= 2;
+    }
+    return rto < CCNL_RTO_MAX ? rto : CCNL_RTO_MAX;
+}
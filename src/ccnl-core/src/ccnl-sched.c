@@ -423,6 +423,7 @@ static void ccnl_sched_cf_timeout(void *aux1, void *aux2)
 {
     DEBUGMSG(TRACE, "%s()\n", __func__);
 
+    engine_timer = NULL; // the handle is gone once the timer fired
     cf_engine_execute_pending_reactions_and_set_timer(engine, ccnl_cf_now());
 }
 
@@ -0,0 +1,194 @@
+/*
+ * @f ccnl-strategy.c
+ * @b CCN lite (CCNL), forwarding strategies
+ *
+ * Copyright (C) 2011-17, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifndef CCNL_LINUXKERNEL
+#include <string.h>
+#include "ccnl-strategy.h"
+#include "ccnl-forward.h"
+#include "ccnl-interest.h"
+#include "ccnl-relay.h"
+#else
+#include "../include/ccnl-strategy.h"
+#include "../include/ccnl-forward.h"
+#include "../include/ccnl-interest.h"
+#include "../include/ccnl-relay.h"
+#endif
+
+static int
+ccnl_strategy_multicast(struct ccnl_relay_s *relay, struct ccnl_interest_s *i,
+                        struct ccnl_forward_s **nh, int cnt)
+{
+    (void) relay;
+    (void) i;
+    (void) nh;
+    return cnt;
+}
+
+static uint32_t
+ccnl_strategy_rto(struct ccnl_forward_s *fwd)
+{
+    return ccnl_rtt_rto(fwd->face ? &fwd->face->perf.rtt : NULL);
+}
+
+static void
+ccnl_strategy_to_front(struct ccnl_forward_s **nh, int k)
+{
+    struct ccnl_forward_s *fwd = nh[k];
+
+    nh[k] = nh[0];
+    nh[0] = fwd;
+}
+
+static int
+ccnl_strategy_best_route(struct ccnl_relay_s *relay, struct ccnl_interest_s *i,
+                         struct ccnl_forward_s **nh, int cnt)
+{
+    int k, j;
+    (void) relay;
+
+    // by RTO, stable: there are few next hops
+    for (k = 1; k < cnt; k++) {
+        struct ccnl_forward_s *fwd = nh[k];
+        for (j = k; j > 0 && ccnl_strategy_rto(nh[j - 1]) > ccnl_strategy_rto(fwd); j--) {
+            nh[j] = nh[j - 1];
+        }
+        nh[j] = fwd;
+    }
+    // the best next hop did not answer: try the next one
+    ccnl_strategy_to_front(nh, i->retries % cnt);
+    return 1;
+}
+
+static int
+ccnl_strategy_round_robin(struct ccnl_relay_s *relay, struct ccnl_interest_s *i,
+                          struct ccnl_forward_s **nh, int cnt)
+{
+    int k, best = 0;
+    (void) relay;
+    (void) i;
+
+    for (k = 1; k < cnt; k++) {
+        if (nh[k]->uses < nh[best]->uses) {
+            best = k;
+        }
+    }
+    ccnl_strategy_to_front(nh, best);
+    return 1;
+}
+
+// smooth weighted round robin: each next hop gains its weight, the one
+// with the most credit is chosen and pays the sum of the weights
+static int
+ccnl_strategy_weighted(struct ccnl_relay_s *relay, struct ccnl_interest_s *i,
+                       struct ccnl_forward_s **nh, int cnt)
+{
+    int32_t total = 0;
+    int k, best = 0;
+    (void) relay;
+    (void) i;
+
+    for (k = 0; k < cnt; k++) {
+        int32_t weight = (int32_t) (1000000 / ccnl_strategy_rto(nh[k]));
+        nh[k]->credit += weight;
+        total += weight;
+        if (nh[k]->credit > nh[best]->credit) {
+            best = k;
+        }
+    }
+    nh[best]->credit -= total;
+    ccnl_strategy_to_front(nh, best);
+    return 1;
+}
+
+static struct ccnl_strategy_s ccnl_strategies[CCNL_MAX_STRATEGIES] = {
+    { "multicast", ccnl_strategy_multicast },
+    { "best-route", ccnl_strategy_best_route },
+    { "round-robin", ccnl_strategy_round_robin },
+    { "weighted", ccnl_strategy_weighted },
+};
+
+const struct ccnl_strategy_s*
+ccnl_strategy_register(const char *name, ccnl_strategy_func choose)
+{
+    int k;
+
+    if (!name || !choose || ccnl_strategy_find(name)) {
+        return NULL;
+    }
+    for (k = 0; k < CCNL_MAX_STRATEGIES; k++) {
+        if (!ccnl_strategies[k].name) {
+            ccnl_strategies[k].name = name;
+            ccnl_strategies[k].choose = choose;
+            return ccnl_strategies + k;
+        }
+    }
+    return NULL;
+}
+
+const struct ccnl_strategy_s*
+ccnl_strategy_find(const char *name)
+{
+    int k;
+
+    for (k = 0; k < CCNL_MAX_STRATEGIES && ccnl_strategies[k].name; k++) {
+        if (!strcmp(ccnl_strategies[k].name, name)) {
+            return ccnl_strategies + k;
+        }
+    }
+    return NULL;
+}
+
+int
+ccnl_fib_set_strategy(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx,
+                      const struct ccnl_strategy_s *strategy)
+{
+    struct ccnl_forward_s *fwd;
+    int rc = -1;
+
+    for (fwd = ccnl_fib_lookup(relay, pfx, pfx->compcnt, NULL); fwd;
+         fwd = ccnl_fib_lookup(relay, pfx, pfx->compcnt, fwd)) {
+        fwd->strategy = strategy;
+        rc = 0;
+    }
+    if (!rc) {
+        relay->fib_version++;
+    }
+    return rc;
+}
+
+int
+ccnl_strategy_choose(struct ccnl_relay_s *relay,
+                     const struct ccnl_strategy_s *strategy,
+                     struct ccnl_interest_s *i,
+                     struct ccnl_forward_s **nh, int cnt)
+{
+    int n;
+
+    if (!strategy) {
+        strategy = relay->strategy ? relay->strategy : ccnl_strategies;
+    }
+    n = strategy->choose(relay, i, nh, cnt);
+    if (n < 0) {
+        return 0;
+    }
+    return n < cnt ? n : cnt;
+}
@@ -76,6 +76,10 @@ ccnl_fwd_handleContent(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
 
     }
 
+    if (relay->ccnl_handoff_ptr && relay->ccnl_handoff_ptr(relay, from, *pkt)) {
+        return 0;
+    }
+
 #if defined(USE_SUITE_CCNB) && defined(USE_SIGNATURES)
 //  FIXME: mgmt messages for NDN and other suites?
         if (pkt->pfx->compcnt == 2 && !memcmp(pkt->pfx->comp[0], "ccnx", 4)
@@ -84,6 +88,10 @@ ccnl_fwd_handleContent(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
             return ccnl_crypto(relay, pkt->buf, pkt->pfx, from);
         }
 #endif /* USE_SUITE_CCNB && USE_SIGNATURES*/
+    // the callback may keep the packet, and so may the content store
+    if (ccnl_pkt_own(pkt)) {
+        return 0;
+    }
 #ifndef CCNL_LINUXKERNEL
     if (ccnl_callback_rx_on_data(relay, from, *pkt)) {
         *pkt = NULL;
@@ -92,7 +100,8 @@ ccnl_fwd_handleContent(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
 #endif
 
     // CONFORM: Step 1:
-    for (c = relay->contents; c; c = c->next) {
+    for (c = ccnl_content_lookup(relay, (*pkt)->pfx, (*pkt)->pfx->compcnt, NULL);
+         c; c = ccnl_content_lookup(relay, (*pkt)->pfx, (*pkt)->pfx->compcnt, c)) {
         if (ccnl_prefix_cmp(c->pkt->pfx, NULL, (*pkt)->pfx, CMP_EXACT) == 0) {
             DEBUGMSG_CFWD(TRACE, "  content is duplicate, ignoring\n");
             return 0; // content is dup, do nothing
@@ -104,23 +113,13 @@ ccnl_fwd_handleContent(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
         return 0;
     }
 
-    if (!ccnl_content_serve_pending(relay, c)) { // unsolicited content
+    if (!ccnl_content_serve_pending(relay, from, c)) { // unsolicited content
         // CONFORM: "A node MUST NOT forward unsolicited data [...]"
         DEBUGMSG_CFWD(DEBUG, "  removed because no matching interest\n");
         ccnl_content_free(c);
         return 0;
     }
 
-    if (relay->max_cache_entries != 0 && cache_strategy_cache(relay,c)) {
-        DEBUGMSG_CFWD(DEBUG, "  adding content to cache\n");
-        ccnl_content_add2cache(relay, c);
-        int contlen = (int) (c->pkt->contlen > INT_MAX ? INT_MAX : c->pkt->contlen);
-        DEBUGMSG_CFWD(INFO, "data after creating packet %.*s\n", contlen, c->pkt->content);
-    } else {
-        DEBUGMSG_CFWD(DEBUG, "  content not added to cache\n");
-        ccnl_content_free(c);
-    }
-
 #ifdef USE_RONR
     /* if we receive a chunk, we assume more chunks of this content may be
      * retrieved along the same path */
@@ -132,6 +131,20 @@ ccnl_fwd_handleContent(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
         ccnl_fib_add_entry(relay, pfx_wo_chunk, from);
     }
 #endif
+
+    if (relay->max_cache_entries != 0 && cache_strategy_cache(relay,c)) {
+        DEBUGMSG_CFWD(DEBUG, "  adding content to cache\n");
+        if (!ccnl_content_add2cache(relay, c)) {
+            ccnl_content_free(c);
+            return 0;
+        }
+        int contlen = (int) (c->pkt->contlen > INT_MAX ? INT_MAX : c->pkt->contlen);
+        DEBUGMSG_CFWD(INFO, "data after creating packet %.*s\n", contlen, c->pkt->content);
+    } else {
+        DEBUGMSG_CFWD(DEBUG, "  content not added to cache\n");
+        ccnl_content_free(c);
+    }
+
     return 0;
 }
 
@@ -148,7 +161,7 @@ ccnl_fwd_handleFragment(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
         char *from_as_str = ccnl_addr2ascii(&(from->peer));
 
         DEBUGMSG_CFWD(INFO, "  incoming fragment (%zd bytes) from=%s\n", 
-            (*pkt)->buf->datalen, from_as_str ? from_as_str : "");
+            (*pkt)->contlen, from_as_str ? from_as_str : "");
     }
 
     ccnl_frag_RX_BeginEnd2015(callback, relay, from,
@@ -179,12 +192,49 @@ ccnl_pkt_fwdOK(struct ccnl_pkt_s *pkt)
     return -1;
 }
 
+// serves an Interest from the content store: returns 1 if it matched
+static int
+ccnl_fwd_serveFromCS(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+                     struct ccnl_pkt_s *pkt, cMatchFct cMatch)
+{
+    struct ccnl_content_s *c;
+    uint32_t k;
+
+    // the matching functions accept content named like the interest, or
+    // like the interest without its last component (implicit digest)
+    for (k = 0; k < 2 && k <= pkt->pfx->compcnt; k++) {
+        uint32_t compcnt = pkt->pfx->compcnt - k;
+
+        for (c = ccnl_content_lookup(relay, pkt->pfx, compcnt, NULL);
+             c; c = ccnl_content_lookup(relay, pkt->pfx, compcnt, c)) {
+            if (cMatch(pkt, c))
+                continue;
+
+            DEBUGMSG_CFWD(DEBUG, "  found matching content %p\n", (void *) c);
+            ccnl_cs_policy_hit(relay, c);
+
+            if (from) {
+                if (from->ifndx >= 0) {
+                    ccnl_send_pkt(relay, from, c->pkt);
+                } else {
+#ifdef CCNL_APP_RX 
+                    ccnl_app_RX(relay, c);
+#endif 
+                }
+            }
+
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
 int
 ccnl_fwd_handleInterest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
                         struct ccnl_pkt_s **pkt, cMatchFct cMatch)
 {
     struct ccnl_interest_s *i;
-    struct ccnl_content_s *c;
     int propagate= 0;
     char s[CCNL_MAX_PREFIX_SIZE];
     (void) s;
@@ -210,6 +260,10 @@ ccnl_fwd_handleInterest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
 #endif
     }
 
+    if (relay->ccnl_handoff_ptr && relay->ccnl_handoff_ptr(relay, from, *pkt)) {
+        return 0;
+    }
+
 #ifdef USE_DUP_CHECK
 
     if (ccnl_nonce_isDup(relay, *pkt)) {
@@ -230,6 +284,9 @@ ccnl_fwd_handleInterest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
     if ((*pkt)->suite == CCNL_SUITE_CCNB && (*pkt)->pfx->compcnt == 4 &&
                                   !memcmp((*pkt)->pfx->comp[0], "ccnx", 4)) {
         DEBUGMSG_CFWD(INFO, "  found a mgmt message\n");
+        if (ccnl_pkt_own(pkt)) {
+            return 0;
+        }
         ccnl_mgmt(relay, (*pkt)->buf, (*pkt)->pfx, from); // use return value? // TODO uncomment
         return 0;
     }
@@ -240,6 +297,9 @@ ccnl_fwd_handleInterest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
         !memcmp((*pkt)->pfx->comp[0], "ccnx", 4)) {
         DEBUGMSG_CFWD(INFO, "  found a mgmt message\n");
 #ifdef USE_MGMT
+        if (ccnl_pkt_own(pkt)) {
+            return 0;
+        }
         ccnl_mgmt(relay, (*pkt)->buf, (*pkt)->pfx, from); // use return value?
 #endif
         return 0;
@@ -248,32 +308,21 @@ ccnl_fwd_handleInterest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
 
             // Step 1: search in content store
     DEBUGMSG_CFWD(DEBUG, "  searching in CS\n");
-
-    for (c = relay->contents; c; c = c->next) {
-        if (c->pkt->pfx->suite != (*pkt)->pfx->suite)
-            continue;
-        if (cMatch(*pkt, c))
-            continue;
-
-        DEBUGMSG_CFWD(DEBUG, "  found matching content %p\n", (void *) c);
-
-        if (from) {
-            if (from->ifndx >= 0) {
-                ccnl_send_pkt(relay, from, c->pkt);
-            } else {
-#ifdef CCNL_APP_RX 
-                ccnl_app_RX(relay, c);
-#endif 
-            }
-        }
-
+    relay->cs_stats.lookups++;
+    ccnl_cs_admission_record(relay, (*pkt)->pfx);
+    if (ccnl_fwd_serveFromCS(relay, from, *pkt, cMatch)) {
+        relay->cs_stats.hits++;
         return 0; // we are done
     }
+    // the content store may be the hot part of a larger one
+    if (relay->ccnl_cs_load_ptr && relay->ccnl_cs_load_ptr(relay, *pkt) > 0 &&
+        ccnl_fwd_serveFromCS(relay, from, *pkt, cMatch)) {
+        relay->cs_stats.store_hits++;
+        return 0;
+    }
 
     // CONFORM: Step 2: check whether interest is already known
-    for (i = relay->pit; i; i = i->next)
-        if (ccnl_interest_isSame(i, *pkt))
-            break;
+    i = ccnl_interest_find(relay, *pkt);
 
     if (!i) { // this is a new/unknown I request: create and propagate
         propagate = 1;
@@ -411,7 +460,8 @@ ccnl_ccntlv_forwarder(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
     size_t hdrlen;
     struct ccnx_tlvhdr_ccnx2015_s *hp;
     uint8_t *start = *data;
-    struct ccnl_pkt_s *pkt;
+    struct ccnl_pkt_view_s view;
+    struct ccnl_pkt_s *pkt = NULL;
 
     DEBUGMSG_CFWD(DEBUG, "ccnl_ccntlv_forwarder: %zuB from face=%p (id=%d.%d)\n",
                   *datalen, (void*)from, relay->id, from ? from->faceid : -1);
@@ -494,11 +544,12 @@ ccnl_ccntlv_forwarder(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
         DEBUGMSG_CFWD(TRACE, "  local data, datalen=%zu\n", *datalen);
     }
 
-    pkt = ccnl_ccntlv_bytes2pkt(start, data, datalen);
-    if (!pkt) {
+    // decoded in place, the packet is copied only if it is kept
+    if (ccnl_ccntlv_bytes2view(start, data, datalen, &view)) {
         DEBUGMSG_CFWD(WARNING, "  parsing error or no prefix\n");
         goto Done;
     }
+    pkt = &view.pkt;
     if (!from) {
         DEBUGMSG_CFWD(TRACE, "  pkt ok\n");
 //        goto Done;
@@ -547,7 +598,8 @@ ccnl_ndntlv_forwarder(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
     size_t len;
     uint64_t typ;
     unsigned char *start = *data;
-    struct ccnl_pkt_s *pkt;
+    struct ccnl_pkt_view_s view;
+    struct ccnl_pkt_s *pkt = NULL;
 
     DEBUGMSG_CFWD(DEBUG, "ccnl_ndntlv_forwarder (%zu bytes left)\n", *datalen);
 
@@ -555,11 +607,12 @@ ccnl_ndntlv_forwarder(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
         DEBUGMSG_CFWD(TRACE, "  invalid packet format\n");
         return -1;
     }
-    pkt = ccnl_ndntlv_bytes2pkt(typ, start, data, datalen);
-    if (!pkt) {
+    // decoded in place, the packet is copied only if it is kept
+    if (ccnl_ndntlv_bytes2view(typ, start, data, datalen, &view)) {
         DEBUGMSG_CFWD(INFO, "  ndntlv packet coding problem\n");
         goto Done;
     }
+    pkt = &view.pkt;
     pkt->type = typ;
     switch (typ) {
     case NDN_TLV_Interest:
@@ -598,7 +651,7 @@ int
 ccnl_set_tap(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx,
              tapCallback callback)
 {
-    struct ccnl_forward_s *fwd, **fwd2;
+    struct ccnl_forward_s *fwd;
     char s[CCNL_MAX_PREFIX_SIZE];
     (void) s;
 
@@ -606,25 +659,23 @@ ccnl_set_tap(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx,
              ccnl_prefix_to_str(pfx,s,CCNL_MAX_PREFIX_SIZE),
              ccnl_suite2str(pfx->suite));
 
-    for (fwd = relay->fib; fwd; fwd = fwd->next) {
-        if (fwd->suite == pfx->suite &&
-                        !ccnl_prefix_cmp(fwd->prefix, NULL, pfx, CMP_EXACT)) {
+    fwd = ccnl_fib_lookup(relay, pfx, pfx->compcnt, NULL);
+    if (fwd) {
+        if (fwd->prefix != pfx) {
             ccnl_prefix_free(fwd->prefix);
-            fwd->prefix = NULL;
-            break;
+            fwd->prefix = pfx;
         }
-    }
-    if (!fwd) {
+    } else {
         fwd = (struct ccnl_forward_s *) ccnl_calloc(1, sizeof(*fwd));
         if (!fwd)
             return -1;
-        fwd2 = &relay->fib;
-        while (*fwd2)
-            fwd2 = &((*fwd2)->next);
-        *fwd2 = fwd;
         fwd->suite = pfx->suite;
+        fwd->prefix = pfx;
+        if (ccnl_fib_link(relay, fwd)) {
+            ccnl_free(fwd);
+            return -1;
+        }
     }
-    fwd->prefix = pfx;
     fwd->tap = callback;
     return 0;
 }
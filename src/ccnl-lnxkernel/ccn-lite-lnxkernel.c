@@ -121,6 +121,13 @@ kfree(ptr);
 #include "../../ccnl-core/src/ccnl-logging.c"
 #include "../../ccnl-core/src/ccnl-os-time.c"
 #include "../../ccnl-core/src/ccnl-prefix.c"
+#include "../../ccnl-core/src/ccnl-htable.c"
+#include "../../ccnl-core/src/ccnl-pool.c"
+#include "../../ccnl-core/src/ccnl-nonce.c"
+#include "../../ccnl-core/src/ccnl-ageing.c"
+#include "../../ccnl-core/src/ccnl-rtt.c"
+#include "../../ccnl-core/src/ccnl-strategy.c"
+#include "../../ccnl-core/src/ccnl-cs-policy.c"
 #include "../../ccnl-core/src/ccnl-relay.c"
 #include "../../ccnl-core/src/ccnl-sched.c"
 #include "../../ccnl-core/src/ccnl-interest.c"
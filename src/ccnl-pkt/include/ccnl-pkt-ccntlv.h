@@ -182,6 +182,22 @@ int8_t
 ccnl_ccntlv_dehead(uint8_t **buf, size_t *len,
                    uint16_t *typ, size_t *vallen);
 
+/**
+ * Decodes a CCNx packet in place, without allocating memory
+ * @param start first byte of the packet (fixed header)
+ * @param data position of the message, after the hop-by-hop headers, advanced
+ * @param datalen number of bytes left at data, reduced
+ * @param view storage for the decoded packet, view->pkt is the packet
+ * @return 0 on success, -1 on failure.
+ */
+int8_t
+ccnl_ccntlv_bytes2view(uint8_t *start, uint8_t **data, size_t *datalen,
+                       struct ccnl_pkt_view_s *view);
+
+/**
+ * Decodes a CCNx packet into an allocated packet, see ccnl_ccntlv_bytes2view()
+ * @return the packet, NULL on failure.
+ */
 struct ccnl_pkt_s*
 ccnl_ccntlv_bytes2pkt(uint8_t *start, uint8_t **data, size_t *datalen);
 
@@ -170,6 +170,26 @@ int8_t
 ccnl_ndntlv_dehead(uint8_t **buf, size_t *len,
                    uint64_t *typ, size_t *vallen);
 
+struct ccnl_pkt_view_s;
+
+/**
+ * Decodes an NDN packet in place, without allocating memory
+ * @param pkttype outermost type of the packet, its TL is already consumed
+ * @param start first byte of the packet
+ * @param data position of the value of the outermost TLV, advanced
+ * @param datalen number of bytes left at data, reduced
+ * @param view storage for the decoded packet, view->pkt is the packet
+ * @return 0 on success, -1 on failure.
+ */
+int8_t
+ccnl_ndntlv_bytes2view(uint64_t pkttype, uint8_t *start,
+                       uint8_t **data, size_t *datalen,
+                       struct ccnl_pkt_view_s *view);
+
+/**
+ * Decodes an NDN packet into an allocated packet, see ccnl_ndntlv_bytes2view()
+ * @return the packet, NULL on failure.
+ */
 struct ccnl_pkt_s*
 ccnl_ndntlv_bytes2pkt(uint64_t pkttype, uint8_t *start,
                       uint8_t **data, size_t *datalen);
@@ -147,7 +147,7 @@ ccnl_ccnb_bytes2pkt(uint8_t *start, uint8_t **data, size_t *datalen)
     DEBUGMSG(TRACE, "ccnl_ccnb_extract\n");
 
     //pkt = (struct ccnl_pkt_s *) ccnl_calloc(1, sizeof(*pkt));
-    pkt = (struct ccnl_pkt_s *) ccnl_calloc(1, sizeof(*pkt));
+    pkt = (struct ccnl_pkt_s *) ccnl_pool_alloc(&ccnl_pool_pkt);
     if (!pkt) {
         return NULL;
     }
@@ -159,7 +159,7 @@ ccnl_ccnb_bytes2pkt(uint8_t *start, uint8_t **data, size_t *datalen)
 
     pkt->pfx = p = ccnl_prefix_new(CCNL_SUITE_CCNB, CCNL_MAX_NAME_COMP);
     if (!p) {
-        ccnl_free(pkt);
+        ccnl_pool_free(pkt);
         return NULL;
     }
     p->compcnt = 0;
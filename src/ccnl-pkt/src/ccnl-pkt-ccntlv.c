@@ -111,12 +111,12 @@ ccnl_ccntlv_dehead(uint8_t **buf, size_t *len,
 
 // We use one extraction procedure for both interest and data pkts.
 // This proc assumes that the packet header was already processed and consumed
-struct ccnl_pkt_s*
-ccnl_ccntlv_bytes2pkt(uint8_t *start, uint8_t **data, size_t *datalen)
+int8_t
+ccnl_ccntlv_bytes2view(uint8_t *start, uint8_t **data, size_t *datalen,
+                       struct ccnl_pkt_view_s *view)
 {
-    struct ccnl_pkt_s *pkt;
-    struct ccnl_prefix_s *p;
-    uint32_t i;
+    struct ccnl_pkt_s *pkt = &view->pkt;
+    struct ccnl_prefix_s *p = &view->pfx;
     size_t len;
     size_t oldpos;
     uint16_t typ;
@@ -124,19 +124,11 @@ ccnl_ccntlv_bytes2pkt(uint8_t *start, uint8_t **data, size_t *datalen)
     uint8_t validAlgoIsHmac256 = 0;
 #endif
 
-    DEBUGMSG_PCNX(TRACE, "ccnl_ccntlv_bytes2pkt len=%zu\n", *datalen);
+    DEBUGMSG_PCNX(TRACE, "ccnl_ccntlv_bytes2view len=%zu\n", *datalen);
 
-    pkt = (struct ccnl_pkt_s*) ccnl_calloc(1, sizeof(*pkt));
-    if (!pkt) {
-        return NULL;
-    }
-
-    pkt->pfx = p = ccnl_prefix_new(CCNL_SUITE_CCNTLV, CCNL_MAX_NAME_COMP);
-    if (!p) {
-        ccnl_free(pkt);
-        return NULL;
-    }
-    p->compcnt = 0;
+    // a packet without a name has an empty prefix
+    ccnl_pkt_view_init(view, CCNL_SUITE_CCNTLV);
+    pkt->pfx = p;
 
 #ifdef USE_HMAC256
     pkt->hmacStart = *data;
@@ -145,11 +137,10 @@ ccnl_ccntlv_bytes2pkt(uint8_t *start, uint8_t **data, size_t *datalen)
     // content and interests are filled in both cases (and only one exists).
     // Validation info is now collected
     if (ccnl_ccntlv_dehead(data, datalen, &typ, &len) || len > *datalen) {
-        goto Bail;
+        return -1;
     }
 
     pkt->type = typ;
-    pkt->suite = CCNL_SUITE_CCNTLV;
     pkt->val.final_block_id = -1;
 
     // XXX this parsing is not safe for all input data - needs more bound
@@ -161,7 +152,7 @@ ccnl_ccntlv_bytes2pkt(uint8_t *start, uint8_t **data, size_t *datalen)
         size_t len3;
 
         if (len > *datalen) {
-            goto Bail;
+            return -1;
         }
         switch (typ) {
         case CCNX_TLV_M_Name:
@@ -169,7 +160,7 @@ ccnl_ccntlv_bytes2pkt(uint8_t *start, uint8_t **data, size_t *datalen)
             while (len2 > 0) {
                 cp2 = cp;
                 if (ccnl_ccntlv_dehead(&cp, &len2, &typ, &len3) || len>*datalen) {
-                    goto Bail;
+                    return -1;
                 }
 
                 switch (typ) {
@@ -179,11 +170,10 @@ ccnl_ccntlv_bytes2pkt(uint8_t *start, uint8_t **data, size_t *datalen)
                     // possibly want to remove the chunk segment from the
                     // name components and rely on the chunknum field in
                     // the prefix.
-                  p->chunknum = (uint32_t *) ccnl_malloc(sizeof(uint32_t));
-
+                    p->chunknum = &view->chunknum;
                     if (ccnl_ccnltv_extractNetworkVarInt(cp, len3, p->chunknum) < 0) {
                         DEBUGMSG_PCNX(WARNING, "Error in NetworkVarInt for chunk\n");
-                        goto Bail;
+                        return -1;
                     }
                     if (p->compcnt < CCNL_MAX_NAME_COMP) {
                         p->comp[p->compcnt] = cp2;
@@ -201,7 +191,7 @@ ccnl_ccntlv_bytes2pkt(uint8_t *start, uint8_t **data, size_t *datalen)
                 case CCNX_TLV_N_Meta:
                     if (ccnl_ccntlv_dehead(&cp, &len2, &typ, &len3) || len > *datalen) {
                         DEBUGMSG_PCNX(WARNING, "error when extracting CCNX_TLV_M_MetaData\n");
-                        goto Bail;
+                        return -1;
                     }
                     break;
                 default:
@@ -216,7 +206,7 @@ ccnl_ccntlv_bytes2pkt(uint8_t *start, uint8_t **data, size_t *datalen)
             uint32_t final_block_id;
             if (ccnl_ccnltv_extractNetworkVarInt(cp, len, &final_block_id) < 0) {
                 DEBUGMSG_PCNX(WARNING, "error when extracting CCNX_TLV_M_ENDChunk\n");
-                goto Bail;
+                return -1;
             }
             pkt->val.final_block_id = final_block_id;
             break;
@@ -230,7 +220,7 @@ ccnl_ccntlv_bytes2pkt(uint8_t *start, uint8_t **data, size_t *datalen)
             cp = *data;
             len2 = len;
             if (ccnl_ccntlv_dehead(&cp, &len2, &typ, &len3) || len > *datalen) {
-                goto Bail;
+                return -1;
             }
             if (typ == CCNX_VALIDALGO_HMAC_SHA256) {
                 // ignore keyId and other algo dependent data ... && len3 == 0)
@@ -252,33 +242,25 @@ ccnl_ccntlv_bytes2pkt(uint8_t *start, uint8_t **data, size_t *datalen)
         oldpos = *data - start;
     }
     if (*datalen > 0) {
-        goto Bail;
+        return -1;
     }
 
-    pkt->pfx = p;
-    pkt->buf = ccnl_buf_new(start, *data - start);
-    if (!pkt->buf) {
-        goto Bail;
-    }
-    // carefully rebase ptrs to new buf because of 64bit pointers:
-    if (pkt->content) {
-        pkt->content = pkt->buf->data + (pkt->content - start);
-    }
-    for (i = 0; i < p->compcnt; i++) {
-        p->comp[i] = pkt->buf->data + (p->comp[i] - start);
-    }
-    if (p->nameptr) {
-        p->nameptr = pkt->buf->data + (p->nameptr - start);
-    }
-#ifdef USE_HMAC256
-    pkt->hmacStart = pkt->buf->data + (pkt->hmacStart - start);
-    pkt->hmacSignature = pkt->buf->data + (pkt->hmacSignature - start);
-#endif
+    view->start = start;
+    view->len = *data - start;
+    return 0;
+}
 
+struct ccnl_pkt_s*
+ccnl_ccntlv_bytes2pkt(uint8_t *start, uint8_t **data, size_t *datalen)
+{
+    struct ccnl_pkt_view_s view;
+    struct ccnl_pkt_s *pkt = &view.pkt;
+
+    if (ccnl_ccntlv_bytes2view(start, data, datalen, &view) ||
+        ccnl_pkt_own(&pkt)) {
+        return NULL;
+    }
     return pkt;
-Bail:
-    ccnl_pkt_free(pkt);
-    return NULL;
 }
 
 // ----------------------------------------------------------------------
@@ -321,9 +303,9 @@ ccnl_ccntlv_prependTL(uint16_t type, size_t len,
     *offset -= 4;
 
     *(buf-1) = (uint8_t) (len & 0xffU);
-    *(buf-2) = (uint8_t) (len & 0xff00U) >> 8U;
+    *(buf-2) = (uint8_t) ((len & 0xff00U) >> 8U);
     *(buf-3) = (uint8_t) (type & 0xffU);
-    *(buf-4) = (uint8_t) (type & 0xff00U) >> 8U;
+    *(buf-4) = (uint8_t) ((type & 0xff00U) >> 8U);
 
     return 0;
 
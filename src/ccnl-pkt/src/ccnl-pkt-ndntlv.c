@@ -105,11 +105,12 @@ ccnl_ndntlv_dehead(uint8_t **buf, size_t *len,
 }
 
 // we use one extraction routine for each of interest, data and fragment pkts
-struct ccnl_pkt_s*
-ccnl_ndntlv_bytes2pkt(uint64_t pkttype, uint8_t *start,
-                      uint8_t **data, size_t *datalen)
+int8_t
+ccnl_ndntlv_bytes2view(uint64_t pkttype, uint8_t *start,
+                       uint8_t **data, size_t *datalen,
+                       struct ccnl_pkt_view_s *view)
 {
-    struct ccnl_pkt_s *pkt;
+    struct ccnl_pkt_s *pkt = &view->pkt;
     size_t oldpos, len, i;
     uint64_t typ;
     struct ccnl_prefix_s *prefix = 0;
@@ -118,12 +119,9 @@ ccnl_ndntlv_bytes2pkt(uint64_t pkttype, uint8_t *start,
 #endif
 
 
-    DEBUGMSG(DEBUG, "ccnl_ndntlv_bytes2pkt len=%zu\n", *datalen);
+    DEBUGMSG(DEBUG, "ccnl_ndntlv_bytes2view len=%zu\n", *datalen);
 
-    pkt = (struct ccnl_pkt_s*) ccnl_calloc(1, sizeof(struct ccnl_pkt_s));
-    if (!pkt) {
-        return NULL;
-    }
+    ccnl_pkt_view_init(view, CCNL_SUITE_NDNTLV);
     pkt->type = pkttype;
 
 #ifdef USE_HMAC256
@@ -143,10 +141,9 @@ ccnl_ndntlv_bytes2pkt(uint64_t pkttype, uint8_t *start,
 #endif
     default:
         DEBUGMSG(INFO, "  ndntlv: unknown packet type %llu\n", (unsigned long long)pkttype);
-        goto Bail;
+        return -1;
     }
 
-    pkt->suite = CCNL_SUITE_NDNTLV;
     pkt->s.ndntlv.scope = 3;
     pkt->s.ndntlv.maxsuffix = CCNL_MAX_NAME_COMP;
 
@@ -162,33 +159,29 @@ ccnl_ndntlv_bytes2pkt(uint64_t pkttype, uint8_t *start,
         case NDN_TLV_Name:
             if (prefix) {
                 DEBUGMSG(WARNING, " ndntlv: name already defined\n");
-                goto Bail;
-            }
-            prefix = ccnl_prefix_new(CCNL_SUITE_NDNTLV, CCNL_MAX_NAME_COMP);
-            if (!prefix) {
-                goto Bail;
+                return -1;
             }
-            prefix->compcnt = 0;
+            prefix = &view->pfx;
             pkt->pfx = prefix;
             pkt->val.final_block_id = -1;
 
             prefix->nameptr = start + oldpos;
             while (len2 > 0) {
                 if (ccnl_ndntlv_dehead(&cp, &len2, &typ, &i)) {
-                    goto Bail;
+                    return -1;
                 }
                 if (typ == NDN_TLV_NameComponent &&
                             prefix->compcnt < CCNL_MAX_NAME_COMP) {
                     if(cp[0] == NDN_Marker_SegmentNumber) {
                         uint64_t chunknum;
-                        prefix->chunknum = (uint32_t *) ccnl_malloc(sizeof(uint32_t));
                         // TODO: requires ccnl_ndntlv_includedNonNegInt which includes the length of the marker
                         // it is implemented for encode, the decode is not yet implemented
                         chunknum = ccnl_ndntlv_nonNegInt(cp + 1, i - 1);
                         if (chunknum > UINT32_MAX) {
-                            goto Bail;
+                            return -1;
                         }
-                        *prefix->chunknum = (uint32_t) chunknum;
+                        view->chunknum = (uint32_t) chunknum;
+                        prefix->chunknum = &view->chunknum;
                     }
                     prefix->comp[prefix->compcnt] = cp;
                     prefix->complen[prefix->compcnt] = i; //FIXME, what if the len value inside the TLV is wrong -> can this lead to overruns inside
@@ -203,7 +196,7 @@ ccnl_ndntlv_bytes2pkt(uint64_t pkttype, uint8_t *start,
         case NDN_TLV_Selectors:
             while (len2 > 0) {
                 if (ccnl_ndntlv_dehead(&cp, &len2, &typ, &i)) {
-                    goto Bail;
+                    return -1;
                 }
                 switch(typ) {
                 case NDN_TLV_MinSuffixComponents:
@@ -227,7 +220,13 @@ ccnl_ndntlv_bytes2pkt(uint64_t pkttype, uint8_t *start,
             }
             break;
         case NDN_TLV_Nonce:
-            pkt->s.ndntlv.nonce = ccnl_buf_new(*data, len);
+            if (len > CCNL_PKT_VIEW_NONCE_LEN) {
+                DEBUGMSG(WARNING, " ndntlv: nonce too long\n");
+                return -1;
+            }
+            view->nonce.buf.datalen = len;
+            memcpy(view->nonce.buf.data, *data, len);
+            pkt->s.ndntlv.nonce = &view->nonce.buf;
             break;
         case NDN_TLV_Scope:
             pkt->s.ndntlv.scope = ccnl_ndntlv_nonNegInt(*data, len);
@@ -240,7 +239,7 @@ ccnl_ndntlv_bytes2pkt(uint64_t pkttype, uint8_t *start,
         case NDN_TLV_MetaInfo:
             while (len2 > 0) {
                 if (ccnl_ndntlv_dehead(&cp, &len2, &typ, &i)) {
-                    goto Bail;
+                    return -1;
                 }
                 if (typ == NDN_TLV_ContentType) {
                     // Not used
@@ -252,13 +251,13 @@ ccnl_ndntlv_bytes2pkt(uint64_t pkttype, uint8_t *start,
                 }
                 if (typ == NDN_TLV_FinalBlockId) {
                     if (ccnl_ndntlv_dehead(&cp, &len2, &typ, &i)) {
-                        goto Bail;
+                        return -1;
                     }
                     if (typ == NDN_TLV_NameComponent) {
                         // TODO: again, includedNonNeg not yet implemented
                         pkt->val.final_block_id = ccnl_ndntlv_nonNegInt(cp + 1, i - 1);
                         if (pkt->val.final_block_id < 0) { // TODO: Is this check ok?
-                            goto Bail;
+                            return -1;
                         }
                     }
                 }
@@ -284,7 +283,7 @@ ccnl_ndntlv_bytes2pkt(uint64_t pkttype, uint8_t *start,
         case NDN_TLV_SignatureInfo:
             while (len2 > 0) {
                 if (ccnl_ndntlv_dehead(&cp, &len2, &typ, &i)) {
-                    goto Bail;
+                    return -1;
                 }
                 if (typ == NDN_TLV_SignatureType && i == 1 &&
                                           *cp == NDN_VAL_SIGTYPE_HMAC256) {
@@ -310,31 +309,26 @@ ccnl_ndntlv_bytes2pkt(uint64_t pkttype, uint8_t *start,
         oldpos = *data - start;
     }
     if (*datalen > 0) {
-        goto Bail;
+        return -1;
     }
 
-    pkt->pfx = prefix;
-    pkt->buf = ccnl_buf_new(start, *data - start);
-    if (!pkt->buf) {
-        goto Bail;
-    }
-    // carefully rebase ptrs to new buf because of 64bit pointers:
-    if (pkt->content) {
-        pkt->content = pkt->buf->data + (pkt->content - start);
-    }
-    if (prefix) {
-        for (i = 0; i < prefix->compcnt; i++) {
-            prefix->comp[i] = pkt->buf->data + (prefix->comp[i] - start);
-        }
-        if (prefix->nameptr) {
-            prefix->nameptr = pkt->buf->data + (prefix->nameptr - start);
-        }
-    }
+    view->start = start;
+    view->len = *data - start;
+    return 0;
+}
 
+struct ccnl_pkt_s*
+ccnl_ndntlv_bytes2pkt(uint64_t pkttype, uint8_t *start,
+                      uint8_t **data, size_t *datalen)
+{
+    struct ccnl_pkt_view_s view;
+    struct ccnl_pkt_s *pkt = &view.pkt;
+
+    if (ccnl_ndntlv_bytes2view(pkttype, start, data, datalen, &view) ||
+        ccnl_pkt_own(&pkt)) {
+        return NULL;
+    }
     return pkt;
-Bail:
-    ccnl_pkt_free(pkt);
-    return NULL;
 }
 
 // ----------------------------------------------------------------------
@@ -354,7 +348,7 @@ ccnl_ndntlv_cMatch(struct ccnl_pkt_s *p, struct ccnl_content_s *c)
         return -1;
     }
 
-    if (p->s.ndntlv.mbf && ((c->flags & CCNL_CONTENT_FLAGS_STALE) != 0)) {
+    if (p->s.ndntlv.mbf && ccnl_content_is_stale(c)) {
         DEBUGMSG(DEBUG, "ignore stale content\n");
         return -1;
     }
@@ -68,6 +68,7 @@
 
 #include "ccn-lite-relay.h"
 #include "ccnl-unix.h"
+#include "ccnl-shard.h"
 
 static int lasthour = -1;
 static int inter_ccn_interval = 0; // in usec
@@ -118,6 +119,9 @@ const char *compile_string = ""
 #ifdef USE_SCHEDULER
         "SCHEDULER, "
 #endif
+#ifdef USE_SHARDS
+        "SHARDS, "
+#endif
 #ifdef USE_SIGNATURES
         "SIGNATURES, "
 #endif
@@ -140,17 +144,55 @@ const char *compile_string = ""
 
 // ----------------------------------------------------------------------
 
+// parses a number of bytes with an optional suffix K, M or G
+static int
+parse_size(const char *arg, size_t *size)
+{
+    unsigned long long val;
+    char *end;
+
+    errno = 0;
+    val = strtoull(arg, &end, 10);
+    switch (*end) {
+    case 'G': case 'g':
+        val <<= 10; /* fall through */
+    case 'M': case 'm':
+        val <<= 10; /* fall through */
+    case 'K': case 'k':
+        val <<= 10;
+        end++;
+        break;
+    default:
+        break;
+    }
+    if (errno || *end || arg[0] == '-' || val > SIZE_MAX) {
+        return -1;
+    }
+    *size = (size_t) val;
+    return 0;
+}
+
 // ----------------------------------------------------------------------
 
 int
 main(int argc, char **argv)
 {
     int opt, max_cache_entries = -1, httpport = -1;
+    int cs_policy = CCNL_CS_POLICY_LRU;
+    const struct ccnl_strategy_s *strategy = NULL;
+    unsigned long nonce_capacity = CCNL_NONCE_CAPACITY;
+    unsigned long nonce_window = CCNL_NONCE_WINDOW;
+    size_t max_cache_bytes = 0, max_store_bytes = 0;
+    int admission = 0;
+    uint32_t if_qlen = 0;
     int udpport1 = -1, udpport2 = -1;
     int udp6port1 = -1, udp6port2 = -1;
-    char *datadir = NULL, *ethdev = NULL, *crypto_sock_path = NULL;
+    char *datadir = NULL, *storedir = NULL, *ethdev = NULL, *crypto_sock_path = NULL;
     char *wpandev = NULL;
     int suite = CCNL_SUITE_DEFAULT;
+#ifdef USE_SHARDS
+    int shards = 1;
+#endif
     struct ccnl_relay_s *theRelay = ccnl_calloc(1, sizeof(struct ccnl_relay_s));
 #ifdef USE_UNIXSOCKET
     char *uxpath = CCNL_DEFAULT_UNIXSOCKNAME;
@@ -169,8 +211,31 @@ main(int argc, char **argv)
     srandom(seed);
 #endif
 
-    while ((opt = getopt(argc, argv, "hc:d:e:g:i:o:p:s:t:u:6:v:w:x:")) != -1) {
+    while ((opt = getopt(argc, argv, "Ab:B:hc:C:d:D:e:g:i:j:n:N:o:p:q:r:s:S:t:Tu:6:v:w:x:z:")) != -1) {
         switch (opt) {
+#ifdef USE_EPOLL
+        case 'b':
+            if (!strcmp(optarg, "select")) {
+                ccnl_io_use_select = 1;
+            } else if (!strcmp(optarg, "epoll")) {
+                ccnl_io_use_select = 0;
+            } else {
+                goto usage;
+            }
+            break;
+#endif
+#ifdef USE_MMSG
+        case 'B': {
+            long rx_batch_l;
+            errno = 0;
+            rx_batch_l = strtol(optarg, (char **) NULL, 10);
+            if (errno || rx_batch_l < 1 || rx_batch_l > CCNL_MAX_RX_BATCH) {
+                goto usage;
+            }
+            ccnl_io_rx_batch = (int) rx_batch_l;
+            break;
+        }
+#endif
         case 'c': {
             long max_cache_entries_l;
             errno = 0;
@@ -181,9 +246,20 @@ main(int argc, char **argv)
             max_cache_entries = (int) max_cache_entries_l;
             break;
         }
+        case 'C':
+            if (parse_size(optarg, &max_cache_bytes)) {
+                goto usage;
+            }
+            break;
         case 'd':
             datadir = optarg;
             break;
+        case 'D':
+            storedir = optarg;
+            break;
+        case 'A':
+            admission = 1;
+            break;
         case 'e':
             ethdev = optarg;
             break;
@@ -207,6 +283,34 @@ main(int argc, char **argv)
             inter_ccn_interval = (int) inter_ccn_interval_l;
             break;
         }
+#ifdef USE_SHARDS
+        case 'j': {
+            long shards_l;
+            errno = 0;
+            shards_l = strtol(optarg, (char **) NULL, 10);
+            if (errno || shards_l < 1 || shards_l > CCNL_MAX_SHARDS) {
+                goto usage;
+            }
+            shards = (int) shards_l;
+            break;
+        }
+#endif
+        case 'n':
+        case 'N': {
+            unsigned long val;
+            char *end;
+            errno = 0;
+            val = strtoul(optarg, &end, 10);
+            if (errno || *end || optarg[0] == '-' || val < 1 || val > UINT32_MAX) {
+                goto usage;
+            }
+            if (opt == 'n') {
+                nonce_capacity = val;
+            } else {
+                nonce_window = val;
+            }
+            break;
+        }
 #ifdef USE_ECHO
         case 'o':
             echopfx = optarg;
@@ -215,11 +319,35 @@ main(int argc, char **argv)
         case 'p':
             crypto_sock_path = optarg;
             break;
+        case 'q': {
+            unsigned long val;
+            char *end;
+            errno = 0;
+            val = strtoul(optarg, &end, 10);
+            if (errno || *end || optarg[0] == '-' || val < 1 ||
+                val > CCNL_RING_MAX_DEPTH) {
+                goto usage;
+            }
+            if_qlen = (uint32_t) val;
+            break;
+        }
+        case 'r':
+            cs_policy = ccnl_cs_policy_from_str(optarg);
+            if (cs_policy < 0) {
+                goto usage;
+            }
+            break;
         case 's':
             suite = ccnl_str2suite(optarg);
             if (!ccnl_isSuite(suite))
                 goto usage;
             break;
+        case 'S':
+            strategy = ccnl_strategy_find(optarg);
+            if (!strategy) {
+                goto usage;
+            }
+            break;
         case 't': {
             long httpport_l;
             errno = 0;
@@ -230,6 +358,11 @@ main(int argc, char **argv)
             httpport = (int) httpport_l;
             break;
         }
+#ifdef USE_MMSG
+        case 'T':
+            ccnl_io_tx_batch = 0;
+            break;
+#endif
         case 'u':
             if (udpport1 == -1) {
                 long udpport1_l;
@@ -288,6 +421,11 @@ main(int argc, char **argv)
             wpandev = optarg;
             break;
 #endif
+        case 'z':
+            if (parse_size(optarg, &max_store_bytes)) {
+                goto usage;
+            }
+            break;
         case 'x':
             uxpath = optarg;
             break;
@@ -296,18 +434,38 @@ main(int argc, char **argv)
 usage:
             fprintf(stderr,
                     "usage: %s [options]\n"
+                    "  -A (admission filter for the content store)\n"
+#ifdef USE_EPOLL
+                    "  -b IO_BACKEND (epoll, select)\n"
+#endif
+#ifdef USE_MMSG
+                    "  -B RX_BATCH (packets per receive call, 1 disables batching)\n"
+#endif
                     "  -c MAX_CONTENT_ENTRIES\n"
+                    "  -C MAX_CONTENT_BYTES (suffix K, M or G)\n"
                     "  -d databasedir\n"
+                    "  -D storedir (persistent content store, imports databasedir when empty)\n"
                     "  -e ethdev\n"
                     "  -g MIN_INTER_PACKET_INTERVAL\n"
                     "  -h\n"
                     "  -i MIN_INTER_CCNMSG_INTERVAL\n"
+#ifdef USE_SHARDS
+                    "  -j THREADS (shard PIT and content store over threads by name, UDP only)\n"
+#endif
+                    "  -n NONCES (Interest nonces remembered per window)\n"
+                    "  -N NONCE_WINDOW (in seconds)\n"
 #ifdef USE_ECHO
                     "  -o echo_prefix\n"
 #endif
                     "  -p crypto_face_ux_socket\n"
+                    "  -q IF_QUEUE_DEPTH (packets queued per interface for sending)\n"
+                    "  -r CS_REPLACEMENT_POLICY (lru, lfu, s3fifo, arc)\n"
                     "  -s SUITE (ccnb, ccnx2015, ndn2013)\n"
+                    "  -S FORWARDING_STRATEGY (multicast, best-route, round-robin, weighted)\n"
                     "  -t tcpport (for HTML status page)\n"
+#ifdef USE_MMSG
+                    "  -T (send one packet per system call)\n"
+#endif
                     "  -u udpport (can be specified twice)\n"
                     "  -6 udp6port (can be specified twice)\n"
 
@@ -320,6 +478,7 @@ usage:
 #ifdef USE_UNIXSOCKET
                     "  -x unixpath\n"
 #endif
+                    "  -z MAX_STORE_BYTES (suffix K, M or G, per thread)\n"
                     , argv[0]);
             exit(EXIT_FAILURE);
         }
@@ -333,6 +492,17 @@ usage:
         httpport = opt;
     }
 
+#ifdef USE_SHARDS
+    if (shards > 1) {
+        // the other shards have only the UDP interfaces, with the same indices
+        if (ethdev || wpandev) {
+            DEBUGMSG(ERROR, "-j does not work with -e or -w\n");
+            exit(EXIT_FAILURE);
+        }
+        ccnl_udp_reuseport = 1;
+    }
+#endif
+
     ccnl_core_init();
 
     DEBUGMSG(INFO, "This is ccn-lite-relay, starting at %s",
@@ -343,10 +513,29 @@ usage:
     DEBUGMSG(INFO, "  seed: %u\n", seed);
 //    DEBUGMSG(INFO, "using suite %s\n", ccnl_suite2str(suite));
 
+    theRelay->if_qlen = if_qlen;
     ccnl_relay_config(theRelay, ethdev, wpandev, udpport1, udpport2,
                       udp6port1, udp6port2, httpport,
                       uxpath, suite, max_cache_entries, crypto_sock_path);
-    if (datadir) {
+    ccnl_cs_set_policy(theRelay, (ccnl_cs_policy) cs_policy);
+    if (admission) {
+        // about twice as many counters as entries
+        ccnl_cs_set_admission(theRelay, max_cache_entries > 0 ?
+                              2 * (uint32_t) max_cache_entries : CCNL_CS_SKETCH_DEFAULT);
+    }
+    if (ccnl_nonce_filter_config(&theRelay->nonce_filter,
+                                 (uint32_t) nonce_capacity, (uint32_t) nonce_window)) {
+        DEBUGMSG(ERROR, "invalid nonce filter size %lu\n", nonce_capacity);
+        exit(EXIT_FAILURE);
+    }
+    theRelay->max_cache_bytes = max_cache_bytes;
+    theRelay->strategy = strategy;
+    if (storedir) {
+        if (ccnl_cs_store_attach(theRelay, storedir, datadir, max_store_bytes)) {
+            DEBUGMSG(ERROR, "could not open the store %s\n", storedir);
+            exit(EXIT_FAILURE);
+        }
+    } else if (datadir) {
         ccnl_populate_cache(theRelay, datadir);
     }
 
@@ -362,12 +551,27 @@ usage:
     }
 #endif
 
-    ccnl_io_loop(theRelay);
+#ifdef USE_SHARDS
+    if (shards > 1) {
+        struct ccnl_shard_config_s cfg = { udpport1, udpport2, udp6port1,
+                                           udp6port2, suite, datadir, storedir,
+                                           max_store_bytes };
 
-    while (eventqueue) {
-        ccnl_rem_timer(eventqueue);
+        if (ccnl_shard_start(theRelay, shards, &cfg)) {
+            DEBUGMSG(ERROR, "could not start the shards\n");
+            exit(EXIT_FAILURE);
+        }
     }
+#endif
+
+    ccnl_io_loop(theRelay);
+#ifdef USE_SHARDS
+    ccnl_shard_stop();
+#endif
+
+    ccnl_timer_cleanup();
 
+    ccnl_cs_store_detach(theRelay);
     ccnl_core_cleanup(theRelay);
 #ifdef USE_HTTP_STATUS
     theRelay->http = ccnl_http_cleanup(theRelay->http);
@@ -0,0 +1,204 @@
+/*
+ * @f ccnl-cs-store.h
+ * @b CCN lite (CCNL), persistent content store in memory-mapped segment files
+ *
+ * Copyright (C) 2011-17, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifndef CCNL_CS_STORE_H
+#define CCNL_CS_STORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Max size of a segment file, a new segment is started when an
+ * append would exceed it (or a quarter of the max size of the store,
+ * if that is smaller)
+ */
+#ifndef CCNL_CS_STORE_SEGMENT_SIZE
+#define CCNL_CS_STORE_SEGMENT_SIZE  (64UL << 20)
+#endif
+
+/**
+ * @brief Max number of segment files of a store
+ */
+#define CCNL_CS_STORE_MAX_SEGMENTS  UINT16_MAX
+
+/**
+ * @brief Magic number at the start of an index file
+ */
+#define CCNL_CS_STORE_MAGIC         "CCNLCSI1"
+
+/**
+ * @brief Flag of an index record: the packet was imported, its segment
+ * is never deleted
+ */
+#define CCNL_CS_STORE_REC_PINNED    0x01
+
+/**
+ * @brief An entry of an index file, in host byte order
+ *
+ * A store directory holds pairs of files cs-NNNNNN.seg and cs-NNNNNN.idx.
+ * A segment file is the plain concatenation of the stored packets (so it
+ * is also a packed file which ccnl_populate_cache() can read), its index
+ * file starts with \ref CCNL_CS_STORE_MAGIC followed by one record per
+ * packet. Both files are only ever appended to, the packet first: a
+ * record which is cut short or points behind the end of its segment is
+ * the trace of an interrupted append and is ignored.
+ */
+struct ccnl_cs_store_rec_s {
+    uint32_t hash;              /**< ccnl_prefix_hash() of the packet's name */
+    uint32_t offs;              /**< offset of the packet in the segment */
+    uint32_t len;               /**< length of the packet */
+    uint32_t flags;             /**< \ref CCNL_CS_STORE_REC_PINNED or 0 */
+};
+
+/**
+ * @brief A slot of the in-memory index of a store, empty if len is 0
+ */
+struct ccnl_cs_store_slot_s {
+    uint32_t hash;              /**< hash of the name */
+    uint32_t offs;              /**< offset of the packet in its segment */
+    uint16_t len;               /**< length of the packet */
+    uint16_t seg;               /**< the segment */
+};
+
+/**
+ * @brief A segment file, mapped read-only
+ */
+struct ccnl_cs_store_seg_s {
+    uint8_t *map;               /**< the mapping */
+    size_t maplen;              /**< length of the mapping */
+    size_t size;                /**< bytes of the segment in use */
+    uint8_t pinned;             /**< holds imported packets */
+    uint8_t own;                /**< counts against the max size and may be deleted */
+};
+
+/**
+ * @brief A persistent content store
+ *
+ * The packets stay in the mapped segment files, so they are read from
+ * the page cache and shared by all processes and threads which open the
+ * store. Only the index is held in memory: an open addressing hash table
+ * over the name hashes, 12 bytes per packet, rebuilt from the index files
+ * without parsing any packet. Each writer appends to new segments of
+ * its own, writers sharing a directory only see each other's packets
+ * after reopening it. A store with a max size is a log: the oldest
+ * segments it owns are deleted to make room for new packets. It owns the
+ * segments it wrote, and those of earlier runs it adopted, but never the
+ * pinned segments of an import.
+ */
+struct ccnl_cs_store_s {
+    char *dir;                          /**< the store directory */
+    struct ccnl_cs_store_seg_s *segs;   /**< the segments, by number */
+    uint32_t segcnt;                    /**< number of segments */
+    struct ccnl_cs_store_slot_s *slots; /**< the index */
+    uint32_t mask;                      /**< number of slots minus one */
+    uint32_t cnt;                       /**< number of packets */
+    size_t size;                        /**< bytes of the segments owned */
+    size_t max_size;                    /**< max bytes of the segments owned, 0: unlimited */
+    int pin;                            /**< packets appended are pinned */
+    int segfd;                          /**< the segment appended to, -1: none yet */
+    int idxfd;                          /**< its index file */
+};
+
+/**
+ * @brief Opens a store, the directory is created if it does not exist
+ *
+ * @param[in] dir       the store directory
+ * @param[in] max_size  max bytes of the segments, 0: unlimited
+ *
+ * @return the store
+ * @return NULL if the directory or a file of it cannot be read
+ */
+struct ccnl_cs_store_s*
+ccnl_cs_store_open(const char *dir, size_t max_size);
+
+/**
+ * @brief Closes a store and unmaps its segments
+ *
+ * @param[in] s         the store, may be NULL
+ */
+void
+ccnl_cs_store_close(struct ccnl_cs_store_s *s);
+
+/**
+ * @brief Pins the packets appended from now on, or stops doing so
+ *
+ * Pinned packets go to segments of their own, which are never deleted
+ * and not counted against the max size: an import stays on disk while
+ * the packets spilled later come and go.
+ *
+ * @param[in] s         the store
+ * @param[in] pin       1 to pin, 0 to stop
+ */
+void
+ccnl_cs_store_pin(struct ccnl_cs_store_s *s, int pin);
+
+/**
+ * @brief Takes over the unpinned segments of earlier runs
+ *
+ * They are counted against the max size and deleted like the segments
+ * the store writes. Of the writers sharing a directory only one should
+ * adopt them, the others leave them alone.
+ *
+ * @param[in] s         the store
+ */
+void
+ccnl_cs_store_adopt(struct ccnl_cs_store_s *s);
+
+/**
+ * @brief Appends a packet to a store
+ *
+ * The packet is written to the segment file, then its record to the
+ * index file, so a crash never leaves a record of a missing packet. The
+ * oldest segments owned are deleted if the store would exceed its max
+ * size.
+ *
+ * @param[in] s         the store
+ * @param[in] hash      ccnl_prefix_hash() of the packet's name
+ * @param[in] data      the packet
+ * @param[in] len       length of the packet
+ *
+ * @return 0 on success
+ * @return -1 if the packet is too long or cannot be written
+ */
+int
+ccnl_cs_store_append(struct ccnl_cs_store_s *s, uint32_t hash,
+                     const uint8_t *data, size_t len);
+
+/**
+ * @brief Iterates over the packets whose name has a given hash
+ *
+ * Packets with another name of the same hash are returned as well, the
+ * caller compares the names.
+ *
+ * @param[in] s         the store
+ * @param[in] hash      the hash of the name
+ * @param[in,out] pos   iteration state, 0 for the first call
+ * @param[out] len      length of the packet
+ *
+ * @return the next packet, in the mapped segment
+ * @return NULL if there is none
+ */
+const uint8_t*
+ccnl_cs_store_get(struct ccnl_cs_store_s *s, uint32_t hash, uint32_t *pos,
+                  size_t *len);
+
+#endif // CCNL_CS_STORE_H
@@ -38,6 +38,9 @@
 # include <fcntl.h>
 # include <sys/ioctl.h>
 # include <sys/select.h>
+# ifdef USE_EPOLL
+#  include <sys/epoll.h>
+# endif
 # include <sys/socket.h>
 # include <sys/time.h>
 # include <sys/un.h>
@@ -0,0 +1,122 @@
+/*
+ * @f ccnl-shard.h
+ * @b CCN lite (CCNL), relay sharded over several threads
+ *
+ * Copyright (C) 2011-17, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifndef CCNL_SHARD_H
+#define CCNL_SHARD_H
+
+#ifdef USE_SHARDS
+
+#include <stdint.h>
+#include "ccnl-relay.h"
+
+/**
+ * @brief Max number of shards of a relay
+ */
+#ifndef CCNL_MAX_SHARDS
+#define CCNL_MAX_SHARDS         64
+#endif
+
+/**
+ * @brief Number of packets a shard queues for another one
+ */
+#ifndef CCNL_SHARD_QLEN
+#define CCNL_SHARD_QLEN         256
+#endif
+
+/**
+ * @brief Number of leading name components which select the shard
+ *
+ * Interests and the Data answering them must meet in the same shard, so
+ * no Interest may be shorter than this: one component is always safe,
+ * more spread the names of a single application over the shards.
+ */
+#ifndef CCNL_SHARD_COMPS
+#define CCNL_SHARD_COMPS        1
+#endif
+
+/**
+ * @brief Interval in microseconds at which the first shard passes
+ * changes of its FIB to the others
+ */
+#ifndef CCNL_SHARD_SYNC_INTERVAL
+#define CCNL_SHARD_SYNC_INTERVAL 10000
+#endif
+
+/**
+ * @brief Configuration of the shards, the settings not listed here are
+ * copied from the first shard's relay
+ */
+struct ccnl_shard_config_s {
+    int32_t udpport1;           /**< first IPv4 UDP port, -1: none */
+    int32_t udpport2;           /**< second IPv4 UDP port, -1: none */
+    int32_t udp6port1;          /**< first IPv6 UDP port, -1: none */
+    int32_t udp6port2;          /**< second IPv6 UDP port, -1: none */
+    int suite;                  /**< default suite of the interfaces */
+    char *datadir;              /**< directory to populate the content stores from, may be NULL */
+    char *storedir;             /**< persistent store behind the content stores, may be NULL */
+    size_t store_max;           /**< max bytes of each shard's store, 0: unlimited */
+};
+
+/**
+ * @brief Returns the shard which owns a name
+ *
+ * @param[in] pfx       the name
+ * @param[in] nshards   number of shards
+ *
+ * @return the index of the shard
+ */
+uint32_t
+ccnl_shard_of(struct ccnl_prefix_s *pfx, uint32_t nshards);
+
+/**
+ * @brief Shards a configured relay over several threads
+ *
+ * The relay becomes the first shard and keeps all its interfaces, the
+ * others run in threads of their own and open only the UDP ports, bound
+ * with SO_REUSEPORT: \ref ccnl_udp_reuseport must have been set when
+ * the relay was configured, and the relay must have no interface before
+ * its UDP ones. Each shard has a PIT and content store of its own and
+ * serves the names which \ref ccnl_shard_of assigns to it, packets
+ * received for other names on a UDP interface are passed to their shard
+ * through a lock-free ring. The FIB is managed on the first shard and
+ * copied to the others.
+ *
+ * @param[in] relay     the configured relay, shard 0
+ * @param[in] nshards   number of shards, including the relay
+ * @param[in] cfg       configuration of the other shards
+ *
+ * @return 0 if all shards are running, -1 otherwise
+ */
+int
+ccnl_shard_start(struct ccnl_relay_s *relay, int nshards,
+                 struct ccnl_shard_config_s *cfg);
+
+/**
+ * @brief Halts the other shards after the first one left its I/O loop,
+ * and waits for their threads
+ */
+void
+ccnl_shard_stop(void);
+
+#endif // USE_SHARDS
+
+#endif // CCNL_SHARD_H
@@ -54,6 +54,14 @@ int
 ccnl_open_unixpath(char *path, struct sockaddr_un *ux);
 #endif
 
+#ifdef USE_SHARDS
+/**
+ * @brief Set to open the UDP sockets with SO_REUSEPORT, so that the
+ * shards of a relay can bind the same ports
+ */
+extern int ccnl_udp_reuseport;
+#endif
+
 #ifdef USE_IPV4
 int
 ccnl_open_udpdev(uint16_t port, struct sockaddr_in *si);
@@ -97,6 +105,27 @@ void
 ccnl_ll_TX(struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc,
            sockunion *dest, struct ccnl_buf_s *buf);
 
+#ifdef USE_MMSG
+/**
+ * @brief Sends several queued packets of an interface with one system call
+ *
+ * Serves as ccnl_ll_TXv_ptr of the relay. Link layer packets are sent
+ * one at a time with \ref ccnl_ll_TX.
+ *
+ * @param[in] ccnl  the relay
+ * @param[in] ifc   the interface
+ * @param[in] reqs  the oldest queued packets, in order
+ * @param[in] cnt   number of packets in \p reqs
+ *
+ * @return number of packets from the start of \p reqs which were sent
+ *         or dropped
+ * @return 0 if the socket would block
+ */
+int
+ccnl_ll_TXv(struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc,
+            struct ccnl_txrequest_s **reqs, int cnt);
+#endif
+
 void
 ccnl_relay_config(struct ccnl_relay_s *relay, char *ethdev, char *wpandev,
                   int32_t udpport1, int32_t udpport2,
@@ -104,10 +133,123 @@ ccnl_relay_config(struct ccnl_relay_s *relay, char *ethdev, char *wpandev,
                   char *uxpath, int suite, int max_cache_entries,
                   char *crypto_face_path);
 
+#ifdef USE_EPOLL
+/**
+ * @brief Set to use select() instead of epoll in \ref ccnl_io_loop
+ */
+extern int ccnl_io_use_select;
+#endif
+
+#ifdef USE_MMSG
+/**
+ * @brief Default number of packets read from an interface with one
+ * recvmmsg() call
+ */
+#ifndef CCNL_RX_BATCH
+#define CCNL_RX_BATCH 32
+#endif
+
+/**
+ * @brief Upper bound of \ref ccnl_io_rx_batch (the kernel limit)
+ */
+#define CCNL_MAX_RX_BATCH 1024
+
+/**
+ * @brief Number of packets to read from an interface with one system call
+ *
+ * Read when \ref ccnl_io_loop starts, 1 disables the batched receive.
+ */
+extern int ccnl_io_rx_batch;
+
+/**
+ * @brief Set (default) to send the packets queued at an interface with
+ * one sendmmsg() call, see \ref ccnl_interface_flush
+ *
+ * Read when \ref ccnl_io_loop starts.
+ */
+extern int ccnl_io_tx_batch;
+#endif
+
+/**
+ * @brief Adds a descriptor to the I/O loop of the calling thread
+ *
+ * When the descriptor becomes readable, the loop calls @p cb, which must
+ * consume what made it readable (an eventfd, say). Used to wake up the
+ * loop from other threads.
+ *
+ * @param[in] fd    the descriptor
+ * @param[in] cb    the callback, NULL to remove the descriptor
+ */
+void
+ccnl_io_set_wakeup(int fd, void (*cb)(struct ccnl_relay_s*));
+
+/**
+ * @brief Runs the event and I/O loop of a relay until its halt_flag is set
+ *
+ * Uses epoll when built with USE_EPOLL, select() otherwise.
+ *
+ * @param[in] ccnl  the relay
+ *
+ * @return 0 when the relay was halted
+ * @return -1 if the loop could not be set up
+ */
 int
 ccnl_io_loop(struct ccnl_relay_s *ccnl);
 
 void
 ccnl_populate_cache(struct ccnl_relay_s *ccnl, char *path);
 
+/**
+ * @brief Min number of recent requests, as estimated by the admission
+ * filter, of content which is evicted from the content store for it to
+ * be written to the store
+ */
+#ifndef CCNL_CS_STORE_SPILL_MIN
+#define CCNL_CS_STORE_SPILL_MIN 2
+#endif
+
+/**
+ * @brief Max number of content objects of one name promoted from the
+ * store at a time
+ */
+#ifndef CCNL_CS_STORE_PROMOTE_MAX
+#define CCNL_CS_STORE_PROMOTE_MAX 8
+#endif
+
+/**
+ * @brief Puts a persistent store behind the content store of a relay
+ *
+ * The two make up a two-tier cache. Interests which miss the content
+ * store are looked up in the store, and the content found there is
+ * added to the content store. Content evicted from the content store is
+ * appended to the store, if the admission filter (\ref
+ * ccnl_cs_set_admission) counted at least \ref CCNL_CS_STORE_SPILL_MIN
+ * recent requests for it; without the filter nothing is spilled. With a
+ * \p datadir, an empty store is first filled with the content objects of
+ * the files in it (see \ref ccnl_populate_cache): only the first start of
+ * a relay parses them. The import is pinned, \p max_size only bounds the
+ * spilled content. The relay with id 0 adopts what earlier runs spilled,
+ * the other shards only delete the segments they wrote themselves.
+ *
+ * @param[in] ccnl      the relay
+ * @param[in] dir       the store directory, see \ref ccnl_cs_store_open
+ * @param[in] datadir   directory to import into an empty store, may be NULL
+ * @param[in] max_size  max bytes of the spilled content, 0: unlimited
+ *
+ * @return 0 on success
+ * @return -1 if the store cannot be opened
+ */
+int
+ccnl_cs_store_attach(struct ccnl_relay_s *ccnl, const char *dir,
+                     const char *datadir, size_t max_size);
+
+/**
+ * @brief Closes the store of a relay, if it has one, and logs the hits
+ * of both tiers
+ *
+ * @param[in] ccnl      the relay
+ */
+void
+ccnl_cs_store_detach(struct ccnl_relay_s *ccnl);
+
 #endif // CCNL_UNIX_H
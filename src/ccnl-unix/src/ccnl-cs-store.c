@@ -0,0 +1,520 @@
+/*
+ * @f ccnl-cs-store.c
+ * @b CCN lite (CCNL), persistent content store in memory-mapped segment files
+ *
+ * Copyright (C) 2011-17, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "ccnl-cs-store.h"
+#include "ccnl-core.h"
+
+#define CCNL_CS_STORE_MIN_SLOTS     1024
+#define CCNL_CS_STORE_PATHLEN       1024
+#define CCNL_CS_STORE_MAGIC_LEN     (sizeof(CCNL_CS_STORE_MAGIC) - 1)
+
+static int
+ccnl_cs_store_path(struct ccnl_cs_store_s *s, char *path, size_t size,
+                   uint32_t num, const char *ext)
+{
+    int len = snprintf(path, size, "%s/cs-%06u.%s", s->dir, num, ext);
+
+    return (len < 0 || (size_t) len >= size) ? -1 : 0;
+}
+
+static void
+ccnl_cs_store_insert(struct ccnl_cs_store_s *s,
+                     struct ccnl_cs_store_slot_s *slot)
+{
+    uint32_t k = slot->hash & s->mask;
+
+    while (s->slots[k].len) {
+        k = (k + 1) & s->mask;
+    }
+    s->slots[k] = *slot;
+}
+
+// moves the index to a table of another size, leaving out the packets
+// of segment drop (UINT32_MAX: none)
+static int
+ccnl_cs_store_rehash(struct ccnl_cs_store_s *s, uint32_t size, uint32_t drop)
+{
+    struct ccnl_cs_store_slot_s *old = s->slots;
+    uint32_t k = old ? s->mask + 1 : 0;
+
+    s->slots = (struct ccnl_cs_store_slot_s *) ccnl_calloc(size, sizeof(*s->slots));
+    if (!s->slots) {
+        s->slots = old;
+        return -1;
+    }
+    s->mask = size - 1;
+    s->cnt = 0;
+    while (k-- > 0) {
+        if (old[k].len && old[k].seg != drop) {
+            ccnl_cs_store_insert(s, old + k);
+            s->cnt++;
+        }
+    }
+    ccnl_free(old);
+    return 0;
+}
+
+// keeps the index at most three quarters full
+static int
+ccnl_cs_store_reserve(struct ccnl_cs_store_s *s, uint32_t cnt)
+{
+    uint32_t size = s->mask + 1;
+
+    if (s->slots && cnt <= size / 4 * 3) {
+        return 0;
+    }
+    if (!s->slots) {
+        size = CCNL_CS_STORE_MIN_SLOTS;
+    }
+    while (cnt > size / 4 * 3) {
+        if (size >= (1UL << 31)) {
+            return -1;
+        }
+        size <<= 1;
+    }
+    return ccnl_cs_store_rehash(s, size, UINT32_MAX);
+}
+
+static int
+ccnl_cs_store_add_slot(struct ccnl_cs_store_s *s, uint32_t seg,
+                       struct ccnl_cs_store_rec_s *rec)
+{
+    struct ccnl_cs_store_slot_s slot;
+
+    if (ccnl_cs_store_reserve(s, s->cnt + 1)) {
+        return -1;
+    }
+    slot.hash = rec->hash;
+    slot.offs = rec->offs;
+    slot.len = (uint16_t) rec->len;
+    slot.seg = (uint16_t) seg;
+    ccnl_cs_store_insert(s, &slot);
+    s->cnt++;
+    return 0;
+}
+
+// maps a segment and indexes the valid records of its index file
+static int
+ccnl_cs_store_loadseg(struct ccnl_cs_store_s *s, uint32_t num)
+{
+    struct ccnl_cs_store_seg_s *seg = s->segs + num;
+    struct ccnl_cs_store_rec_s rec;
+    char path[CCNL_CS_STORE_PATHLEN];
+    struct stat st;
+    uint8_t *idx;
+    size_t k, cnt;
+    int fd;
+
+    if (ccnl_cs_store_path(s, path, sizeof(path), num, "seg")) {
+        return -1;
+    }
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return errno == ENOENT ? 0 : -1;
+    }
+    if (fstat(fd, &st)) {
+        close(fd);
+        return -1;
+    }
+    if (st.st_size > 0) {
+        seg->map = (uint8_t *) mmap(NULL, (size_t) st.st_size, PROT_READ,
+                                    MAP_SHARED, fd, 0);
+        if (seg->map == MAP_FAILED) {
+            seg->map = NULL;
+            close(fd);
+            return -1;
+        }
+        seg->maplen = seg->size = (size_t) st.st_size;
+    }
+    close(fd);
+
+    if (ccnl_cs_store_path(s, path, sizeof(path), num, "idx")) {
+        return -1;
+    }
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return errno == ENOENT ? 0 : -1;
+    }
+    if (fstat(fd, &st)) {
+        close(fd);
+        return -1;
+    }
+    if ((size_t) st.st_size < CCNL_CS_STORE_MAGIC_LEN + sizeof(rec)) {
+        close(fd);
+        return 0;
+    }
+    idx = (uint8_t *) mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (idx == MAP_FAILED) {
+        return -1;
+    }
+    if (memcmp(idx, CCNL_CS_STORE_MAGIC, CCNL_CS_STORE_MAGIC_LEN)) {
+        DEBUGMSG(WARNING, "%s is not an index file\n", path);
+        munmap(idx, (size_t) st.st_size);
+        return 0;
+    }
+    cnt = ((size_t) st.st_size - CCNL_CS_STORE_MAGIC_LEN) / sizeof(rec);
+    if (ccnl_cs_store_reserve(s, s->cnt + (uint32_t) cnt)) {
+        munmap(idx, (size_t) st.st_size);
+        return -1;
+    }
+    for (k = 0; k < cnt; k++) {
+        memcpy(&rec, idx + CCNL_CS_STORE_MAGIC_LEN + k * sizeof(rec), sizeof(rec));
+        if (rec.len == 0 || rec.len > UINT16_MAX ||
+            (size_t) rec.offs + rec.len > seg->size) {
+            continue;
+        }
+        if (rec.flags & CCNL_CS_STORE_REC_PINNED) {
+            seg->pinned = 1;
+        }
+        ccnl_cs_store_add_slot(s, num, &rec);
+    }
+    munmap(idx, (size_t) st.st_size);
+    return 0;
+}
+
+// stops appending to the current segment
+static void
+ccnl_cs_store_seal(struct ccnl_cs_store_s *s)
+{
+    if (s->segfd >= 0) {
+        close(s->segfd);
+        close(s->idxfd);
+        s->segfd = s->idxfd = -1;
+    }
+}
+
+struct ccnl_cs_store_s*
+ccnl_cs_store_open(const char *dir, size_t max_size)
+{
+    struct ccnl_cs_store_s *s;
+    struct dirent *de;
+    unsigned int num;
+    uint32_t k, segcnt = 0;
+    size_t total = 0;
+    DIR *d;
+    char c;
+
+    if (mkdir(dir, 0777) && errno != EEXIST) {
+        DEBUGMSG(ERROR, "could not create store directory %s\n", dir);
+        return NULL;
+    }
+    d = opendir(dir);
+    if (!d) {
+        DEBUGMSG(ERROR, "could not open store directory %s\n", dir);
+        return NULL;
+    }
+    while ((de = readdir(d))) {
+        if (sscanf(de->d_name, "cs-%6u.se%c", &num, &c) == 2 && c == 'g' &&
+            num < CCNL_CS_STORE_MAX_SEGMENTS && num >= segcnt) {
+            segcnt = num + 1;
+        }
+    }
+    closedir(d);
+
+    s = (struct ccnl_cs_store_s *) ccnl_calloc(1, sizeof(*s));
+    if (!s) {
+        return NULL;
+    }
+    s->segfd = s->idxfd = -1;
+    s->max_size = max_size;
+    s->dir = ccnl_strdup(dir);
+    if (!s->dir || ccnl_cs_store_reserve(s, 0)) {
+        ccnl_cs_store_close(s);
+        return NULL;
+    }
+    if (segcnt) {
+        s->segs = (struct ccnl_cs_store_seg_s *) ccnl_calloc(segcnt, sizeof(*s->segs));
+        if (!s->segs) {
+            ccnl_cs_store_close(s);
+            return NULL;
+        }
+        s->segcnt = segcnt;
+    }
+    for (k = 0; k < segcnt; k++) {
+        if (ccnl_cs_store_loadseg(s, k)) {
+            DEBUGMSG(ERROR, "could not load segment %u of store %s\n", k, dir);
+            ccnl_cs_store_close(s);
+            return NULL;
+        }
+        total += s->segs[k].size;
+    }
+    DEBUGMSG(INFO, "store %s: %u content objects in %u segments, %zu bytes\n",
+             dir, s->cnt, s->segcnt, total);
+    return s;
+}
+
+void
+ccnl_cs_store_close(struct ccnl_cs_store_s *s)
+{
+    uint32_t k;
+
+    if (!s) {
+        return;
+    }
+    ccnl_cs_store_seal(s);
+    for (k = 0; k < s->segcnt; k++) {
+        if (s->segs[k].map) {
+            munmap(s->segs[k].map, s->segs[k].maplen);
+        }
+    }
+    ccnl_free(s->segs);
+    ccnl_free(s->slots);
+    ccnl_free(s->dir);
+    ccnl_free(s);
+}
+
+static int
+ccnl_cs_store_write(int fd, const uint8_t *data, size_t len)
+{
+    while (len > 0) {
+        ssize_t rc = write(fd, data, len);
+
+        if (rc < 0 && errno == EINTR) {
+            continue;
+        }
+        if (rc <= 0) {
+            return -1;
+        }
+        data += rc;
+        len -= (size_t) rc;
+    }
+    return 0;
+}
+
+// size up to which a segment is appended to: segments are small enough
+// that deleting the oldest one frees a fair share of the budget
+static size_t
+ccnl_cs_store_seglimit(struct ccnl_cs_store_s *s)
+{
+    if (s->max_size && s->max_size / 4 < CCNL_CS_STORE_SEGMENT_SIZE) {
+        return s->max_size / 4;
+    }
+    return CCNL_CS_STORE_SEGMENT_SIZE;
+}
+
+// starts a new segment to append to: it is mapped at its maximum size
+// right away, so the packets appended later are readable through it
+static int
+ccnl_cs_store_newseg(struct ccnl_cs_store_s *s)
+{
+    struct ccnl_cs_store_seg_s *segs, *seg;
+    char segpath[CCNL_CS_STORE_PATHLEN], idxpath[CCNL_CS_STORE_PATHLEN];
+    size_t limit = ccnl_cs_store_seglimit(s);
+    int segfd, idxfd;
+
+    for (;;) {
+        if (s->segcnt >= CCNL_CS_STORE_MAX_SEGMENTS ||
+            ccnl_cs_store_path(s, segpath, sizeof(segpath), s->segcnt, "seg") ||
+            ccnl_cs_store_path(s, idxpath, sizeof(idxpath), s->segcnt, "idx")) {
+            return -1;
+        }
+        segs = (struct ccnl_cs_store_seg_s *) ccnl_realloc(s->segs,
+                                            (s->segcnt + 1) * sizeof(*s->segs));
+        if (!segs) {
+            return -1;
+        }
+        s->segs = segs;
+        memset(s->segs + s->segcnt, 0, sizeof(*s->segs));
+        segfd = open(segpath, O_RDWR | O_CREAT | O_EXCL | O_APPEND, 0666);
+        if (segfd >= 0) {
+            break;
+        }
+        if (errno != EEXIST) {
+            return -1;
+        }
+        // taken by another writer, its packets are not indexed here
+        s->segcnt++;
+    }
+    idxfd = open(idxpath, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0666);
+    if (idxfd < 0 || ccnl_cs_store_write(idxfd, (const uint8_t *) CCNL_CS_STORE_MAGIC,
+                                         CCNL_CS_STORE_MAGIC_LEN)) {
+        goto Error;
+    }
+    seg = s->segs + s->segcnt;
+    seg->map = (uint8_t *) mmap(NULL, limit, PROT_READ, MAP_SHARED, segfd, 0);
+    if (seg->map == MAP_FAILED) {
+        seg->map = NULL;
+        goto Error;
+    }
+    seg->maplen = limit;
+    seg->pinned = s->pin ? 1 : 0;
+    seg->own = !seg->pinned;
+    s->segcnt++;
+
+    ccnl_cs_store_seal(s);
+    s->segfd = segfd;
+    s->idxfd = idxfd;
+    return 0;
+
+Error:
+    close(segfd);
+    if (idxfd >= 0) {
+        close(idxfd);
+    }
+    unlink(segpath);
+    unlink(idxpath);
+    return -1;
+}
+
+// deletes a segment and its packets
+static int
+ccnl_cs_store_drop(struct ccnl_cs_store_s *s, uint32_t num)
+{
+    struct ccnl_cs_store_seg_s *seg = s->segs + num;
+    char path[CCNL_CS_STORE_PATHLEN];
+
+    if (ccnl_cs_store_rehash(s, s->mask + 1, num)) {
+        return -1;
+    }
+    munmap(seg->map, seg->maplen);
+    // other readers of the store keep their mapping of the files
+    if (!ccnl_cs_store_path(s, path, sizeof(path), num, "seg")) {
+        unlink(path);
+    }
+    if (!ccnl_cs_store_path(s, path, sizeof(path), num, "idx")) {
+        unlink(path);
+    }
+    s->size -= seg->size;
+    memset(seg, 0, sizeof(*seg));
+    return 0;
+}
+
+// deletes the oldest segments owned until len more bytes fit into the
+// budget: the segments of other writers sharing the directory stay
+static void
+ccnl_cs_store_trim(struct ccnl_cs_store_s *s, size_t len)
+{
+    uint32_t k;
+
+    while (s->size + len > s->max_size) {
+        for (k = 0; k < s->segcnt && !(s->segs[k].map && s->segs[k].own); k++);
+        if (k == s->segcnt) {
+            return;
+        }
+        if (s->segfd >= 0 && k == s->segcnt - 1) {
+            ccnl_cs_store_seal(s);
+        }
+        if (ccnl_cs_store_drop(s, k)) {
+            return;
+        }
+    }
+}
+
+void
+ccnl_cs_store_pin(struct ccnl_cs_store_s *s, int pin)
+{
+    if (s->pin != pin) {
+        // pinned and other packets never share a segment
+        ccnl_cs_store_seal(s);
+        s->pin = pin;
+    }
+}
+
+void
+ccnl_cs_store_adopt(struct ccnl_cs_store_s *s)
+{
+    uint32_t k;
+
+    for (k = 0; k < s->segcnt; k++) {
+        struct ccnl_cs_store_seg_s *seg = s->segs + k;
+
+        if (seg->map && !seg->pinned && !seg->own) {
+            seg->own = 1;
+            s->size += seg->size;
+        }
+    }
+}
+
+int
+ccnl_cs_store_append(struct ccnl_cs_store_s *s, uint32_t hash,
+                     const uint8_t *data, size_t len)
+{
+    struct ccnl_cs_store_seg_s *seg;
+    struct ccnl_cs_store_rec_s rec;
+    size_t limit = ccnl_cs_store_seglimit(s);
+
+    if (len == 0 || len > UINT16_MAX || len > limit) {
+        return -1;
+    }
+    if (s->max_size && !s->pin) {
+        ccnl_cs_store_trim(s, len);
+    }
+    if (s->segfd < 0 || s->segs[s->segcnt - 1].size + len > limit) {
+        if (ccnl_cs_store_newseg(s)) {
+            DEBUGMSG(ERROR, "could not start a segment in store %s\n", s->dir);
+            return -1;
+        }
+    }
+    seg = s->segs + s->segcnt - 1;
+    // after a failed write the offsets in the files are not known:
+    // the next append starts a new segment
+    if (ccnl_cs_store_write(s->segfd, data, len)) {
+        ccnl_cs_store_seal(s);
+        return -1;
+    }
+    rec.hash = hash;
+    rec.offs = (uint32_t) seg->size;
+    rec.len = (uint32_t) len;
+    rec.flags = s->pin ? CCNL_CS_STORE_REC_PINNED : 0;
+    seg->size += len;
+    if (seg->own) {
+        s->size += len;
+    }
+    if (ccnl_cs_store_write(s->idxfd, (uint8_t *) &rec, sizeof(rec))) {
+        ccnl_cs_store_seal(s);
+        return -1;
+    }
+    return ccnl_cs_store_add_slot(s, s->segcnt - 1, &rec);
+}
+
+const uint8_t*
+ccnl_cs_store_get(struct ccnl_cs_store_s *s, uint32_t hash, uint32_t *pos,
+                  size_t *len)
+{
+    struct ccnl_cs_store_slot_s *slot;
+
+    while (*pos <= s->mask) {
+        slot = s->slots + ((hash + *pos) & s->mask);
+        (*pos)++;
+        if (!slot->len) {
+            break;
+        }
+        if (slot->hash == hash) {
+            *len = slot->len;
+            return s->segs[slot->seg].map + slot->offs;
+        }
+    }
+    *pos = s->mask + 1;
+    return NULL;
+}
+
+// eof
@@ -0,0 +1,637 @@
+/*
+ * @f ccnl-shard.c
+ * @b CCN lite (CCNL), relay sharded over several threads
+ *
+ * Copyright (C) 2011-17, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-18 created
+ */
+
+#ifdef USE_SHARDS
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+#include "ccnl-shard.h"
+#include "ccnl-unix.h"
+#include "ccnl-core.h"
+#include "ccnl-dispatch.h"
+#include "ccnl-pkt-ccntlv.h"
+
+// Each shard is a complete relay with its own thread, I/O loop, timers
+// and object pools (CCNL_THREAD_LOCAL), and the same UDP ports. A packet
+// received on a UDP interface of the wrong shard is copied into a message
+// on the ring of its shard, which handles it as if it had been received
+// on its own interface with the same index.
+
+#define CCNL_SHARD_PKT          1 // a received packet
+#define CCNL_SHARD_FIB          2 // FIB records of the first shard
+#define CCNL_SHARD_HALT         3 // leave the I/O loop
+
+// max number of messages handled per wakeup, before the other events
+#define CCNL_SHARD_BATCH        64
+
+struct ccnl_shard_msg_s {
+    uint8_t kind;
+    uint8_t first;              // FIB: first message of a copy, clear the FIB
+    int16_t ifndx;              // PKT: interface the packet was received on
+    uint32_t addrlen;           // PKT: length of the peer's address
+    sockunion peer;             // PKT: the sender
+    size_t len;                 // bytes in data
+    uint8_t data[CCNL_MAX_PACKET_SIZE];
+};
+
+// a FIB entry in a FIB message, followed by the next hop's address, the
+// strategy name, the component lengths (uint16_t each) and the name bytes
+struct ccnl_shard_fib_rec_s {
+    int16_t ifndx;
+    uint8_t suite;
+    uint8_t stratlen;
+    uint16_t addrlen;
+    uint16_t compcnt;
+    uint32_t namelen;
+};
+
+struct ccnl_shard_s {
+    int index;
+    struct ccnl_relay_s *relay;
+    struct ccnl_ring_s ring;    // messages for this shard
+    int wakefd;                 // eventfd, wakes up the shard's I/O loop
+    atomic_int signalled;       // wakefd was written and not yet read
+    pthread_t thread;
+    int failed;                 // the shard could not be set up
+    atomic_uint handed;         // packets passed to other shards
+};
+
+static struct ccnl_shard_s *ccnl_shards;
+static int ccnl_shard_count;
+static int ccnl_shard_nudp;             // interfaces 0..nudp-1 are UDP in all shards
+static struct ccnl_shard_config_s ccnl_shard_cfg;
+static pthread_mutex_t ccnl_shard_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t ccnl_shard_cond = PTHREAD_COND_INITIALIZER;
+static int ccnl_shard_ready;            // shards which are set up
+static int ccnl_shard_go;               // 1: run, -1: a shard failed, stop
+static uint32_t ccnl_shard_fib_version; // FIB version last copied
+static void *ccnl_shard_sync_timer;
+
+static CCNL_THREAD_LOCAL struct ccnl_shard_s *ccnl_shard_self;
+
+uint32_t
+ccnl_shard_of(struct ccnl_prefix_s *pfx, uint32_t nshards)
+{
+    uint32_t cnt = pfx->compcnt < CCNL_SHARD_COMPS ? pfx->compcnt : CCNL_SHARD_COMPS;
+
+    // the high bits of the FNV hash are the better mixed ones
+    return (uint32_t) (((uint64_t) ccnl_prefix_hash(pfx, cnt) * nshards) >> 32);
+}
+
+static void
+ccnl_shard_signal(struct ccnl_shard_s *sh)
+{
+    uint64_t one = 1;
+
+    // pairs with the fence in ccnl_shard_wakeup(): either the consumer
+    // sees the committed message, or the producer sees the cleared flag
+    atomic_thread_fence(memory_order_seq_cst);
+    if (!atomic_exchange(&sh->signalled, 1) &&
+        write(sh->wakefd, &one, sizeof(one)) < 0) {
+        DEBUGMSG(WARNING, "shard %d: wakeup failed\n", sh->index);
+    }
+}
+
+// ----------------------------------------------------------------------
+// packets
+
+static int
+ccnl_shard_handoff(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+                   struct ccnl_pkt_s *pkt)
+{
+    struct ccnl_shard_s *to;
+    struct ccnl_shard_msg_s *msg;
+    uint8_t *data;
+    size_t len;
+    (void) relay;
+
+    // only UDP interfaces exist in all shards
+    if (!from || from->ifndx < 0 || from->ifndx >= ccnl_shard_nudp || !pkt->pfx) {
+        return 0;
+    }
+#if defined(USE_SUITE_CCNB) && defined(USE_MGMT)
+    // management requests change the FIB, which the first shard owns
+    if (pkt->suite == CCNL_SUITE_CCNB && pkt->pfx->compcnt == 4 &&
+        !memcmp(pkt->pfx->comp[0], "ccnx", 4)) {
+        to = ccnl_shards;
+    } else
+#endif
+    to = ccnl_shards + ccnl_shard_of(pkt->pfx, (uint32_t) ccnl_shard_count);
+    if (to == ccnl_shard_self) {
+        return 0;
+    }
+
+    if (pkt->flags & CCNL_PKT_VIEW) {
+        data = ((struct ccnl_pkt_view_s *) pkt)->start;
+        len = ((struct ccnl_pkt_view_s *) pkt)->len;
+    } else if (pkt->buf) {
+        data = pkt->buf->data;
+        len = pkt->buf->datalen;
+    } else {
+        return 0;
+    }
+    if (len > sizeof(msg->data)) {
+        return 0;
+    }
+
+    msg = (struct ccnl_shard_msg_s *) ccnl_ring_reserve(&to->ring);
+    if (!msg) {
+        DEBUGMSG(DEBUG, "shard %d: queue of shard %d full, packet dropped\n",
+                 ccnl_shard_self->index, to->index);
+        return 1;
+    }
+    msg->kind = CCNL_SHARD_PKT;
+    msg->ifndx = (int16_t) from->ifndx;
+    msg->peer = from->peer;
+    msg->addrlen = from->peer.sa.sa_family == AF_INET6 ? sizeof(from->peer.ip6)
+                                                       : sizeof(from->peer.ip4);
+    msg->len = len;
+    memcpy(msg->data, data, len);
+#ifdef USE_SUITE_CCNTLV
+    if (pkt->suite == CCNL_SUITE_CCNTLV) {
+        // the receiving shard decrements the hop limit again
+        struct ccnx_tlvhdr_ccnx2015_s *hp = (struct ccnx_tlvhdr_ccnx2015_s *) msg->data;
+
+        if (hp->pkttype == CCNX_PT_Interest || hp->pkttype == CCNX_PT_NACK) {
+            hp->hoplimit++;
+        }
+    }
+#endif
+    ccnl_ring_commit(&to->ring, msg);
+    ccnl_shard_signal(to);
+    atomic_fetch_add_explicit(&ccnl_shard_self->handed, 1, memory_order_relaxed);
+
+    return 1;
+}
+
+// ----------------------------------------------------------------------
+// FIB
+
+// removes the FIB entries, their faces may age from now on: the ageing
+// drops static faces from its queue, so they are queued again
+static void
+ccnl_shard_fib_clear(struct ccnl_relay_s *relay)
+{
+    while (relay->fib) {
+        struct ccnl_forward_s *fwd = relay->fib;
+        struct ccnl_face_s *face = fwd->face;
+
+        ccnl_fib_unlink(relay, fwd);
+        if (face) {
+            face->flags &= ~CCNL_FACE_FLAGS_STATIC;
+            if (!face->age_entry.obj) {
+                ccnl_ageq_add(&relay->face_ageq, &face->age_entry,
+                              face->last_used + CCNL_FACE_TIMEOUT, face);
+            }
+        }
+        ccnl_prefix_free(fwd->prefix);
+        ccnl_free(fwd);
+    }
+}
+
+static void
+ccnl_shard_fib_apply(struct ccnl_relay_s *relay, struct ccnl_shard_msg_s *msg)
+{
+    struct ccnl_shard_fib_rec_s rec;
+    uint8_t *cp = msg->data, *end = msg->data + msg->len;
+    uint8_t *comp[CCNL_MAX_NAME_COMP];
+    size_t complen[CCNL_MAX_NAME_COMP];
+    char strategy[32];
+    struct ccnl_prefix_s name, *pfx;
+    struct ccnl_forward_s *fwd;
+    struct ccnl_face_s *face;
+    sockunion peer;
+    uint32_t k;
+    uint16_t clen;
+    uint8_t *bytes;
+
+    if (msg->first) {
+        ccnl_shard_fib_clear(relay);
+    }
+    while (cp + sizeof(rec) <= end) {
+        memcpy(&rec, cp, sizeof(rec));
+        cp += sizeof(rec);
+        if (rec.addrlen > sizeof(peer) || rec.stratlen >= sizeof(strategy) ||
+            rec.compcnt > CCNL_MAX_NAME_COMP ||
+            (size_t) (end - cp) < rec.addrlen + rec.stratlen +
+                                  2 * rec.compcnt + rec.namelen) {
+            DEBUGMSG(WARNING, "shard %d: bad FIB record\n", ccnl_shard_self->index);
+            return;
+        }
+        memset(&peer, 0, sizeof(peer));
+        memcpy(&peer, cp, rec.addrlen);
+        cp += rec.addrlen;
+        memcpy(strategy, cp, rec.stratlen);
+        strategy[rec.stratlen] = '\0';
+        cp += rec.stratlen;
+        bytes = cp + 2 * rec.compcnt;
+        for (k = 0; k < rec.compcnt; k++, cp += 2) {
+            memcpy(&clen, cp, sizeof(clen));
+            comp[k] = bytes;
+            complen[k] = clen;
+            bytes += clen;
+        }
+        if (bytes != cp + rec.namelen) {
+            DEBUGMSG(WARNING, "shard %d: bad FIB record\n", ccnl_shard_self->index);
+            return;
+        }
+        cp = bytes;
+
+        memset(&name, 0, sizeof(name));
+        name.comp = comp;
+        name.complen = complen;
+        name.compcnt = rec.compcnt;
+        name.suite = (char) rec.suite;
+        face = ccnl_get_face_or_create(relay, rec.ifndx, &peer.sa, rec.addrlen);
+        pfx = ccnl_prefix_dup(&name);
+        fwd = (struct ccnl_forward_s *) ccnl_calloc(1, sizeof(*fwd));
+        if (!face || !pfx || !fwd) {
+            ccnl_free(fwd);
+            if (pfx) {
+                ccnl_prefix_free(pfx);
+            }
+            continue;
+        }
+        face->flags |= CCNL_FACE_FLAGS_STATIC;
+        fwd->suite = (char) rec.suite;
+        fwd->prefix = pfx;
+        fwd->face = face;
+        fwd->strategy = rec.stratlen ? ccnl_strategy_find(strategy) : NULL;
+        if (ccnl_fib_link(relay, fwd)) {
+            ccnl_prefix_free(pfx);
+            ccnl_free(fwd);
+        }
+    }
+}
+
+// appends the record of a FIB entry, returns -1 if it does not fit
+static int
+ccnl_shard_fib_record(struct ccnl_shard_msg_s *msg, struct ccnl_forward_s *fwd)
+{
+    struct ccnl_shard_fib_rec_s rec;
+    uint8_t *cp = msg->data + msg->len;
+    size_t need;
+    uint32_t k;
+    uint16_t clen;
+
+    memset(&rec, 0, sizeof(rec));
+    rec.ifndx = (int16_t) fwd->face->ifndx;
+    rec.suite = (uint8_t) fwd->suite;
+    rec.stratlen = fwd->strategy ? (uint8_t) strlen(fwd->strategy->name) : 0;
+    rec.addrlen = fwd->face->peer.sa.sa_family == AF_INET6 ? sizeof(fwd->face->peer.ip6)
+                                                           : sizeof(fwd->face->peer.ip4);
+    rec.compcnt = (uint16_t) fwd->prefix->compcnt;
+    for (k = 0; k < fwd->prefix->compcnt; k++) {
+        rec.namelen += fwd->prefix->complen[k];
+    }
+    need = sizeof(rec) + rec.addrlen + rec.stratlen + 2 * rec.compcnt + rec.namelen;
+    if (msg->len + need > sizeof(msg->data)) {
+        return -1;
+    }
+
+    memcpy(cp, &rec, sizeof(rec));
+    cp += sizeof(rec);
+    memcpy(cp, &fwd->face->peer, rec.addrlen);
+    cp += rec.addrlen;
+    if (rec.stratlen) {
+        memcpy(cp, fwd->strategy->name, rec.stratlen);
+        cp += rec.stratlen;
+    }
+    for (k = 0; k < rec.compcnt; k++, cp += 2) {
+        clen = (uint16_t) fwd->prefix->complen[k];
+        memcpy(cp, &clen, sizeof(clen));
+    }
+    for (k = 0; k < rec.compcnt; k++) {
+        memcpy(cp, fwd->prefix->comp[k], fwd->prefix->complen[k]);
+        cp += fwd->prefix->complen[k];
+    }
+    msg->len += need;
+    return 0;
+}
+
+// copies the FIB to shard sh, returns -1 if its ring is full
+static int
+ccnl_shard_fib_send(struct ccnl_relay_s *relay, struct ccnl_shard_s *sh)
+{
+    struct ccnl_shard_msg_s *msg;
+    struct ccnl_forward_s *fwd;
+
+    msg = (struct ccnl_shard_msg_s *) ccnl_ring_reserve(&sh->ring);
+    if (!msg) {
+        return -1;
+    }
+    msg->kind = CCNL_SHARD_FIB;
+    msg->first = 1;
+    msg->len = 0;
+    for (fwd = relay->fib; fwd; fwd = fwd->next) {
+        // local next hops (taps, other interfaces) stay in the first shard
+        if (fwd->tap || !fwd->face || !fwd->prefix ||
+            fwd->face->ifndx < 0 || fwd->face->ifndx >= ccnl_shard_nudp ||
+            fwd->prefix->compcnt > CCNL_MAX_NAME_COMP) {
+            continue;
+        }
+        if (!ccnl_shard_fib_record(msg, fwd)) {
+            continue;
+        }
+        ccnl_ring_commit(&sh->ring, msg);
+        msg = (struct ccnl_shard_msg_s *) ccnl_ring_reserve(&sh->ring);
+        if (!msg) {
+            ccnl_shard_signal(sh);
+            return -1;
+        }
+        msg->kind = CCNL_SHARD_FIB;
+        msg->first = 0;
+        msg->len = 0;
+        if (ccnl_shard_fib_record(msg, fwd)) {
+            DEBUGMSG(WARNING, "shard 0: FIB entry too large to copy\n");
+        }
+    }
+    ccnl_ring_commit(&sh->ring, msg);
+    ccnl_shard_signal(sh);
+    return 0;
+}
+
+static void
+ccnl_shard_sync(void *relay, void *aux)
+{
+    struct ccnl_relay_s *ccnl = (struct ccnl_relay_s *) relay;
+    uint32_t version = ccnl->fib_version;
+    int k, rc = 0;
+    (void) aux;
+
+    if (version != ccnl_shard_fib_version) {
+        for (k = 1; k < ccnl_shard_count; k++) {
+            rc |= ccnl_shard_fib_send(ccnl, ccnl_shards + k);
+        }
+        // a shard with a full ring gets a complete copy on the next round
+        if (!rc) {
+            ccnl_shard_fib_version = version;
+        }
+    }
+    ccnl_shard_sync_timer = ccnl_set_timer(CCNL_SHARD_SYNC_INTERVAL,
+                                           ccnl_shard_sync, relay, NULL);
+}
+
+// ----------------------------------------------------------------------
+// shards
+
+static void
+ccnl_shard_wakeup(struct ccnl_relay_s *relay)
+{
+    struct ccnl_shard_s *sh = ccnl_shard_self;
+    struct ccnl_shard_msg_s *msg;
+    uint64_t cnt;
+    int budget = CCNL_SHARD_BATCH;
+
+    if (read(sh->wakefd, &cnt, sizeof(cnt)) < 0) {
+        // nothing to read: woken up by an earlier round
+    }
+    atomic_store(&sh->signalled, 0);
+    atomic_thread_fence(memory_order_seq_cst);
+
+    while (budget-- > 0 &&
+           (msg = (struct ccnl_shard_msg_s *) ccnl_ring_peek(&sh->ring))) {
+        switch (msg->kind) {
+        case CCNL_SHARD_PKT:
+            ccnl_core_RX(relay, msg->ifndx, msg->data, msg->len,
+                         &msg->peer.sa, msg->addrlen);
+            break;
+        case CCNL_SHARD_FIB:
+            ccnl_shard_fib_apply(relay, msg);
+            break;
+        case CCNL_SHARD_HALT:
+            relay->halt_flag = 1;
+            break;
+        default:
+            break;
+        }
+        ccnl_ring_release(&sh->ring);
+    }
+    if (ccnl_ring_peek(&sh->ring)) { // budget used up: come back later
+        ccnl_shard_signal(sh);
+    }
+}
+
+static void*
+ccnl_shard_main(void *arg)
+{
+    struct ccnl_shard_s *sh = (struct ccnl_shard_s *) arg;
+    struct ccnl_relay_s *first = ccnl_shards[0].relay, *relay;
+
+    ccnl_shard_self = sh;
+    // configured in this thread: the timers and pools are per thread
+    relay = (struct ccnl_relay_s *) ccnl_calloc(1, sizeof(*relay));
+    if (relay) {
+        sh->relay = relay;
+        relay->startup_time = first->startup_time;
+        relay->id = sh->index;
+        relay->if_qlen = first->if_qlen;
+        ccnl_relay_config(relay, NULL, NULL, ccnl_shard_cfg.udpport1,
+                          ccnl_shard_cfg.udpport2, ccnl_shard_cfg.udp6port1,
+                          ccnl_shard_cfg.udp6port2, 0, NULL,
+                          ccnl_shard_cfg.suite, first->max_cache_entries, NULL);
+        ccnl_cs_set_policy(relay, first->cs_policy.type);
+        if (first->cs_sketch.counters) {
+            ccnl_cs_set_admission(relay, first->cs_sketch.mask + 1);
+        }
+        ccnl_nonce_filter_config(&relay->nonce_filter,
+                                 first->nonce_filter.capacity,
+                                 first->nonce_filter.window);
+        relay->max_cache_bytes = first->max_cache_bytes;
+        relay->max_pit_entries = first->max_pit_entries;
+        relay->strategy = first->strategy;
+        relay->ccnl_handoff_ptr = ccnl_shard_handoff;
+    }
+    if (!relay || relay->ifcount != ccnl_shard_nudp) {
+        DEBUGMSG(ERROR, "shard %d: could not open the UDP ports\n", sh->index);
+        sh->failed = 1;
+    }
+    pthread_mutex_lock(&ccnl_shard_lock);
+    ccnl_shard_ready++;
+    pthread_cond_broadcast(&ccnl_shard_cond);
+    while (!ccnl_shard_go) {
+        pthread_cond_wait(&ccnl_shard_cond, &ccnl_shard_lock);
+    }
+    pthread_mutex_unlock(&ccnl_shard_lock);
+
+    if (ccnl_shard_go > 0) {
+        // the first shard has filled the store already
+        if (ccnl_shard_cfg.storedir) {
+            if (ccnl_cs_store_attach(relay, ccnl_shard_cfg.storedir, NULL,
+                                     ccnl_shard_cfg.store_max)) {
+                DEBUGMSG(ERROR, "shard %d: could not open the store\n", sh->index);
+            }
+        } else if (ccnl_shard_cfg.datadir) {
+            ccnl_populate_cache(relay, ccnl_shard_cfg.datadir);
+        }
+        ccnl_io_set_wakeup(sh->wakefd, ccnl_shard_wakeup);
+        DEBUGMSG(INFO, "shard %d running\n", sh->index);
+        ccnl_io_loop(relay);
+        ccnl_io_set_wakeup(-1, NULL);
+    }
+
+    ccnl_timer_cleanup();
+    if (relay) {
+        ccnl_cs_store_detach(relay);
+        ccnl_core_cleanup(relay);
+        ccnl_free(relay);
+    }
+    return NULL;
+}
+
+static void
+ccnl_shard_free(void)
+{
+    int k;
+
+    for (k = 0; k < ccnl_shard_count; k++) {
+        ccnl_ring_cleanup(&ccnl_shards[k].ring);
+        if (ccnl_shards[k].wakefd >= 0) {
+            close(ccnl_shards[k].wakefd);
+        }
+    }
+    ccnl_free(ccnl_shards);
+    ccnl_shards = NULL;
+    ccnl_shard_count = 0;
+}
+
+int
+ccnl_shard_start(struct ccnl_relay_s *relay, int nshards,
+                 struct ccnl_shard_config_s *cfg)
+{
+    int k, started = 1;
+
+    if (nshards < 2 || nshards > CCNL_MAX_SHARDS) {
+        return -1;
+    }
+    ccnl_shard_nudp = 0;
+    while (ccnl_shard_nudp < relay->ifcount &&
+           (relay->ifs[ccnl_shard_nudp].addr.sa.sa_family == AF_INET ||
+            relay->ifs[ccnl_shard_nudp].addr.sa.sa_family == AF_INET6)) {
+        ccnl_shard_nudp++;
+    }
+    if (!ccnl_shard_nudp) {
+        DEBUGMSG(ERROR, "sharding needs the UDP interfaces to come first\n");
+        return -1;
+    }
+
+    ccnl_shards = (struct ccnl_shard_s *) ccnl_calloc(nshards, sizeof(*ccnl_shards));
+    if (!ccnl_shards) {
+        return -1;
+    }
+    ccnl_shard_count = nshards;
+    ccnl_shard_cfg = *cfg;
+    for (k = 0; k < nshards; k++) {
+        struct ccnl_shard_s *sh = ccnl_shards + k;
+
+        sh->index = k;
+        sh->wakefd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (sh->wakefd < 0 ||
+            ccnl_ring_init(&sh->ring, CCNL_SHARD_QLEN, sizeof(struct ccnl_shard_msg_s))) {
+            DEBUGMSG(ERROR, "no memory for the shard queues\n");
+            ccnl_shard_free();
+            return -1;
+        }
+    }
+    ccnl_shards[0].relay = relay;
+    ccnl_shard_self = ccnl_shards;
+
+    ccnl_shard_ready = ccnl_shard_go = 0;
+    for (k = 1; k < nshards; k++) {
+        if (pthread_create(&ccnl_shards[k].thread, NULL, ccnl_shard_main,
+                           ccnl_shards + k)) {
+            DEBUGMSG(ERROR, "could not start shard %d\n", k);
+            break;
+        }
+        started++;
+    }
+
+    // the shards wait until all of them are set up
+    pthread_mutex_lock(&ccnl_shard_lock);
+    while (ccnl_shard_ready < started - 1) {
+        pthread_cond_wait(&ccnl_shard_cond, &ccnl_shard_lock);
+    }
+    ccnl_shard_go = started < nshards ? -1 : 1;
+    for (k = 1; k < started; k++) {
+        if (ccnl_shards[k].failed) {
+            ccnl_shard_go = -1;
+        }
+    }
+    pthread_cond_broadcast(&ccnl_shard_cond);
+    pthread_mutex_unlock(&ccnl_shard_lock);
+
+    if (ccnl_shard_go < 0) {
+        for (k = 1; k < started; k++) {
+            pthread_join(ccnl_shards[k].thread, NULL);
+        }
+        ccnl_shard_free();
+        return -1;
+    }
+
+    relay->ccnl_handoff_ptr = ccnl_shard_handoff;
+    ccnl_io_set_wakeup(ccnl_shards[0].wakefd, ccnl_shard_wakeup);
+    ccnl_shard_fib_version = relay->fib_version - 1; // copy the initial FIB
+    ccnl_shard_sync(relay, NULL);
+    DEBUGMSG(INFO, "relay sharded over %d threads\n", nshards);
+    return 0;
+}
+
+void
+ccnl_shard_stop(void)
+{
+    struct ccnl_shard_msg_s *msg;
+    int k;
+
+    if (!ccnl_shards) {
+        return;
+    }
+    ccnl_rem_timer(ccnl_shard_sync_timer);
+    ccnl_io_set_wakeup(-1, NULL);
+    ccnl_shards[0].relay->ccnl_handoff_ptr = NULL;
+    for (k = 1; k < ccnl_shard_count; k++) {
+        while (!(msg = (struct ccnl_shard_msg_s *) ccnl_ring_reserve(&ccnl_shards[k].ring))) {
+            sched_yield();
+        }
+        msg->kind = CCNL_SHARD_HALT;
+        ccnl_ring_commit(&ccnl_shards[k].ring, msg);
+        ccnl_shard_signal(ccnl_shards + k);
+    }
+    for (k = 1; k < ccnl_shard_count; k++) {
+        pthread_join(ccnl_shards[k].thread, NULL);
+    }
+    for (k = 0; k < ccnl_shard_count; k++) {
+        struct ccnl_ring_s *r = &ccnl_shards[k].ring;
+
+        DEBUGMSG(INFO, "shard %d: %u packets passed on, queue max %u of %u, "
+                 "%u dropped\n", k, atomic_load(&ccnl_shards[k].handed),
+                 (unsigned) atomic_load(&r->highwater), r->depth,
+                 (unsigned) atomic_load(&r->drops));
+    }
+    ccnl_shard_free();
+}
+
+#endif // USE_SHARDS
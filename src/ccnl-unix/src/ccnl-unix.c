@@ -20,7 +20,12 @@
  * 2017-06-16 created
  */
 
+#ifdef USE_MMSG
+#define _GNU_SOURCE // recvmmsg(), sendmmsg()
+#endif
+
 #include "ccnl-unix.h"
+#include "ccnl-cs-store.h"
 
 #include "ccnl-os-includes.h"
 
@@ -153,6 +158,25 @@ ccnl_open_unixpath(char *path, struct sockaddr_un *ux)
 #endif // USE_UNIXSOCKET
 
 
+#ifdef USE_SHARDS
+int ccnl_udp_reuseport;
+
+// lets the shards of a relay bind the same UDP ports, the kernel spreads
+// the received datagrams over their sockets by the peer's address
+static int
+ccnl_udp_set_reuseport(int s)
+{
+    int opt_value = 1;
+
+    if (ccnl_udp_reuseport &&
+        setsockopt(s, SOL_SOCKET, SO_REUSEPORT, &opt_value, sizeof(opt_value)) < 0) {
+        perror("udp SO_REUSEPORT");
+        return -1;
+    }
+    return 0;
+}
+#endif
+
 #ifdef USE_IPV4
 int
 ccnl_open_udpdev(uint16_t port, struct sockaddr_in *si)
@@ -169,6 +193,12 @@ ccnl_open_udpdev(uint16_t port, struct sockaddr_in *si)
     si->sin_addr.s_addr = INADDR_ANY;
     si->sin_port = htons(port);
     si->sin_family = PF_INET;
+#ifdef USE_SHARDS
+    if (ccnl_udp_set_reuseport(s) < 0) {
+        close(s);
+        return -1;
+    }
+#endif
     if (bind(s, (struct sockaddr *)si, sizeof(*si)) < 0) {
         perror("udp sock bind");
         return -1;
@@ -203,6 +233,12 @@ ccnl_open_udp6dev(uint16_t port, struct sockaddr_in6 *sin)
     sin->sin6_addr = in6addr_any;
     sin->sin6_port = htons(port);
     sin->sin6_family = PF_INET6;
+#ifdef USE_SHARDS
+    if (ccnl_udp_set_reuseport(s) < 0) {
+        close(s);
+        return -1;
+    }
+#endif
     if (bind(s, (struct sockaddr *)sin, sizeof(*sin)) < 0) {
         perror("udp sock bind");
         return -1;
@@ -284,7 +320,7 @@ void ccnl_ageing(void *relay, void *aux)
     }
 
     ccnl_do_ageing(relay, aux);
-    ccnl_set_timer(1000000, ccnl_ageing, relay, 0);
+    ccnl_set_timer(CCNL_AGEING_INTERVAL, ccnl_ageing, relay, 0);
 }
 
 #if defined(USE_IPV4) || defined(USE_IPV6)
@@ -336,6 +372,7 @@ ccnl_relay_udp(struct ccnl_relay_s *relay, int32_t sport, int af, int suite)
     }
 #endif
     i->fwdalli = 1;
+    ccnl_interface_qinit(i, relay->if_qlen);
     relay->ifcount++;
     DEBUGMSG(INFO, "UDP interface (%s) configured\n",
              ccnl_addr2ascii(&i->addr));
@@ -417,6 +454,73 @@ ccnl_ll_TX(struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc,
     (void) rc; // just to silence a compiler warning (if USE_DEBUG is not set)
 }
 
+#ifdef USE_MMSG
+int
+ccnl_ll_TXv(struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc,
+            struct ccnl_txrequest_s **reqs, int cnt)
+{
+    struct mmsghdr msgs[CCNL_MAX_IF_QLEN];
+    struct iovec iov[CCNL_MAX_IF_QLEN];
+    int k, rc;
+
+    for (k = 0; k < cnt && k < CCNL_MAX_IF_QLEN; k++) {
+        sockunion *dest = &reqs[k]->dst;
+        socklen_t len;
+
+        switch (dest->sa.sa_family) {
+#ifdef USE_IPV4
+        case AF_INET:
+            len = sizeof(struct sockaddr_in);
+            break;
+#endif
+#ifdef USE_IPV6
+        case AF_INET6:
+            len = sizeof(struct sockaddr_in6);
+            break;
+#endif
+#ifdef USE_UNIXSOCKET
+        case AF_UNIX:
+            len = sizeof(struct sockaddr_un);
+            break;
+#endif
+        default:
+            len = 0;
+            break;
+        }
+        if (!len) {
+            break;
+        }
+        iov[k].iov_base = reqs[k]->buf->data;
+        iov[k].iov_len = reqs[k]->buf->datalen;
+        memset(&msgs[k], 0, sizeof(msgs[k]));
+        msgs[k].msg_hdr.msg_name = &dest->sa;
+        msgs[k].msg_hdr.msg_namelen = len;
+        msgs[k].msg_hdr.msg_iov = &iov[k];
+        msgs[k].msg_hdr.msg_iovlen = 1;
+    }
+    if (k == 0) {
+        // link layer frames are not sent with sendmsg()
+        ccnl_ll_TX(ccnl, ifc, &reqs[0]->dst, reqs[0]->buf);
+        return 1;
+    }
+
+    rc = sendmmsg(ifc->sock, msgs, (unsigned int) k, 0);
+    DEBUGMSG(DEBUG, "sendmmsg of %d packets returned %d\n", k, rc);
+    if (rc < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return 0;
+        }
+        // like ccnl_ll_TX(), drop a packet which cannot be sent
+        return 1;
+    }
+#ifdef USE_STATS
+    ifc->tx_batch_cnt++;
+    ifc->tx_batch_pkts += (uint32_t) rc;
+#endif
+    return rc;
+}
+#endif // USE_MMSG
+
 void
 ccnl_relay_config(struct ccnl_relay_s *relay, char *ethdev, char *wpandev,
                   int32_t udpport1, int32_t udpport2,
@@ -438,7 +542,6 @@ ccnl_relay_config(struct ccnl_relay_s *relay, char *ethdev, char *wpandev,
     relay->pit = NULL;
     relay->fib = NULL;
     relay->faces = NULL;
-    relay->nonces = NULL;
     relay->max_cache_entries = max_cache_entries;
     relay->max_pit_entries = CCNL_DEFAULT_MAX_PIT_ENTRIES;
     relay->ccnl_ll_TX_ptr = &ccnl_ll_TX;
@@ -456,6 +559,7 @@ ccnl_relay_config(struct ccnl_relay_s *relay, char *ethdev, char *wpandev,
         i->reflect = 1;
         i->fwdalli = 1;
         if (i->sock >= 0) {
+            ccnl_interface_qinit(i, relay->if_qlen);
             relay->ifcount++;
             DEBUGMSG(INFO, "ETH interface (%s %s) configured\n",
                      ethdev, ccnl_addr2ascii(&i->addr));
@@ -475,6 +579,7 @@ ccnl_relay_config(struct ccnl_relay_s *relay, char *ethdev, char *wpandev,
         i->reflect = 1;
         i->fwdalli = 1;
         if (i->sock >= 0) {
+            ccnl_interface_qinit(i, relay->if_qlen);
             relay->ifcount++;
             DEBUGMSG(INFO, "WPAN interface (%s %s) configured\n",
                      wpandev, ccnl_addr2ascii(&i->addr));
@@ -508,6 +613,7 @@ ccnl_relay_config(struct ccnl_relay_s *relay, char *ethdev, char *wpandev,
         i->sock = ccnl_open_unixpath(uxpath, &i->addr.ux);
         i->mtu = 4096;
         if (i->sock >= 0) {
+            ccnl_interface_qinit(i, relay->if_qlen);
             relay->ifcount++;
             DEBUGMSG(INFO, "UNIX interface (%s) configured\n",
                      ccnl_addr2ascii(&i->addr));
@@ -525,6 +631,7 @@ ccnl_relay_config(struct ccnl_relay_s *relay, char *ethdev, char *wpandev,
         i->sock = ccnl_open_unixpath(crypto_face_path, &i->addr.ux);
         i->mtu = 4096;
         if (i->sock >= 0) {
+            ccnl_interface_qinit(i, relay->if_qlen);
             relay->ifcount++;
             DEBUGMSG(INFO, "new UNIX interface (%s) configured\n",
                      ccnl_addr2ascii(&i->addr));
@@ -543,6 +650,7 @@ ccnl_relay_config(struct ccnl_relay_s *relay, char *ethdev, char *wpandev,
         i->sock = ccnl_open_unixpath(h, &i->addr.ux);
         i->mtu = 4096;
         if (i->sock >= 0) {
+            ccnl_interface_qinit(i, relay->if_qlen);
             relay->ifcount++;
             DEBUGMSG(INFO, "new UNIX interface (%s) configured\n",
                      ccnl_addr2ascii(&i->addr));
@@ -556,32 +664,430 @@ ccnl_relay_config(struct ccnl_relay_s *relay, char *ethdev, char *wpandev,
 #endif //USE_SIGNATURES
 #endif // USE_UNIXSOCKET
 
-    ccnl_set_timer(1000000, ccnl_ageing, relay, 0);
+    ccnl_set_timer(CCNL_AGEING_INTERVAL, ccnl_ageing, relay, 0);
 }
 
-int
-ccnl_io_loop(struct ccnl_relay_s *ccnl)
+#ifdef USE_EPOLL
+int ccnl_io_use_select;
+#endif
+
+// descriptor which wakes up the I/O loop of this thread, see
+// ccnl_io_set_wakeup()
+static CCNL_THREAD_LOCAL int ccnl_io_wakeup_fd = -1;
+static CCNL_THREAD_LOCAL void (*ccnl_io_wakeup_cb)(struct ccnl_relay_s*);
+
+void
+ccnl_io_set_wakeup(int fd, void (*cb)(struct ccnl_relay_s*))
+{
+    ccnl_io_wakeup_fd = cb ? fd : -1;
+    ccnl_io_wakeup_cb = cb;
+}
+
+// hands a packet which was received on interface i to the core
+static void
+ccnl_io_dispatch(struct ccnl_relay_s *ccnl, int i, unsigned char *buf,
+                 size_t len, sockunion *src_addr)
+{
+    if (0) {}
+#ifdef USE_IPV4
+    else if (src_addr->sa.sa_family == AF_INET) {
+        ccnl_core_RX(ccnl, i, buf, len,
+                     &src_addr->sa, sizeof(src_addr->ip4));
+    }
+#endif
+#ifdef USE_IPV6
+    else if (src_addr->sa.sa_family == AF_INET6) {
+        ccnl_core_RX(ccnl, i, buf, len,
+                     &src_addr->sa, sizeof(src_addr->ip6));
+    }
+#endif
+#ifdef USE_LINKLAYER
+    else if (src_addr->sa.sa_family == AF_PACKET) {
+        if (len > 14) {
+            ccnl_core_RX(ccnl, i, buf + 14, len - 14,
+                         &src_addr->sa, sizeof(src_addr->linklayer));
+        }
+    }
+#endif
+#ifdef USE_WPAN
+    else if (src_addr->sa.sa_family == AF_IEEE802154) {
+        if (len > 14) {
+            ccnl_core_RX(ccnl, i, buf, len,
+                         &src_addr->sa, sizeof(src_addr->linklayer));
+        }
+    }
+#endif
+#ifdef USE_UNIXSOCKET
+    else if (src_addr->sa.sa_family == AF_UNIX) {
+        ccnl_core_RX(ccnl, i, buf, len,
+                     &src_addr->sa, sizeof(src_addr->ux));
+    }
+#endif
+}
+
+// receives one packet from interface i and hands it to the core,
+// returns the result of recvfrom()
+static ssize_t
+ccnl_io_recv(struct ccnl_relay_s *ccnl, int i, unsigned char *buf,
+             size_t bufsize, int flags)
+{
+    sockunion src_addr;
+    socklen_t addrlen = sizeof(sockunion);
+    ssize_t recvlen;
+
+    if ((recvlen = recvfrom(ccnl->ifs[i].sock, buf, bufsize, flags,
+                            (struct sockaddr*) &src_addr, &addrlen)) > 0) {
+        ccnl_io_dispatch(ccnl, i, buf, (size_t) recvlen, &src_addr);
+    }
+    return recvlen;
+}
+
+#ifdef USE_MMSG
+int ccnl_io_rx_batch = CCNL_RX_BATCH;
+int ccnl_io_tx_batch = 1;
+
+// buffers of the batched receive path, they are allocated when the I/O
+// loop starts and reused for every batch
+struct ccnl_io_rxbatch_s {
+    unsigned int size;          // number of messages per batch, 0: no batching
+    unsigned char *bufs;        // size buffers of CCNL_MAX_PACKET_SIZE bytes
+    struct mmsghdr *msgs;
+    struct iovec *iov;
+    sockunion *addrs;
+};
+
+static int
+ccnl_io_rxbatch_init(struct ccnl_io_rxbatch_s *b, int size)
+{
+    memset(b, 0, sizeof(*b));
+    if (size <= 1) {
+        return 0;
+    }
+    if (size > CCNL_MAX_RX_BATCH) {
+        size = CCNL_MAX_RX_BATCH;
+    }
+    b->bufs = (unsigned char*) ccnl_malloc((size_t) size * CCNL_MAX_PACKET_SIZE);
+    b->msgs = (struct mmsghdr*) ccnl_calloc((size_t) size, sizeof(struct mmsghdr));
+    b->iov = (struct iovec*) ccnl_calloc((size_t) size, sizeof(struct iovec));
+    b->addrs = (sockunion*) ccnl_calloc((size_t) size, sizeof(sockunion));
+    if (!b->bufs || !b->msgs || !b->iov || !b->addrs) {
+        ccnl_free(b->bufs);
+        ccnl_free(b->msgs);
+        ccnl_free(b->iov);
+        ccnl_free(b->addrs);
+        memset(b, 0, sizeof(*b));
+        return -1;
+    }
+    b->size = (unsigned int) size;
+    return 0;
+}
+
+static void
+ccnl_io_rxbatch_cleanup(struct ccnl_io_rxbatch_s *b)
+{
+    if (b->size) {
+        ccnl_free(b->bufs);
+        ccnl_free(b->msgs);
+        ccnl_free(b->iov);
+        ccnl_free(b->addrs);
+    }
+    memset(b, 0, sizeof(*b));
+}
+
+// receives up to b->size packets from interface i with one system call
+// and hands them to the core, returns the number of packets or -1
+static int
+ccnl_io_recv_batch(struct ccnl_relay_s *ccnl, int i,
+                   struct ccnl_io_rxbatch_s *b)
+{
+    unsigned int k;
+    int n;
+
+    for (k = 0; k < b->size; k++) {
+        b->iov[k].iov_base = b->bufs + k * CCNL_MAX_PACKET_SIZE;
+        b->iov[k].iov_len = CCNL_MAX_PACKET_SIZE;
+        memset(&b->msgs[k].msg_hdr, 0, sizeof(struct msghdr));
+        b->msgs[k].msg_hdr.msg_name = &b->addrs[k];
+        b->msgs[k].msg_hdr.msg_namelen = sizeof(sockunion);
+        b->msgs[k].msg_hdr.msg_iov = &b->iov[k];
+        b->msgs[k].msg_hdr.msg_iovlen = 1;
+    }
+    // never wait for a batch to fill up
+    n = recvmmsg(ccnl->ifs[i].sock, b->msgs, b->size, MSG_DONTWAIT, NULL);
+    if (n <= 0) {
+        return n < 0 ? -1 : 0;
+    }
+#ifdef USE_STATS
+    ccnl->ifs[i].rx_batch_cnt++;
+    ccnl->ifs[i].rx_batch_pkts += (uint32_t) n;
+#endif
+    for (k = 0; k < (unsigned int) n && !ccnl->halt_flag; k++) {
+        if (b->msgs[k].msg_len > 0) {
+            ccnl_io_dispatch(ccnl, i, b->iov[k].iov_base,
+                             b->msgs[k].msg_len, &b->addrs[k]);
+        }
+    }
+    return n;
+}
+#endif // USE_MMSG
+
+#ifdef USE_MMSG
+static CCNL_THREAD_LOCAL struct ccnl_io_rxbatch_s rxbatch;
+#endif
+
+// tells whether to go on draining an interface after a failed receive:
+// an interrupted call or an ICMP error queued at a UDP socket only fails
+// one call, the datagrams behind it are still to be read
+static int
+ccnl_io_rx_retry(void)
+{
+    switch (errno) {
+    case EAGAIN:
+#if EWOULDBLOCK != EAGAIN
+    case EWOULDBLOCK:
+#endif
+    case EBADF:
+    case ENOTSOCK:
+    case EINVAL:
+    case EFAULT:
+    case ENOMEM:
+        return 0;
+    default:
+        return 1;
+    }
+}
+
+// reads from a readable interface, with drain set until the socket
+// would block
+static void
+ccnl_io_rx(struct ccnl_relay_s *ccnl, int i, unsigned char *buf,
+           size_t bufsize, int drain)
+{
+#ifdef USE_MMSG
+    if (rxbatch.size) {
+        int n;
+
+        // a batch which is not full leaves the socket empty
+        do {
+            n = ccnl_io_recv_batch(ccnl, i, &rxbatch);
+            if (n < 0 && !ccnl_io_rx_retry()) {
+                break;
+            }
+        } while (drain && !ccnl->halt_flag &&
+                 (n < 0 || n == (int) rxbatch.size));
+        return;
+    }
+#endif
+    if (!drain) {
+        ccnl_io_recv(ccnl, i, buf, bufsize, 0);
+        return;
+    }
+    while (!ccnl->halt_flag) {
+        if (ccnl_io_recv(ccnl, i, buf, bufsize, MSG_DONTWAIT) < 0 &&
+            !ccnl_io_rx_retry()) {
+            break;
+        }
+    }
+}
+
+// sends what the last round of events has queued at the interfaces
+static void
+ccnl_io_flush(struct ccnl_relay_s *ccnl)
+{
+    int i;
+
+    for (i = 0; i < ccnl->ifcount; i++) {
+        if (ccnl_interface_qlen(ccnl->ifs + i) > 0) {
+            ccnl_interface_flush(ccnl, ccnl->ifs + i);
+        }
+    }
+}
+
+#ifdef USE_EPOLL
+
+// epoll tags of the sockets which are not interfaces
+#define CCNL_IO_HTTP_SERVER     CCNL_MAX_INTERFACES
+#define CCNL_IO_HTTP_CLIENT     (CCNL_MAX_INTERFACES + 1)
+#define CCNL_IO_WAKEUP          (CCNL_MAX_INTERFACES + 2)
+
+// changes the events a socket is registered for, *cur holds the current
+// events (0: not registered)
+static int
+ccnl_io_epoll_set(int epfd, int fd, uint32_t tag, uint32_t events,
+                  uint32_t *cur)
+{
+    struct epoll_event ev;
+    int op = !*cur ? EPOLL_CTL_ADD : (events ? EPOLL_CTL_MOD : EPOLL_CTL_DEL);
+
+    if (!*cur && !events) {
+        return 0;
+    }
+    memset(&ev, 0, sizeof(ev));
+    ev.events = events;
+    ev.data.u32 = tag;
+    if (epoll_ctl(epfd, op, fd, &ev) < 0) {
+        return -1;
+    }
+    *cur = events;
+    return 0;
+}
+
+// the interfaces are edge-triggered and drained until they would block,
+// write interest is only registered while an interface has a queue
+static int
+ccnl_io_loop_epoll(struct ccnl_relay_s *ccnl)
+{
+    struct epoll_event events[CCNL_MAX_INTERFACES + 3];
+    uint32_t ifevents[CCNL_MAX_INTERFACES], ifout[CCNL_MAX_INTERFACES];
+    uint32_t wakeevents = 0;
+    unsigned char buf[CCNL_MAX_PACKET_SIZE];
+    int epfd, i, n, rc;
+#ifdef USE_HTTP_STATUS
+    uint32_t srvevents = 0, clievents = 0, want;
+    int clifd = 0;
+#endif
+
+    epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (epfd < 0) {
+        perror("epoll_create1(): ");
+        return -1;
+    }
+    memset(ifevents, 0, sizeof(ifevents));
+    memset(ifout, 0, sizeof(ifout));
+    for (i = 0; i < ccnl->ifcount; i++) {
+        if (ccnl_io_epoll_set(epfd, ccnl->ifs[i].sock, i,
+                              EPOLLIN | EPOLLET, &ifevents[i]) < 0) {
+            perror("epoll_ctl(): ");
+            close(epfd);
+            return -1;
+        }
+    }
+    if (ccnl_io_wakeup_fd >= 0 &&
+        ccnl_io_epoll_set(epfd, ccnl_io_wakeup_fd, CCNL_IO_WAKEUP,
+                          EPOLLIN, &wakeevents) < 0) {
+        perror("epoll_ctl(): ");
+        close(epfd);
+        return -1;
+    }
+
+    DEBUGMSG(INFO, "starting main event and IO loop (epoll)\n");
+    while (!ccnl->halt_flag) {
+        int usec = ccnl_run_events();
+
+        ccnl_io_flush(ccnl);
+
+#ifdef USE_HTTP_STATUS
+        if (ccnl->http) {
+            struct ccnl_http_s *http = ccnl->http;
+
+            // one client at a time: listen only while there is none
+            want = http->client ? 0 : EPOLLIN;
+            if (want != srvevents &&
+                ccnl_io_epoll_set(epfd, http->server, CCNL_IO_HTTP_SERVER,
+                                  want, &srvevents) < 0) {
+                perror("epoll_ctl(): ");
+            }
+            if (clifd && clifd != http->client) {
+                clievents = 0; // closed, the descriptor left the epoll set
+            }
+            clifd = http->client;
+            want = 0;
+            if (clifd) {
+                if ((unsigned long)http->inlen < sizeof(http->in)) {
+                    want |= EPOLLIN;
+                }
+                if (http->outlen > 0) {
+                    want |= EPOLLOUT;
+                }
+            }
+            if (want != clievents &&
+                ccnl_io_epoll_set(epfd, clifd, CCNL_IO_HTTP_CLIENT,
+                                  want, &clievents) < 0) {
+                perror("epoll_ctl(): ");
+            }
+        }
+#endif
+        for (i = 0; i < ccnl->ifcount; i++) {
+            size_t qlen = ccnl_interface_qlen(ccnl->ifs + i);
+            uint32_t want = qlen > 0 ? EPOLLIN | EPOLLOUT | EPOLLET
+                                     : EPOLLIN | EPOLLET;
+            // re-arming also re-reports a socket which is still writable
+            if ((want != ifevents[i] || (ifout[i] && qlen > 0)) &&
+                ccnl_io_epoll_set(epfd, ccnl->ifs[i].sock, i, want,
+                                  &ifevents[i]) < 0) {
+                perror("epoll_ctl(): ");
+            }
+            ifout[i] = 0;
+        }
+
+        rc = epoll_wait(epfd, events, sizeof(events) / sizeof(events[0]),
+                        usec >= 0 ? (usec + 999) / 1000 : -1);
+        if (rc < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("epoll_wait(): ");
+            exit(EXIT_FAILURE);
+        }
+
+        for (n = 0; n < rc; n++) {
+            uint32_t tag = events[n].data.u32;
+#ifdef USE_HTTP_STATUS
+            if (tag == CCNL_IO_HTTP_SERVER || tag == CCNL_IO_HTTP_CLIENT) {
+                uint32_t ev = events[n].events;
+                ccnl_http_io(ccnl, ccnl->http,
+                             tag == CCNL_IO_HTTP_SERVER && (ev & EPOLLIN),
+                             tag == CCNL_IO_HTTP_CLIENT && (ev & (EPOLLIN | EPOLLHUP | EPOLLERR)),
+                             tag == CCNL_IO_HTTP_CLIENT && (ev & EPOLLOUT));
+                continue;
+            }
+#endif
+            if (tag == CCNL_IO_WAKEUP) {
+                ccnl_io_wakeup_cb(ccnl);
+                continue;
+            }
+            if (tag >= (uint32_t) ccnl->ifcount) {
+                continue;
+            }
+            i = (int) tag;
+            if (events[n].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) {
+                ccnl_io_rx(ccnl, i, buf, sizeof(buf), 1);
+            }
+            if ((events[n].events & EPOLLOUT) && ccnl_interface_qlen(ccnl->ifs + i) > 0) {
+                ccnl_interface_CTS(ccnl, ccnl->ifs + i);
+                ifout[i] = 1;
+            }
+        }
+    }
+
+    close(epfd);
+    return 0;
+}
+
+#endif // USE_EPOLL
+
+static int
+ccnl_io_loop_select(struct ccnl_relay_s *ccnl)
 {
     int i, maxfd = -1, rc;
-    size_t len;
     fd_set readfs, writefs;
     unsigned char buf[CCNL_MAX_PACKET_SIZE];
 
-    if (ccnl->ifcount == 0) {
-        DEBUGMSG(ERROR, "no socket to work with, not good, quitting\n");
-        exit(EXIT_FAILURE);
-    }
     for (i = 0; i < ccnl->ifcount; i++) {
         if (ccnl->ifs[i].sock > maxfd) {
             maxfd = ccnl->ifs[i].sock;
         }
     }
+    if (ccnl_io_wakeup_fd > maxfd) {
+        maxfd = ccnl_io_wakeup_fd;
+    }
     maxfd++;
 
     DEBUGMSG(INFO, "starting main event and IO loop\n");
     while (!ccnl->halt_flag) {
-        int usec;
+        int usec = ccnl_run_events();
 
+        ccnl_io_flush(ccnl);
         FD_ZERO(&readfs);
         FD_ZERO(&writefs);
 
@@ -590,12 +1096,14 @@ ccnl_io_loop(struct ccnl_relay_s *ccnl)
 #endif
         for (i = 0; i < ccnl->ifcount; i++) {
             FD_SET(ccnl->ifs[i].sock, &readfs);
-            if (ccnl->ifs[i].qlen > 0) {
+            if (ccnl_interface_qlen(ccnl->ifs + i) > 0) {
                 FD_SET(ccnl->ifs[i].sock, &writefs);
             }
         }
+        if (ccnl_io_wakeup_fd >= 0) {
+            FD_SET(ccnl_io_wakeup_fd, &readfs);
+        }
 
-        usec = ccnl_run_events();
         if (usec >= 0) {
             struct timeval deadline;
             deadline.tv_sec = usec / 1000000;
@@ -613,50 +1121,12 @@ ccnl_io_loop(struct ccnl_relay_s *ccnl)
 #ifdef USE_HTTP_STATUS
         ccnl_http_postselect(ccnl, ccnl->http, &readfs, &writefs);
 #endif
+        if (ccnl_io_wakeup_fd >= 0 && FD_ISSET(ccnl_io_wakeup_fd, &readfs)) {
+            ccnl_io_wakeup_cb(ccnl);
+        }
         for (i = 0; i < ccnl->ifcount; i++) {
             if (FD_ISSET(ccnl->ifs[i].sock, &readfs)) {
-                sockunion src_addr;
-                socklen_t addrlen = sizeof(sockunion);
-                ssize_t recvlen;
-                if ((recvlen = recvfrom(ccnl->ifs[i].sock, buf, sizeof(buf), 0,
-                                (struct sockaddr*) &src_addr, &addrlen)) > 0) {
-                    len = (size_t) recvlen;
-                    if (0) {}
-#ifdef USE_IPV4
-                    else if (src_addr.sa.sa_family == AF_INET) {
-                        ccnl_core_RX(ccnl, i, buf, len,
-                                     &src_addr.sa, sizeof(src_addr.ip4));
-                    }
-#endif
-#ifdef USE_IPV6
-                    else if (src_addr.sa.sa_family == AF_INET6) {
-                        ccnl_core_RX(ccnl, i, buf, len,
-                                     &src_addr.sa, sizeof(src_addr.ip6));
-                    }
-#endif
-#ifdef USE_LINKLAYER
-                    else if (src_addr.sa.sa_family == AF_PACKET) {
-                        if (len > 14) {
-                            ccnl_core_RX(ccnl, i, buf + 14, len - 14,
-                                         &src_addr.sa, sizeof(src_addr.linklayer));
-                        }
-                    }
-#endif
-#ifdef USE_WPAN
-                    else if (src_addr.sa.sa_family == AF_IEEE802154) {
-                        if (len > 14) {
-                            ccnl_core_RX(ccnl, i, buf, len,
-                                         &src_addr.sa, sizeof(src_addr.linklayer));
-                        }
-                    }
-#endif
-#ifdef USE_UNIXSOCKET
-                    else if (src_addr.sa.sa_family == AF_UNIX) {
-                        ccnl_core_RX(ccnl, i, buf, len,
-                                     &src_addr.sa, sizeof(src_addr.ux));
-                    }
-#endif
-                }
+                ccnl_io_rx(ccnl, i, buf, sizeof(buf), 0);
             }
 
             if (FD_ISSET(ccnl->ifs[i].sock, &writefs)) {
@@ -668,8 +1138,183 @@ ccnl_io_loop(struct ccnl_relay_s *ccnl)
     return 0;
 }
 
-void
-ccnl_populate_cache(struct ccnl_relay_s *ccnl, char *path)
+int
+ccnl_io_loop(struct ccnl_relay_s *ccnl)
+{
+    int rc;
+
+    if (ccnl->ifcount == 0) {
+        DEBUGMSG(ERROR, "no socket to work with, not good, quitting\n");
+        exit(EXIT_FAILURE);
+    }
+#ifdef USE_MMSG
+    if (ccnl_io_rxbatch_init(&rxbatch, ccnl_io_rx_batch) < 0) {
+        DEBUGMSG(WARNING, "no memory for batched receive, "
+                 "receiving one packet at a time\n");
+    }
+#ifndef USE_SCHEDULER
+    if (ccnl_io_tx_batch) {
+        ccnl->ccnl_ll_TXv_ptr = ccnl_ll_TXv;
+    }
+#endif
+#endif
+#ifdef USE_EPOLL
+    if (!ccnl_io_use_select) {
+        rc = ccnl_io_loop_epoll(ccnl);
+    } else {
+        rc = ccnl_io_loop_select(ccnl);
+    }
+#else
+    rc = ccnl_io_loop_select(ccnl);
+#endif
+    ccnl_io_flush(ccnl);
+#ifdef USE_MMSG
+    ccnl_io_rxbatch_cleanup(&rxbatch);
+    ccnl->ccnl_ll_TXv_ptr = NULL;
+#endif
+    return rc;
+}
+
+// parses the content object at *pos and moves *pos behind it: a file
+// holds one packet, or several back to back (packed segment, see
+// ccn-lite-produce), and so does a segment of a store
+static struct ccnl_pkt_s*
+ccnl_unix_bytes2content(uint8_t **pos, uint8_t *end, const char *fname)
+{
+    struct ccnl_pkt_s *pk = NULL;
+    size_t datalen = (size_t) (end - *pos), skip;
+    uint8_t *data = *pos;
+    int suite;
+#if defined(USE_SUITE_NDNTLV)
+    uint64_t typ;
+    size_t len;
+#endif
+
+    if (datalen < 2) {
+        goto notacontent;
+    }
+    suite = ccnl_pkt2suite(data, datalen, &skip);
+    switch (suite) {
+#ifdef USE_SUITE_CCNB
+    case CCNL_SUITE_CCNB: {
+        uint8_t *start;
+
+        data = start = *pos + skip;
+        datalen -= skip;
+
+        if (data[0] != 0x04 || data[1] != 0x82) {
+            goto notacontent;
+        }
+        data += 2;
+        datalen -= 2;
+
+        pk = ccnl_ccnb_bytes2pkt(start, &data, &datalen);
+        break;
+    }
+#endif
+#ifdef USE_SUITE_CCNTLV
+    case CCNL_SUITE_CCNTLV: {
+        size_t hdrlen, pktlen;
+        uint8_t *start;
+
+        data = start = *pos + skip;
+        datalen -= skip;
+
+        if (ccnl_ccntlv_getHdrLen(data, datalen, &hdrlen)) {
+            goto notacontent;
+        }
+        pktlen = ntohs(((struct ccnx_tlvhdr_ccnx2015_s *) data)->pktlen);
+        if (pktlen < hdrlen || pktlen > datalen) {
+            goto notacontent;
+        }
+        data += hdrlen;
+        datalen = pktlen - hdrlen;
+
+        pk = ccnl_ccntlv_bytes2pkt(start, &data, &datalen);
+        break;
+    }
+#endif
+#ifdef USE_SUITE_NDNTLV
+    case CCNL_SUITE_NDNTLV: {
+        uint8_t *olddata;
+
+        data = olddata = *pos + skip;
+        datalen -= skip;
+        if (ccnl_ndntlv_dehead(&data, &datalen, &typ, &len) ||
+                            typ != NDN_TLV_Data || len > datalen) {
+            goto notacontent;
+        }
+        datalen = len;
+        pk = ccnl_ndntlv_bytes2pkt(typ, olddata, &data, &datalen);
+        break;
+    }
+#endif
+    default:
+        DEBUGMSG(WARNING, "unknown packet format (%s)\n", fname);
+        return NULL;
+    }
+    if (!pk) {
+        DEBUGMSG(DEBUG, "  parsing error in %s\n", fname);
+        return NULL;
+    }
+    *pos = data;
+    return pk;
+
+notacontent:
+    DEBUGMSG(WARNING, "not a content object (%s)\n", fname);
+    return NULL;
+}
+
+// adds the content objects of a file to the cache, or to a store
+static int
+ccnl_populate_file(struct ccnl_relay_s *ccnl, struct ccnl_cs_store_s *store,
+                   struct ccnl_buf_s *buf, char *fname)
+{
+    uint8_t *pos = buf->data, *end = buf->data + buf->datalen;
+    int cnt = 0;
+
+    while (pos < end) {
+        struct ccnl_content_s *c;
+        struct ccnl_pkt_s *pk;
+
+        pk = ccnl_unix_bytes2content(&pos, end, fname);
+        if (!pk) {
+            return cnt;
+        }
+        if (store) {
+            int rc = ccnl_cs_store_append(store,
+                                ccnl_prefix_hash(pk->pfx, pk->pfx->compcnt),
+                                pk->buf->data, pk->buf->datalen);
+
+            ccnl_pkt_free(pk);
+            if (rc) {
+                DEBUGMSG(WARNING, "could not store content (%s)\n", fname);
+                return cnt;
+            }
+            cnt++;
+            continue;
+        }
+        c = ccnl_content_new(&pk);
+        if (!c) {
+            DEBUGMSG(WARNING, "could not create content (%s)\n", fname);
+            ccnl_pkt_free(pk);
+            return cnt;
+        }
+        if (!ccnl_content_add2cache(ccnl, c)) {
+            // a duplicate, or too large for the cache: the next may fit
+            DEBUGMSG(WARNING, "could not cache content (%s)\n", fname);
+            ccnl_content_free(c);
+            continue;
+        }
+        c->flags |= CCNL_CONTENT_FLAGS_STATIC;
+        cnt++;
+    }
+    return cnt;
+}
+
+static void
+ccnl_populate_dir(struct ccnl_relay_s *ccnl, struct ccnl_cs_store_s *store,
+                  const char *path)
 {
     DIR *dir;
     struct dirent *de;
@@ -680,23 +1325,19 @@ ccnl_populate_cache(struct ccnl_relay_s *ccnl, char *path)
         return;
     }
 
-    DEBUGMSG(INFO, "populating cache from directory %s\n", path);
+    if (store) {
+        DEBUGMSG(INFO, "importing directory %s into store %s\n", path, store->dir);
+    } else {
+        DEBUGMSG(INFO, "populating cache from directory %s\n", path);
+    }
 
     while ((de = readdir(dir))) {
         char fname[1000];
         struct stat s;
-        struct ccnl_buf_s *buf = 0; // , *nonce=0, *ppkd=0, *pkt = 0;
-        struct ccnl_content_s *c = 0;
-        int fd, suite;
+        struct ccnl_buf_s *buf = 0;
+        int fd, cnt;
         ssize_t recvlen;
-        size_t datalen, skip, flen;
-        uint8_t *data;
-        (void) data; // silence compiler warning (if any USE_SUITE_* is not set)
-#if defined(USE_SUITE_NDNTLV)
-        uint64_t typ;
-        size_t len;
-#endif
-        struct ccnl_pkt_s *pk;
+        size_t datalen = 0, flen;
 
         if (de->d_name[0] == '.') {
             continue;
@@ -726,7 +1367,7 @@ ccnl_populate_cache(struct ccnl_relay_s *ccnl, char *path)
             continue;
         }
 
-        buf = (struct ccnl_buf_s *) ccnl_malloc(sizeof(*buf) + s.st_size);
+        buf = ccnl_buf_new(NULL, flen);
         if (buf) {
             recvlen = read(fd, buf->data, flen);
         } else {
@@ -737,88 +1378,146 @@ ccnl_populate_cache(struct ccnl_relay_s *ccnl, char *path)
         if (!buf || recvlen < 0 || (datalen = (size_t) recvlen) != flen || datalen < 2) {
             DEBUGMSG(WARNING, "size mismatch for file %s, %ld/%lld bytes\n",
                      de->d_name, datalen, (long long) s.st_size);
+            ccnl_buf_free(buf);
             continue;
         }
         buf->datalen = datalen;
-        suite = ccnl_pkt2suite(buf->data, datalen, &skip);
-
-        pk = NULL;
-        switch (suite) {
-#ifdef USE_SUITE_CCNB
-        case CCNL_SUITE_CCNB: {
-            uint8_t *start;
+        cnt = ccnl_populate_file(ccnl, store, buf, de->d_name);
+        if (cnt > 1) {
+            DEBUGMSG(INFO, "  %d content objects from packed file %s\n",
+                     cnt, de->d_name);
+        }
+        ccnl_buf_free(buf);
+    }
 
-            data = start = buf->data + skip;
-            datalen -= skip;
+    closedir(dir);
+}
 
-            if (data[0] != 0x04 || data[1] != 0x82) {
-                goto notacontent;
-            }
-            data += 2;
-            datalen -= 2;
+void
+ccnl_populate_cache(struct ccnl_relay_s *ccnl, char *path)
+{
+    ccnl_populate_dir(ccnl, NULL, path);
+}
 
-            pk = ccnl_ccnb_bytes2pkt(start, &data, &datalen);
-            break;
-        }
-#endif
-#ifdef USE_SUITE_CCNTLV
-        case CCNL_SUITE_CCNTLV: {
-            size_t hdrlen;
-            uint8_t *start;
+// loads the content an Interest asks for from the store into the cache,
+// which thus holds the recently used part of the store
+static int
+ccnl_cs_store_promote(struct ccnl_relay_s *ccnl, struct ccnl_pkt_s *interest)
+{
+    struct ccnl_cs_store_s *store = (struct ccnl_cs_store_s *) ccnl->cs_store;
+    struct ccnl_prefix_s *pfx = interest->pfx;
+    struct ccnl_pkt_s *found[CCNL_CS_STORE_PROMOTE_MAX];
+    uint32_t k, n = 0;
+    int cnt = 0;
+
+    // like the content store: the name, or the name without an implicit
+    // digest. The packets are copied out first: adding them to the cache
+    // may spill to the store, which changes its index and segments.
+    for (k = 0; k < 2 && k <= pfx->compcnt; k++) {
+        uint32_t compcnt = pfx->compcnt - k, pos = 0;
+        const uint8_t *data;
+        size_t len;
 
-            data = start = buf->data + skip;
-            datalen -=  skip;
+        while (n < CCNL_CS_STORE_PROMOTE_MAX &&
+               (data = ccnl_cs_store_get(store, ccnl_prefix_hash(pfx, compcnt),
+                                         &pos, &len))) {
+            uint8_t *p = (uint8_t *) data;
+            struct ccnl_pkt_s *pk;
 
-            if (ccnl_ccntlv_getHdrLen(data, datalen, &hdrlen)) {
-                goto notacontent;
+            pk = ccnl_unix_bytes2content(&p, p + len, store->dir);
+            if (!pk) {
+                continue;
             }
-            data += hdrlen;
-            datalen -= hdrlen;
-
-            pk = ccnl_ccntlv_bytes2pkt(start, &data, &datalen);
-            break;
-        }
-#endif
-#ifdef USE_SUITE_NDNTLV
-        case CCNL_SUITE_NDNTLV: {
-            uint8_t *olddata;
-
-            data = olddata = buf->data + skip;
-            datalen -= skip;
-            if (ccnl_ndntlv_dehead(&data, &datalen, &typ, &len) ||
-                                                         typ != NDN_TLV_Data) {
-                goto notacontent;
+            if (!ccnl_prefix_is_head(pk->pfx, pfx, compcnt)) {
+                ccnl_pkt_free(pk);
+                continue;
             }
-            pk = ccnl_ndntlv_bytes2pkt(typ, olddata, &data, &datalen);
-            break;
+            found[n++] = pk;
         }
-#endif
-        default:
-            DEBUGMSG(WARNING, "unknown packet format (%s)\n", de->d_name);
-            goto Done;
+    }
+    for (k = 0; k < n; k++) {
+        struct ccnl_content_s *c = ccnl_content_new(&found[k]);
+
+        if (!c) {
+            ccnl_pkt_free(found[k]);
+            continue;
         }
-        if (!pk) {
-            DEBUGMSG(DEBUG, "  parsing error in %s\n", de->d_name);
-            goto Done;
+        c->flags |= CCNL_CONTENT_FLAGS_STORED;
+        if (!ccnl_content_add2cache(ccnl, c)) {
+            ccnl_content_free(c);
+            continue;
         }
-        c = ccnl_content_new(&pk);
-        if (!c) {
-            DEBUGMSG(WARNING, "could not create content (%s)\n", de->d_name);
-            goto Done;
+        cnt++;
+    }
+    return cnt;
+}
+
+// writes content evicted from the cache to the store, unless it came
+// from there or was asked for only once: without the admission filter
+// there are no counts, and nothing is spilled
+static void
+ccnl_cs_store_spill(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
+{
+    struct ccnl_cs_store_s *store = (struct ccnl_cs_store_s *) ccnl->cs_store;
+
+    if (!ccnl->cs_sketch.counters ||
+        (c->flags & (CCNL_CONTENT_FLAGS_STORED | CCNL_CONTENT_FLAGS_STATIC)) ||
+        ccnl_cs_admission_estimate(ccnl, c) < CCNL_CS_STORE_SPILL_MIN) {
+        return;
+    }
+    if (!ccnl_cs_store_append(store, ccnl_prefix_hash(c->pkt->pfx, c->pkt->pfx->compcnt),
+                              c->pkt->buf->data, c->pkt->buf->datalen)) {
+        ccnl->cs_stats.spilled++;
+    }
+}
+
+int
+ccnl_cs_store_attach(struct ccnl_relay_s *ccnl, const char *dir,
+                     const char *datadir, size_t max_size)
+{
+    struct ccnl_cs_store_s *store = ccnl_cs_store_open(dir, max_size);
+
+    if (!store) {
+        return -1;
+    }
+    if (datadir) {
+        if (store->cnt) {
+            DEBUGMSG(INFO, "store %s is not empty, %s is not imported\n",
+                     dir, datadir);
+        } else {
+            ccnl_cs_store_pin(store, 1);
+            ccnl_populate_dir(ccnl, store, datadir);
+            ccnl_cs_store_pin(store, 0);
+            DEBUGMSG(INFO, "  %u content objects stored\n", store->cnt);
         }
-        ccnl_content_add2cache(ccnl, c);
-        c->flags |= CCNL_CONTENT_FLAGS_STATIC;
-Done:
-        ccnl_pkt_free(pk);
-        ccnl_free(buf);
-        continue;
-#if defined(USE_SUITE_CCNB) || defined(USE_SUITE_NDNTLV)
-notacontent:
-        DEBUGMSG(WARNING, "not a content object (%s)\n", de->d_name);
-        ccnl_free(buf);
-#endif
     }
+    // the other shards share the directory, they only delete what they wrote
+    if (ccnl->id == 0) {
+        ccnl_cs_store_adopt(store);
+    }
+    ccnl->cs_store = store;
+    ccnl->ccnl_cs_load_ptr = ccnl_cs_store_promote;
+    ccnl->ccnl_cs_evict_ptr = ccnl_cs_store_spill;
+    return 0;
+}
 
-    closedir(dir);
+void
+ccnl_cs_store_detach(struct ccnl_relay_s *ccnl)
+{
+    struct ccnl_cs_stats_s *st = &ccnl->cs_stats;
+    uint32_t misses = st->lookups - st->hits;
+
+    if (st->lookups) {
+        DEBUGMSG(INFO, "relay %d: %u lookups, content store %u hits (%.1f%%), "
+                 "store %u hits (%.1f%% of the misses), %u not admitted, "
+                 "%u spilled\n", ccnl->id, st->lookups, st->hits,
+                 100.0 * st->hits / st->lookups, st->store_hits,
+                 misses ? 100.0 * st->store_hits / misses : 0.0,
+                 st->rejected, st->spilled);
+    }
+    ccnl->ccnl_cs_load_ptr = NULL;
+    ccnl->ccnl_cs_evict_ptr = NULL;
+    ccnl_cs_store_close((struct ccnl_cs_store_s *) ccnl->cs_store);
+    ccnl->cs_store = NULL;
 }
 
@@ -1263,7 +1263,7 @@ Bail:
         ccnl_free(stmt);
     }
     if (prefix) {
-        ccnl_free(prefix);
+        ccnl_prefix_free(prefix);
     }
     return ret;
 }
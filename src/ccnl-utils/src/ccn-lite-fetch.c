@@ -1,6 +1,7 @@
 /*
  * @f util/ccn-lite-fetch.c
- * @b request content: send an interest, wait for reply, output to stdout
+ * @b request content: send interests for the chunks of an object,
+ *    reassemble them and output the object to stdout
  *
  * Copyright (C) 2013-14, Basil Kohler, University of Basel
  *
@@ -18,62 +19,122 @@
  *
  * File history:
  * 2014-10-13  created
+ * 2026-10-18  pipelined fetching with an adaptive window
  */
 
 
 //#define NEEDS_PACKET_CRAFTING
 
 #include "ccnl-common.h"
+#include "ccnl-rtt.h"
 
 #include <stdlib.h>
 
 //#include "ccnl-socket.c"
 
-// ----------------------------------------------------------------------
+/**
+ * @brief Max number of Interests in flight, also the number of chunks
+ * held back for the reassembly
+ */
+#ifndef CCNL_FETCH_MAX_WINDOW
+#define CCNL_FETCH_MAX_WINDOW   256
+#endif
 
-int
-ccnl_fetchContentForChunkName(struct ccnl_prefix_s *prefix,
-                              uint32_t *chunknum,
-                              int suite,
-                              uint8_t *out, size_t out_len,
-                              size_t *len,
-                              float wait, int sock, struct sockaddr sa) {
-    (void) chunknum;
-#ifdef USE_SUITE_CCNB
-    if (suite == CCNL_SUITE_CCNB) {
-        DEBUGMSG(ERROR, "CCNB not implemented\n");
-        exit(-1);
-    }
+/**
+ * @brief Default upper bound of the adaptive window
+ */
+#ifndef CCNL_FETCH_DEFAULT_MAXWIN
+#define CCNL_FETCH_DEFAULT_MAXWIN 64
+#endif
+
+/**
+ * @brief Number of retransmissions of a chunk's Interest before the
+ * transfer is given up
+ */
+#ifndef CCNL_FETCH_MAX_RETRIES
+#define CCNL_FETCH_MAX_RETRIES  3
 #endif
 
-    int nonce = random();
+#define CCNL_FETCH_FREE         0
+#define CCNL_FETCH_PENDING      1 // Interest sent
+#define CCNL_FETCH_RECEIVED     2 // received out of order, waits for its predecessors
+
+// a chunk in the window
+struct ccnl_fetch_chunk_s {
+    uint32_t num;               // chunk number
+    uint32_t sent;              // time of the last transmission (ms)
+    uint8_t state;
+    uint8_t retries;            // number of retransmissions
+    uint8_t *data;              // content received out of order
+    size_t len;
+};
+
+// state of a transfer
+struct ccnl_fetch_s {
+    struct ccnl_prefix_s *prefix; // name of the object, without chunk number
+    int suite;
+    int sock;
+    struct sockaddr sa;
+    float wait;                 // timeout until the first RTT sample (s)
+    struct ccnl_fetch_chunk_s probe; // Interest for the name without chunk number
+
+    struct ccnl_fetch_chunk_s win[CCNL_FETCH_MAX_WINDOW];
+    uint32_t next_write;        // next chunk to output
+    uint32_t next_send;         // next chunk to request
+    int64_t lastchunk;          // final block id, -1 while unknown
+    uint32_t inflight;          // number of chunks in state PENDING
+
+    // congestion control: slow start, then AIMD
+    double cwnd;
+    double ssthresh;
+    uint32_t maxwin;
+    int fixed;                  // keep cwnd at maxwin
+    uint32_t last_decrease;     // losses of earlier Interests don't shrink the window again
+
+    struct ccnl_rtt_s rtt;
+    uint32_t rtt_min;
+    uint32_t rtt_max;
+
+    // statistics
+    uint32_t start;
+    uint64_t bytes;
+    uint32_t interests;
+    uint32_t retransmissions;
+    uint32_t timeouts;
+    uint32_t reordered;
+    uint32_t duplicates;
+};
+
+// ----------------------------------------------------------------------
+
+static int
+ccnl_fetch_sendInterest(struct ccnl_fetch_s *f, uint32_t *chunknum)
+{
+    uint32_t *c = f->prefix->chunknum;
     ccnl_interest_opts_u int_opts;
+    struct ccnl_buf_s *buf;
+    int rc = 0;
+
+    memset(&int_opts, 0, sizeof(int_opts));
 #ifdef USE_SUITE_NDNTLV
-    int_opts.ndntlv.nonce = nonce;
+    int_opts.ndntlv.nonce = random();
 #endif
-    struct ccnl_buf_s * buf = ccnl_mkSimpleInterest(prefix, &int_opts);
+    f->prefix->chunknum = chunknum;
+    buf = ccnl_mkSimpleInterest(f->prefix, &int_opts);
+    f->prefix->chunknum = c;
 
-    if(buf->datalen <= 0){
+    if (!buf || buf->datalen <= 0) {
         fprintf(stderr, "Could not create interest message\n");
+        ccnl_buf_free(buf);
+        return -1;
     }
-
-    if (sendto(sock, buf->data, buf->datalen, 0, &sa, sizeof(sa)) < 0) {
+    if (sendto(f->sock, buf->data, buf->datalen, 0, &f->sa, sizeof(f->sa)) < 0) {
         perror("sendto");
-        myexit(1);
+        rc = -1;
     }
-    if (block_on_read(sock, wait) <= 0) {
-        DEBUGMSG(WARNING, "timeout after block_on_read\n");
-        return -1;
-    }
-    *len = recv(sock, out, out_len, 0);
-/*
-        {
-            int fd = open("incoming.bin", O_WRONLY|O_CREAT|O_TRUNC);
-            write(fd, out, *len);
-            close(fd);
-        }
-*/
-    return 0;
+    ccnl_buf_free(buf);
+    f->interests++;
+    return rc;
 }
 
 int
@@ -82,6 +143,8 @@ ccnl_extractDataAndChunkInfo(uint8_t **data, size_t *datalen,
                              int64_t *lastchunknum,
                              uint8_t **content, size_t *contentlen)
 {
+    // decoded in place: the content stays in the caller's buffer
+    struct ccnl_pkt_view_s view;
     struct ccnl_pkt_s *pkt = NULL;
 
     switch (suite) {
@@ -90,7 +153,7 @@ ccnl_extractDataAndChunkInfo(uint8_t **data, size_t *datalen,
         size_t hdrlen;
         uint8_t *start = *data;
 
-        if (ccntlv_isData(*data, *datalen)) {
+        if (!ccntlv_isData(*data, *datalen)) {
             DEBUGMSG(WARNING, "Received non-content-object\n");
             return -1;
         }
@@ -101,7 +164,9 @@ ccnl_extractDataAndChunkInfo(uint8_t **data, size_t *datalen,
         *data += hdrlen;
         *datalen -= hdrlen;
 
-        pkt = ccnl_ccntlv_bytes2pkt(start, data, datalen);
+        if (!ccnl_ccntlv_bytes2view(start, data, datalen, &view)) {
+            pkt = &view.pkt;
+        }
         break;
     }
 #endif
@@ -120,7 +185,9 @@ ccnl_extractDataAndChunkInfo(uint8_t **data, size_t *datalen,
             return -1;
         }
 
-        pkt = ccnl_ndntlv_bytes2pkt(typ, start, data, datalen);
+        if (!ccnl_ndntlv_bytes2view(typ, start, data, datalen, &view)) {
+            pkt = &view.pkt;
+        }
         break;
     }
 #endif
@@ -129,7 +196,7 @@ ccnl_extractDataAndChunkInfo(uint8_t **data, size_t *datalen,
         DEBUGMSG(WARNING, "extractDataAndChunkInfo: suite %d not implemented\n", suite);
         return -1;
    }
-    if (!pkt) {
+    if (!pkt || !pkt->pfx) {
         DEBUGMSG(WARNING, "extract(%s): parsing error or no prefix\n",
                  ccnl_suite2str(suite));
         return -1;
@@ -138,7 +205,6 @@ ccnl_extractDataAndChunkInfo(uint8_t **data, size_t *datalen,
     *lastchunknum = pkt->val.final_block_id;
     *content = pkt->content;
     *contentlen = pkt->contlen;
-    ccnl_pkt_free(pkt);
 
     return 0;
 }
@@ -174,21 +240,426 @@ ccnl_prefix_removeChunkNumComponent(int suite,
     return 0;
 }
 
+// ----------------------------------------------------------------------
+
+static int
+ccnl_fetch_output(uint8_t *data, size_t len)
+{
+    while (len > 0) {
+        ssize_t n = write(1, data, len);
+        if (n < 0) {
+            perror("write");
+            return -1;
+        }
+        data += n;
+        len -= (size_t) n;
+    }
+    return 0;
+}
+
+static struct ccnl_fetch_chunk_s*
+ccnl_fetch_slot(struct ccnl_fetch_s *f, uint32_t num)
+{
+    return &f->win[num % CCNL_FETCH_MAX_WINDOW];
+}
+
+// retransmission timeout of a pending chunk in ms
+static uint32_t
+ccnl_fetch_rto(struct ccnl_fetch_s *f, struct ccnl_fetch_chunk_s *c)
+{
+    uint32_t rto = f->rtt.samples ? ccnl_rtt_rto(&f->rtt)
+                                  : (uint32_t) (f->wait * 1000);
+
+    return c->retries ? ccnl_rtt_backoff(rto, c->retries) : rto;
+}
+
+static void
+ccnl_fetch_setLastChunk(struct ccnl_fetch_s *f, int64_t lastchunk)
+{
+    uint32_t n;
+
+    f->lastchunk = lastchunk;
+    // forget the Interests sent beyond the end of the object
+    for (n = f->next_write; n != f->next_send; n++) {
+        struct ccnl_fetch_chunk_s *c = ccnl_fetch_slot(f, n);
+
+        if (n > lastchunk && c->state == CCNL_FETCH_PENDING) {
+            c->state = CCNL_FETCH_FREE;
+            f->inflight--;
+        }
+    }
+    if (f->next_send > lastchunk + 1) {
+        f->next_send = (uint32_t) (lastchunk + 1);
+    }
+}
+
+static int
+ccnl_fetch_sameName(struct ccnl_prefix_s *a, struct ccnl_prefix_s *b)
+{
+    uint32_t i;
+
+    if (a->compcnt != b->compcnt) {
+        return 0;
+    }
+    for (i = 0; i < a->compcnt; i++) {
+        if (a->complen[i] != b->complen[i] ||
+            memcmp(a->comp[i], b->comp[i], a->complen[i])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// continues with the name of a chunk received for the name without chunk
+// number, which may carry more components (like a version): the
+// Interests sent so far were for another name
+static void
+ccnl_fetch_setName(struct ccnl_fetch_s *f, struct ccnl_prefix_s *pfx)
+{
+    uint32_t n;
+
+    DEBUGMSG(INFO, "continuing with prefix '%s'\n", ccnl_prefix_to_path(pfx));
+    for (n = 0; n < CCNL_FETCH_MAX_WINDOW; n++) {
+        ccnl_free(f->win[n].data);
+        memset(&f->win[n], 0, sizeof(f->win[n]));
+    }
+    f->next_write = f->next_send = f->inflight = 0;
+    f->lastchunk = -1;
+    ccnl_prefix_free(f->prefix);
+    f->prefix = pfx;
+}
+
+// additive increase: +1 per answered Interest in slow start, +1 per
+// window afterwards
+static void
+ccnl_fetch_increase(struct ccnl_fetch_s *f)
+{
+    if (f->fixed) {
+        return;
+    }
+    if (f->cwnd < f->ssthresh) {
+        f->cwnd += 1;
+    } else {
+        f->cwnd += 1 / f->cwnd;
+    }
+    if (f->cwnd > f->maxwin) {
+        f->cwnd = f->maxwin;
+    }
+}
+
+// multiplicative decrease, once per window: a burst of losses caused by
+// the same congestion only halves the window once
+static void
+ccnl_fetch_decrease(struct ccnl_fetch_s *f, struct ccnl_fetch_chunk_s *c,
+                    uint32_t now)
+{
+    if (f->fixed || (int32_t) (c->sent - f->last_decrease) < 0) {
+        return;
+    }
+    f->ssthresh = f->cwnd / 2 < 1 ? 1 : f->cwnd / 2;
+    f->cwnd = f->ssthresh;
+    f->last_decrease = now;
+}
+
+// sends Interests for new chunks while the window allows
+static int
+ccnl_fetch_fill(struct ccnl_fetch_s *f)
+{
+    while (f->inflight < (uint32_t) f->cwnd &&
+           f->next_send - f->next_write < CCNL_FETCH_MAX_WINDOW &&
+           (f->lastchunk < 0 || f->next_send <= f->lastchunk)) {
+        struct ccnl_fetch_chunk_s *c = ccnl_fetch_slot(f, f->next_send);
+
+        c->num = f->next_send;
+        c->state = CCNL_FETCH_PENDING;
+        c->retries = 0;
+        c->sent = ccnl_rtt_now();
+        DEBUGMSG(DEBUG, "requesting chunk %u (window %.1f, in flight %u)\n",
+                 c->num, f->cwnd, f->inflight);
+        if (ccnl_fetch_sendInterest(f, &c->num) < 0) {
+            return -1;
+        }
+        f->inflight++;
+        f->next_send++;
+    }
+    return 0;
+}
+
+// handles a received packet, returns 1 if it was an unchunked object
+// which completes the transfer, -1 on output errors
+static int
+ccnl_fetch_receive(struct ccnl_fetch_s *f, uint8_t *data, size_t len,
+                   uint32_t now)
+{
+    struct ccnl_prefix_s *pfx = NULL;
+    struct ccnl_fetch_chunk_s *c;
+    int64_t lastchunk;
+    uint8_t *content;
+    size_t contlen;
+    uint32_t num;
+
+    if (ccnl_extractDataAndChunkInfo(&data, &len, f->suite, &pfx,
+                                     &lastchunk, &content, &contlen)) {
+        DEBUGMSG(WARNING, "Could not extract response or it was an interest\n");
+        return 0;
+    }
+    if (!pfx->chunknum) {
+        ccnl_prefix_free(pfx);
+        if (f->probe.state != CCNL_FETCH_PENDING) {
+            f->duplicates++;
+            return 0;
+        }
+        // response is not chunked, output it and stop
+        f->bytes += contlen;
+        return ccnl_fetch_output(content, contlen) ? -1 : 1;
+    }
+    num = *pfx->chunknum;
+    if (f->probe.state == CCNL_FETCH_PENDING) {
+        f->probe.state = CCNL_FETCH_FREE;
+        if (!ccnl_prefix_removeChunkNumComponent(f->suite, pfx) &&
+            !ccnl_fetch_sameName(f->prefix, pfx)) {
+            ccnl_fetch_setName(f, pfx);
+            if (num != 0) { // drop it, the transfer starts with chunk 0
+                return 0;
+            }
+            c = ccnl_fetch_slot(f, 0);
+            c->state = CCNL_FETCH_PENDING;
+            c->retries = 1; // no RTT sample
+            f->inflight++;
+            f->next_send++;
+            pfx = NULL;
+        }
+    }
+    if (pfx) {
+        ccnl_prefix_free(pfx);
+    }
+
+    c = ccnl_fetch_slot(f, num);
+    if (c->num != num || c->state != CCNL_FETCH_PENDING) {
+        DEBUGMSG(DEBUG, "chunk %u: duplicate or not requested\n", num);
+        f->duplicates++;
+        return 0;
+    }
+    if (!c->retries) { // Karn: the RTT of a retransmitted Interest is ambiguous
+        uint32_t rtt = now - c->sent;
+
+        ccnl_rtt_sample(&f->rtt, rtt);
+        if (!f->rtt_min || rtt < f->rtt_min) {
+            f->rtt_min = rtt;
+        }
+        if (rtt > f->rtt_max) {
+            f->rtt_max = rtt;
+        }
+    }
+    f->inflight--;
+    f->bytes += contlen;
+    ccnl_fetch_increase(f);
+    DEBUGMSG(DEBUG, "found chunk %u with contlen=%zu, lastchunk=%lld\n",
+             num, contlen, (long long) lastchunk);
+    if (lastchunk >= 0 && f->lastchunk < 0) {
+        ccnl_fetch_setLastChunk(f, lastchunk);
+    }
+
+    if (num != f->next_write) { // keep it until its predecessors arrived
+        c->data = ccnl_malloc(contlen ? contlen : 1);
+        if (!c->data) {
+            DEBUGMSG(ERROR, "Failed to allocate memory\n");
+            return -1;
+        }
+        memcpy(c->data, content, contlen);
+        c->len = contlen;
+        c->state = CCNL_FETCH_RECEIVED;
+        f->reordered++;
+        return 0;
+    }
+
+    c->state = CCNL_FETCH_FREE;
+    if (ccnl_fetch_output(content, contlen)) {
+        return -1;
+    }
+    f->next_write++;
+    for (c = ccnl_fetch_slot(f, f->next_write);
+         f->next_write != f->next_send && c->state == CCNL_FETCH_RECEIVED;
+         c = ccnl_fetch_slot(f, f->next_write)) {
+        int rc = ccnl_fetch_output(c->data, c->len);
+
+        ccnl_free(c->data);
+        c->data = NULL;
+        c->state = CCNL_FETCH_FREE;
+        if (rc) {
+            return -1;
+        }
+        f->next_write++;
+    }
+    return 0;
+}
+
+// retransmits the Interest for the name without chunk number, it is
+// given up silently if chunks of the name arrive instead
+static int
+ccnl_fetch_expireProbe(struct ccnl_fetch_s *f, uint32_t now)
+{
+    struct ccnl_fetch_chunk_s *c = &f->probe;
+
+    if (c->state != CCNL_FETCH_PENDING ||
+        (int32_t) (now - c->sent) < (int32_t) ccnl_fetch_rto(f, c)) {
+        return 0;
+    }
+    f->timeouts++;
+    if (c->retries >= CCNL_FETCH_MAX_RETRIES) {
+        DEBUGMSG(INFO, "no response for the name without chunk number\n");
+        c->state = CCNL_FETCH_FREE;
+        return 0;
+    }
+    c->retries++;
+    c->sent = now;
+    f->retransmissions++;
+    DEBUGMSG(INFO, "timeout, retry %d of %d for the name without chunk number\n",
+             c->retries, CCNL_FETCH_MAX_RETRIES);
+    return ccnl_fetch_sendInterest(f, NULL);
+}
+
+// retransmits the Interests whose timer expired, returns -1 if a chunk
+// is given up
+static int
+ccnl_fetch_expire(struct ccnl_fetch_s *f, uint32_t now)
+{
+    uint32_t n;
+
+    if (ccnl_fetch_expireProbe(f, now) < 0) {
+        return -1;
+    }
+    for (n = f->next_write; n != f->next_send; n++) {
+        struct ccnl_fetch_chunk_s *c = ccnl_fetch_slot(f, n);
+
+        if (c->state != CCNL_FETCH_PENDING ||
+            (int32_t) (now - c->sent) < (int32_t) ccnl_fetch_rto(f, c)) {
+            continue;
+        }
+        f->timeouts++;
+        if (c->retries >= CCNL_FETCH_MAX_RETRIES) {
+            if (f->probe.state == CCNL_FETCH_PENDING) {
+                // the object may have another name (a version), which
+                // the answer to the probe tells
+                c->sent = now;
+                continue;
+            }
+            DEBUGMSG(WARNING, "chunk %u: no response after %d retries\n",
+                     n, CCNL_FETCH_MAX_RETRIES);
+            return -1;
+        }
+        ccnl_fetch_decrease(f, c, now);
+        c->retries++;
+        c->sent = now;
+        f->retransmissions++;
+        DEBUGMSG(INFO, "timeout, retry %d of %d for chunk %u\n",
+                 c->retries, CCNL_FETCH_MAX_RETRIES, n);
+        if (ccnl_fetch_sendInterest(f, &c->num) < 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// seconds until the next retransmission timer expires
+static float
+ccnl_fetch_nextTimeout(struct ccnl_fetch_s *f, uint32_t now)
+{
+    int32_t next = -1;
+    uint32_t n;
+
+    if (f->probe.state == CCNL_FETCH_PENDING) {
+        next = (int32_t) (f->probe.sent + ccnl_fetch_rto(f, &f->probe) - now);
+        if (next < 0) {
+            next = 0;
+        }
+    }
+    for (n = f->next_write; n != f->next_send; n++) {
+        struct ccnl_fetch_chunk_s *c = ccnl_fetch_slot(f, n);
+        int32_t left;
+
+        if (c->state != CCNL_FETCH_PENDING) {
+            continue;
+        }
+        left = (int32_t) (c->sent + ccnl_fetch_rto(f, c) - now);
+        if (left < 0) {
+            left = 0;
+        }
+        if (next < 0 || left < next) {
+            next = left;
+        }
+    }
+    return next < 0 ? f->wait : next / 1000.0f;
+}
+
+static void
+ccnl_fetch_stats(struct ccnl_fetch_s *f)
+{
+    uint32_t ms = ccnl_rtt_now() - f->start;
+    double secs = (ms ? ms : 1) / 1000.0;
+
+    fprintf(stderr, "fetched %u chunks, %llu bytes in %.3f s (%.1f kB/s)\n",
+            f->next_write, (unsigned long long) f->bytes, ms / 1000.0,
+            f->bytes / secs / 1000);
+    fprintf(stderr, "interests=%u retransmissions=%u timeouts=%u "
+            "reordered=%u duplicates=%u\n", f->interests, f->retransmissions,
+            f->timeouts, f->reordered, f->duplicates);
+    fprintf(stderr, "rtt min/srtt/max=%u/%u/%u ms rto=%u ms window=%.1f%s\n",
+            f->rtt_min, f->rtt.srtt, f->rtt_max,
+            f->rtt.samples ? ccnl_rtt_rto(&f->rtt) : (uint32_t) (f->wait * 1000),
+            f->cwnd, f->fixed ? " (fixed)" : "");
+}
+
+// makes the receive buffer of the socket hold a full window: the chunks
+// of a window arrive in a burst, and each one the socket drops costs a
+// retransmission timeout. The window is limited to what the system grants.
+static void
+ccnl_fetch_setRcvbuf(struct ccnl_fetch_s *f)
+{
+    int size = (int) (f->maxwin * CCNL_MAX_PACKET_SIZE);
+    socklen_t len = sizeof(size);
+    uint32_t fits;
+
+    setsockopt(f->sock, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+    if (getsockopt(f->sock, SOL_SOCKET, SO_RCVBUF, &size, &len) < 0 || size <= 0) {
+        return;
+    }
+    // Linux reports twice the size set, half of it is for its bookkeeping
+    fits = (uint32_t) size / 2 / CCNL_MAX_PACKET_SIZE;
+    if (fits < 1) {
+        fits = 1;
+    }
+    if (fits < f->maxwin) {
+        DEBUGMSG(INFO, "receive buffer of %d bytes, window limited to %u\n",
+                 size, fits);
+        f->maxwin = fits;
+    }
+}
 
 // ----------------------------------------------------------------------
 
 int
 main(int argc, char *argv[])
 {
+    static struct ccnl_fetch_s f;
     unsigned char out[64*1024];
-    size_t len;
-    int opt, port, sock = 0, suite = CCNL_SUITE_DEFAULT;
+    ssize_t len;
+    int opt, port, rc, suite = CCNL_SUITE_DEFAULT;
+    int window = 0, maxwin = CCNL_FETCH_DEFAULT_MAXWIN;
     char *addr = NULL, *udp = NULL, *ux = NULL;
-    struct sockaddr sa;
     float wait = 3.0;
+    uint32_t n;
 
-    while ((opt = getopt(argc, argv, "hs:u:v:w:x:")) != -1) {
+    while ((opt = getopt(argc, argv, "hM:s:u:v:w:W:x:")) != -1) {
         switch (opt) {
+        case 'M':
+            maxwin = (int) strtol(optarg, (char**) NULL, 10);
+            if (maxwin < 1 || maxwin > CCNL_FETCH_MAX_WINDOW) {
+                DEBUGMSG(ERROR, "window must be between 1 and %d\n",
+                         CCNL_FETCH_MAX_WINDOW);
+                goto usage;
+            }
+            break;
         case 's':
             suite = ccnl_str2suite(optarg);
             if (!ccnl_isSuite(suite)) {
@@ -202,6 +673,14 @@ main(int argc, char *argv[])
         case 'w':
             wait = (float)strtof(optarg, (char**) NULL);
             break;
+        case 'W':
+            window = (int) strtol(optarg, (char**) NULL, 10);
+            if (window < 1 || window > CCNL_FETCH_MAX_WINDOW) {
+                DEBUGMSG(ERROR, "window must be between 1 and %d\n",
+                         CCNL_FETCH_MAX_WINDOW);
+                goto usage;
+            }
+            break;
             case 'v':
 #ifdef USE_LOGGING
             if (isdigit(optarg[0]))
@@ -218,20 +697,20 @@ main(int argc, char *argv[])
         case 'h':
         default:
 usage:
-            fprintf(stderr, "usage: %s [options] URI [NFNexpr]\n"
+            fprintf(stderr, "usage: %s [options] URI\n"
+            "  -M WINDOW        max number of Interests in flight (default %d)\n"
             "  -s SUITE         (ccnb, ccnx2015, ndn2013)\n"
             "  -u a.b.c.d/port  UDP destination (default is 127.0.0.1/6363)\n"
 #ifdef USE_LOGGING
             "  -v DEBUG_LEVEL (fatal, error, warning, info, debug, verbose, trace)\n"
 #endif
-            "  -w timeout       in sec (float)\n"
+            "  -w timeout       in sec (float), until the first RTT sample\n"
+            "  -W WINDOW        fixed number of Interests in flight (default: adapted)\n"
             "  -x ux_path_name  UNIX IPC: use this instead of UDP\n"
             "Examples:\n"
-            "%% peek /ndn/edu/wustl/ping             (classic lookup)\n"
-            "%% peek /th/ere  \"lambda expr\"          (lambda expr, in-net)\n"
-            "%% peek \"\" \"add 1 1\"                    (lambda expr, local)\n"
-            "%% peek /rpc/site \"call 1 /test/data\"   (lambda RPC, directed)\n",
-            argv[0]);
+            "%% fetch /ndn/edu/wustl/file              (chunked object)\n"
+            "%% fetch -W 16 -s ccnx2015 /ccnx/file   (16 chunks in flight)\n",
+            argv[0], CCNL_FETCH_DEFAULT_MAXWIN);
             exit(1);
         }
     }
@@ -239,6 +718,12 @@ usage:
     if (!argv[optind]) {
         goto usage;
     }
+#ifdef USE_SUITE_CCNB
+    if (suite == CCNL_SUITE_CCNB) {
+        DEBUGMSG(ERROR, "CCNB not implemented\n");
+        exit(-1);
+    }
+#endif
 
     srandom(time(NULL));
 
@@ -250,141 +735,86 @@ usage:
     DEBUGMSG(TRACE, "using udp address %s/%d\n", addr, port);
 
     if (ux) { // use UNIX socket
-        struct sockaddr_un *su = (struct sockaddr_un*) &sa;
+        struct sockaddr_un *su = (struct sockaddr_un*) &f.sa;
         su->sun_family = AF_UNIX;
         strncpy(su->sun_path, ux, sizeof(su->sun_path));
-        sock = ux_open();
+        f.sock = ux_open();
     } else { // UDP
-        struct sockaddr_in *si = (struct sockaddr_in*) &sa;
+        struct sockaddr_in *si = (struct sockaddr_in*) &f.sa;
         si->sin_family = PF_INET;
         si->sin_addr.s_addr = inet_addr(addr);
         si->sin_port = htons(port);
-        sock = udp_open();
+        f.sock = udp_open();
     }
 
-    char *url = argv[optind];
-
-    uint8_t *content = 0;
-    size_t contlen;
-
-    uint32_t *curchunknum = NULL;
-
-    // For CCNTLV always start with the first chunk because of exact content match
-    // This means it can only fetch chunked data and not single content-object data
-    if (suite == CCNL_SUITE_CCNTLV) { 
-        curchunknum = ccnl_malloc(sizeof(uint32_t));
-        if (!curchunknum) {
-            DEBUGMSG(ERROR, "Failed to allocate memory: %d", errno);
-            exit(1);
+    f.prefix = ccnl_URItoPrefix(argv[optind], suite, NULL);
+    if (!f.prefix) {
+        DEBUGMSG(ERROR, "Invalid URI %s\n", argv[optind]);
+        exit(1);
+    }
+    f.suite = suite;
+    f.wait = wait;
+    f.lastchunk = -1;
+    f.fixed = window > 0;
+    f.maxwin = f.fixed ? (uint32_t) window : (uint32_t) maxwin;
+    ccnl_fetch_setRcvbuf(&f);
+    f.cwnd = f.fixed ? f.maxwin : 1;
+    f.ssthresh = f.maxwin;
+    f.start = f.last_decrease = ccnl_rtt_now();
+
+    // For CCNTLV always start with the first chunk because of exact content
+    // match, so it can only fetch chunked data. For NDNTLV the name is also
+    // requested once without chunk number, for single content-object data.
+    if (suite == CCNL_SUITE_NDNTLV) {
+        DEBUGMSG(INFO, "fetching prefix '%s'\n", ccnl_prefix_to_path(f.prefix));
+        f.probe.state = CCNL_FETCH_PENDING;
+        f.probe.sent = ccnl_rtt_now();
+        if (ccnl_fetch_sendInterest(&f, NULL) < 0) {
+            goto Error;
         }
-        *curchunknum = 0;
     }
 
-    struct ccnl_prefix_s *prefix = ccnl_URItoPrefix(url, suite, curchunknum);
-
-
-    const int maxretry = 3;
-    int retry = 0;
-
-    while (retry < maxretry) {
-
-        if (curchunknum) {
-            if (!prefix->chunknum) {
-                prefix->chunknum = ccnl_malloc(sizeof(uint32_t));
-                if (!prefix->chunknum) {
-                    DEBUGMSG(ERROR, "Failed to allocate memory: %d", errno);
-                    exit(1);
-                }
+    for (;;) {
+        if (f.lastchunk >= 0 && f.next_write > f.lastchunk) {
+            goto Done;
+        }
+        if (ccnl_fetch_fill(&f) < 0) {
+            goto Error;
+        }
+        rc = block_on_read(f.sock, ccnl_fetch_nextTimeout(&f, ccnl_rtt_now()));
+        if (rc < 0) {
+            goto Error;
+        }
+        // drain the socket, then look at the timers
+        len = rc > 0 ? recv(f.sock, out, sizeof(out), MSG_DONTWAIT) : 0;
+        while (len > 0) {
+            rc = ccnl_fetch_receive(&f, out, (size_t) len, ccnl_rtt_now());
+            if (rc < 0) {
+                goto Error;
             }
-            *(prefix->chunknum) = *curchunknum;
-            DEBUGMSG(INFO, "fetching chunk %d for prefix '%s'\n", *curchunknum, ccnl_prefix_to_path(prefix));
-        } else {
-            DEBUGMSG(DEBUG, "fetching first chunk...\n");
-            DEBUGMSG(INFO, "fetching first chunk for prefix '%s'\n", ccnl_prefix_to_path(prefix));
-        }
-
-        // Fetch chunk
-        if (ccnl_fetchContentForChunkName(prefix,
-                                          curchunknum,
-                                          suite,
-                                          out, sizeof(out),
-                                          &len,
-                                          wait, sock, sa)) {
-            retry++;
-            DEBUGMSG(WARNING, "timeout\n");//, retry number %d of %d\n", retry, maxretry);
-        } else {
-
-            int64_t lastchunknum;
-            uint8_t *t = &out[0];
-            struct ccnl_prefix_s *nextprefix = 0;
-
-            // Parse response
-            if (ccnl_extractDataAndChunkInfo(&t, &len, suite,
-                                             &nextprefix,
-                                             &lastchunknum,
-                                             &content, &contlen)) {
-                retry++;
-               DEBUGMSG(WARNING, "Could not extract response or it was an interest\n");
-            } else {
-
-                prefix = nextprefix;
-
-                // Check if the fetched content is a chunk
-                if (!(prefix->chunknum)) {
-                    // Response is not chunked, print content and exit
-                    write(1, content, contlen);
-                    goto Done;
-                } else {
-                    uint32_t chunknum = *(prefix->chunknum);
-
-                    // allocate curchunknum because it is the first fetched chunk
-                    if (!curchunknum) {
-                        curchunknum = ccnl_malloc(sizeof(uint32_t));
-                        if (!curchunknum) {
-                            DEBUGMSG(ERROR, "Failed to allocate memory: %d", errno);
-                            exit(1);
-                        }
-                        *curchunknum = 0;
-                    }
-                    // Remove chunk component from name
-                    if (ccnl_prefix_removeChunkNumComponent(suite, prefix) < 0) {
-                        retry++;
-                        DEBUGMSG(WARNING, "Could not remove chunknum\n");
-                    }
-
-                    // Check if the chunk is the first chunk or the next valid chunk
-                    // otherwise discard content and try again (except if it is the first fetched chunk)
-                    if (chunknum == 0 || (curchunknum && *curchunknum == chunknum)) {
-                        DEBUGMSG(DEBUG, "Found chunk %d with contlen=%zu, lastchunk=%ld\n", *curchunknum, contlen, lastchunknum);
-
-                        write(1, content, contlen);
-
-                        if (lastchunknum != -1 && lastchunknum == chunknum) {
-                            goto Done;
-                        } else {
-                            *curchunknum += 1;
-                            retry = 0;
-                        }
-                    } else {
-                        // retry if the fetched chunk
-                        retry++;
-                        DEBUGMSG(WARNING, "Could not find chunk %d, extracted chunknum is %d (lastchunk=%ld)\n", *curchunknum, chunknum, lastchunknum);
-                    }
-                }
+            if (rc == 1) {
+                goto Done;
             }
+            len = recv(f.sock, out, sizeof(out), MSG_DONTWAIT);
         }
-
-        if(retry > 0) {
-            DEBUGMSG(INFO, "Retry %d of %d\n", retry, maxretry);
+        if (ccnl_fetch_expire(&f, ccnl_rtt_now()) < 0) {
+            goto Error;
         }
     }
 
-    close(sock);
+Error:
+    ccnl_fetch_stats(&f);
+    close(f.sock);
     return 1;
 
 Done:
     DEBUGMSG(DEBUG, "Sucessfully fetched content\n");
-    close(sock);
+    ccnl_fetch_stats(&f);
+    for (n = 0; n < CCNL_FETCH_MAX_WINDOW; n++) {
+        ccnl_free(f.win[n].data);
+    }
+    ccnl_prefix_free(f.prefix);
+    close(f.sock);
     return 0;
 }
 
@@ -18,31 +18,346 @@
  *
  * File history:
  * 2014-09-01 created <basil.kohler@unibas.ch>
+ * 2026-10-18 mmapped input, encoder threads, packed output, signing
  */
 
 
 #define CCNL_MAX_CHUNK_SIZE 4048
 
+/**
+ * @brief Max number of encoder threads
+ */
+#define CCNL_PRODUCE_MAX_THREADS 64
+
+/**
+ * @brief Number of chunks each encoder thread may be ahead of the writer
+ */
+#define CCNL_PRODUCE_BACKLOG    64
+
 #include "ccnl-common.h"
 #include "ccnl-crypto.h"
+#include "ccnl-ext-hmac.h"
+
+#include <pthread.h>
+#include <sys/mman.h>
+
+// what every chunk is made of
+struct ccnl_produce_s {
+    struct ccnl_prefix_s *name; // the name, with a chunk number
+    int suite;
+    uint8_t *in;                // the input data
+    size_t insize;
+    size_t chunk_size;
+    uint32_t lastchunknum;
+    uint8_t *keyval;            // HMAC key (64 bytes), NULL: not signed
+    uint8_t *keyid;             // its digest (32 bytes)
+};
+
+// where the chunks go: a file per chunk in a directory, otherwise
+// back to back to a file descriptor (packed segment or stdout)
+struct ccnl_produce_out_s {
+    char *dirname;
+    char *fname;
+    char *fileext;
+    int fd;
+};
+
+#define CCNL_PRODUCE_SLOT_FREE  0
+#define CCNL_PRODUCE_SLOT_DONE  1
+
+// an encoded chunk waiting for the writer
+struct ccnl_produce_slot_s {
+    uint8_t buf[CCNL_MAX_PACKET_SIZE];
+    size_t offs;
+    size_t len;
+    int state;
+};
+
+// the encoder threads: chunk k is encoded into slot k % nslots, the
+// writer takes the slots in chunk order
+struct ccnl_produce_pool_s {
+    struct ccnl_produce_s *p;
+    struct ccnl_produce_slot_s *slots;
+    uint32_t nslots;
+    uint32_t nchunks;
+    uint32_t next;              // next chunk to encode
+    uint32_t written;           // number of chunks written
+    int error;
+    pthread_mutex_t lock;
+    pthread_cond_t ready;       // the writer waits for chunk 'written'
+    pthread_cond_t space;       // the encoders wait for free slots
+};
+
+// ----------------------------------------------------------------------
+
+static int
+ccnl_produce_encode(struct ccnl_produce_s *p, struct ccnl_prefix_s *name,
+                    uint32_t chunknum, uint8_t *out, size_t *offs, size_t *len)
+{
+    uint8_t *payload = p->in + (size_t) chunknum * p->chunk_size;
+    size_t paylen = p->insize - (size_t) chunknum * p->chunk_size;
+    uint32_t lastchunknum = p->lastchunknum;
+    ccnl_data_opts_u data_opts;
+
+    if (paylen > p->chunk_size) {
+        paylen = p->chunk_size;
+    }
+    *name->chunknum = chunknum;
+    *offs = CCNL_MAX_PACKET_SIZE;
+
+    switch (p->suite) {
+#ifdef USE_SUITE_CCNTLV
+    case CCNL_SUITE_CCNTLV:
+        if (p->keyval) {
+            return ccnl_ccntlv_prependSignedContentWithHdr(name, payload, paylen,
+                                                           &lastchunknum, NULL,
+                                                           p->keyval, p->keyid,
+                                                           offs, out, len);
+        }
+        return ccnl_ccntlv_prependContentWithHdr(name, payload, paylen,
+                                                 &lastchunknum, NULL,
+                                                 offs, out, len);
+#endif
+#ifdef USE_SUITE_NDNTLV
+    case CCNL_SUITE_NDNTLV:
+        if (p->keyval) {
+            return ccnl_ndntlv_prependSignedContent(name, payload, paylen,
+                                                    &lastchunknum, NULL,
+                                                    p->keyval, p->keyid,
+                                                    offs, out, len);
+        }
+        memset(&data_opts, 0, sizeof(data_opts));
+        data_opts.ndntlv.finalblockid = lastchunknum;
+        return ccnl_ndntlv_prependContent(name, payload, paylen, NULL,
+                                          &data_opts.ndntlv, offs, out, len);
+#endif
+    default:
+        (void) data_opts;
+        DEBUGMSG(ERROR, "produce for suite %i is not implemented\n", p->suite);
+        return -1;
+    }
+}
+
+static int
+ccnl_produce_write(struct ccnl_produce_out_s *o, uint32_t chunknum,
+                   uint8_t *data, size_t len)
+{
+    char outpathname[255];
+    int fd = o->fd;
+    ssize_t n;
+
+    if (o->dirname) {
+        snprintf(outpathname, sizeof(outpathname), "%s/%s%u.%s",
+                 o->dirname, o->fname, chunknum, o->fileext);
+        DEBUGMSG(INFO, "writing chunk %u to file %s\n", chunknum, outpathname);
+        fd = creat(outpathname, 0666);
+        if (fd < 0) {
+            perror("creat");
+            return -1;
+        }
+    } else {
+        DEBUGMSG(INFO, "writing chunk %u\n", chunknum);
+    }
+    while (len > 0) {
+        n = write(fd, data, len);
+        if (n < 0) {
+            perror("write");
+            break;
+        }
+        data += n;
+        len -= (size_t) n;
+    }
+    if (o->dirname) {
+        close(fd);
+    }
+    return len ? -1 : 0;
+}
+
+static void*
+ccnl_produce_worker(void *arg)
+{
+    struct ccnl_produce_pool_s *pool = (struct ccnl_produce_pool_s *) arg;
+    // a name of our own, the chunk number is set per chunk
+    struct ccnl_prefix_s *name = ccnl_prefix_dup(pool->p->name);
+
+    pthread_mutex_lock(&pool->lock);
+    if (!name) {
+        pool->error = 1;
+    }
+    for (;;) {
+        struct ccnl_produce_slot_s *slot;
+        uint32_t k;
+        int rc;
+
+        while (!pool->error && pool->next < pool->nchunks &&
+               pool->next - pool->written >= pool->nslots) {
+            pthread_cond_wait(&pool->space, &pool->lock);
+        }
+        if (pool->error || pool->next >= pool->nchunks) {
+            break;
+        }
+        k = pool->next++;
+        slot = &pool->slots[k % pool->nslots];
+        pthread_mutex_unlock(&pool->lock);
+
+        rc = ccnl_produce_encode(pool->p, name, k, slot->buf, &slot->offs,
+                                 &slot->len);
+
+        pthread_mutex_lock(&pool->lock);
+        if (rc) {
+            DEBUGMSG(ERROR, "Error: Failed creating chunk %u\n", k);
+            pool->error = 1;
+        }
+        slot->state = CCNL_PRODUCE_SLOT_DONE;
+        if (rc || k == pool->written) {
+            pthread_cond_signal(&pool->ready);
+        }
+    }
+    // wake the others and the writer for the error
+    pthread_cond_broadcast(&pool->space);
+    pthread_cond_signal(&pool->ready);
+    pthread_mutex_unlock(&pool->lock);
+    if (name) {
+        ccnl_prefix_free(name);
+    }
+    return NULL;
+}
+
+// encodes the chunks in several threads, and writes them in order
+static int
+ccnl_produce_parallel(struct ccnl_produce_s *p, struct ccnl_produce_out_s *o,
+                      uint32_t nchunks, int nthreads)
+{
+    struct ccnl_produce_pool_s pool;
+    pthread_t th[CCNL_PRODUCE_MAX_THREADS];
+    int k, started = 0, rc = 0;
+    uint32_t n, cnt;
+
+    memset(&pool, 0, sizeof(pool));
+    pool.p = p;
+    pool.nchunks = nchunks;
+    pool.nslots = (uint32_t) nthreads * CCNL_PRODUCE_BACKLOG;
+    pool.slots = (struct ccnl_produce_slot_s *)
+                 ccnl_calloc(pool.nslots, sizeof(struct ccnl_produce_slot_s));
+    if (!pool.slots) {
+        DEBUGMSG(ERROR, "Error: Failed to allocate memory\n");
+        return -1;
+    }
+    pthread_mutex_init(&pool.lock, NULL);
+    pthread_cond_init(&pool.ready, NULL);
+    pthread_cond_init(&pool.space, NULL);
+
+    for (k = 0; k < nthreads; k++, started++) {
+        if (pthread_create(&th[k], NULL, ccnl_produce_worker, &pool)) {
+            DEBUGMSG(ERROR, "Error: Failed to start encoder thread %d\n", k);
+            pthread_mutex_lock(&pool.lock);
+            pool.error = 1;
+            pthread_mutex_unlock(&pool.lock);
+            break;
+        }
+    }
+
+    pthread_mutex_lock(&pool.lock);
+    while (started > 0 && pool.written < nchunks && !pool.error) {
+        // take all chunks which are done in order
+        for (cnt = 0; pool.written + cnt < nchunks && cnt < pool.nslots; cnt++) {
+            if (pool.slots[(pool.written + cnt) % pool.nslots].state !=
+                                                CCNL_PRODUCE_SLOT_DONE) {
+                break;
+            }
+        }
+        if (!cnt) {
+            pthread_cond_wait(&pool.ready, &pool.lock);
+            continue;
+        }
+        pthread_mutex_unlock(&pool.lock);
+
+        for (n = pool.written; n < pool.written + cnt; n++) {
+            struct ccnl_produce_slot_s *slot = &pool.slots[n % pool.nslots];
+
+            if (ccnl_produce_write(o, n, slot->buf + slot->offs, slot->len)) {
+                rc = -1;
+            }
+            slot->state = CCNL_PRODUCE_SLOT_FREE;
+        }
+
+        pthread_mutex_lock(&pool.lock);
+        pool.written += cnt;
+        if (rc) {
+            pool.error = 1;
+        }
+        pthread_cond_broadcast(&pool.space);
+    }
+    if (pool.error || started < nthreads) {
+        rc = -1;
+    }
+    pool.error |= rc;
+    pthread_cond_broadcast(&pool.space);
+    pthread_mutex_unlock(&pool.lock);
+
+    for (k = 0; k < started; k++) {
+        pthread_join(th[k], NULL);
+    }
+    pthread_cond_destroy(&pool.space);
+    pthread_cond_destroy(&pool.ready);
+    pthread_mutex_destroy(&pool.lock);
+    ccnl_free(pool.slots);
+    return rc;
+}
+
+// reads a pipe to its end
+static uint8_t*
+ccnl_produce_readall(int f, size_t *size)
+{
+    size_t cap = 64 * 1024;
+    uint8_t *buf = ccnl_malloc(cap), *b;
+    ssize_t n;
+
+    *size = 0;
+    while (buf) {
+        if (*size == cap) {
+            cap *= 2;
+            b = ccnl_realloc(buf, cap);
+            if (!b) {
+                break;
+            }
+            buf = b;
+        }
+        n = read(f, buf + *size, cap - *size);
+        if (n < 0) {
+            DEBUGMSG(ERROR, "Error reading input file; error: %d\n", errno);
+            break;
+        }
+        if (n == 0) {
+            return buf;
+        }
+        *size += (size_t) n;
+    }
+    ccnl_free(buf);
+    return NULL;
+}
 
 int
 main(int argc, char *argv[])
 {
     // char *private_key_path = 0;
     //    char *witness = 0;
-    uint8_t out[65*1024];
+    uint8_t out[CCNL_MAX_PACKET_SIZE];
     char *publisher = 0;
-    char *infname = 0, *outdirname = 0, *outfname = 0;
-    size_t contentlen = 0, plen;
-    int f, fout, opt;
+    char *infname = 0, *outdirname = 0, *outfname = 0, *packfname = 0;
+    size_t plen, offs, len;
+    int f, opt, nthreads = 1, rc = 0;
     //    int suite = CCNL_SUITE_DEFAULT;
     int suite = CCNL_SUITE_CCNTLV;
     size_t chunk_size = CCNL_MAX_CHUNK_SIZE;
-    struct ccnl_prefix_s *name;
-    ccnl_data_opts_u data_opts;
+    struct key_s *keys = NULL;
+    uint8_t keyval[64], keyid[32];
+    struct ccnl_produce_s p;
+    struct ccnl_produce_out_s o;
+    int mapped = 0;
+    uint32_t chunknum = 0, nchunks;
 
-    while ((opt = getopt(argc, argv, "hc:f:i:o:p:k:w:s:v:")) != -1) {
+    while ((opt = getopt(argc, argv, "hc:f:i:j:k:o:p:P:w:s:v:")) != -1) {
         switch (opt) {
         case 'c':
             chunk_size = (size_t) strtol(optarg, (char **) NULL, 10);
@@ -57,13 +372,28 @@ main(int argc, char *argv[])
         case 'i':
             infname = optarg;
             break;
+        case 'j':
+            nthreads = (int) strtol(optarg, (char **) NULL, 10);
+            if (nthreads < 1 || nthreads > CCNL_PRODUCE_MAX_THREADS) {
+                DEBUGMSG(ERROR, "number of threads must be between 1 and %d\n",
+                         CCNL_PRODUCE_MAX_THREADS);
+                goto Usage;
+            }
+            break;
+        case 'k':
+            keys = load_keys_from_file(optarg);
+            if (!keys) {
+                DEBUGMSG(ERROR, "no key in file %s\n", optarg);
+                exit(-1);
+            }
+            break;
         case 'o':
             outdirname = optarg;
             break;
-/*
-        case 'k':
-            private_key_path = optarg;
+        case 'P':
+            packfname = optarg;
             break;
+/*
         case 'w':
             witness = optarg;
             break;
@@ -96,8 +426,12 @@ Usage:
         "usage: %s [options] URL\n"
         "  -c SIZE          size for each chunk (max %d)\n"
         "  -f FNAME         filename of the chunks when using -o\n"
-        "  -i FNAME         input file (instead of stdin)\n"
+        "  -i FNAME         input file (instead of stdin), it is mapped into memory\n"
+        "  -j THREADS       encode the chunks with this many threads (max %d)\n"
+        "  -k FNAME         HMAC256 key (base64 encoded), the chunks are signed with the first one\n"
         "  -o DIR           output dir (instead of stdout), filename default is cN, otherwise specify -f\n"
+        "  -P FNAME         packed output: all chunks in order in this file (instead of stdout),\n"
+        "                   a relay loads it like the chunk files from its -d directory\n"
         "  -p DIGEST        publisher fingerprint\n"
         "  -s SUITE         (ccnb, ccnx2015, ndn2013)\n"
 #ifdef USE_LOGGING
@@ -105,7 +439,7 @@ Usage:
 #endif
         ,
         argv[0],
-        CCNL_MAX_CHUNK_SIZE);
+        CCNL_MAX_CHUNK_SIZE, CCNL_PRODUCE_MAX_THREADS);
         exit(1);
         }
     }
@@ -119,8 +453,24 @@ Usage:
         goto Usage;
     }
 
-    char *url_orig = argv[optind];
-    char url[strlen(url_orig)];
+    if (chunk_size < 1) {
+        DEBUGMSG(ERROR, "Error: chunk size must be positive\n");
+        goto Usage;
+    }
+    if (outdirname && packfname) {
+        DEBUGMSG(ERROR, "Error: -o and -P exclude each other\n");
+        goto Usage;
+    }
+
+    memset(&p, 0, sizeof(p));
+    memset(&o, 0, sizeof(o));
+    p.suite = suite;
+    p.chunk_size = chunk_size;
+    p.name = ccnl_URItoPrefix(argv[optind], suite, &chunknum);
+    if (!p.name) {
+        DEBUGMSG(ERROR, "Error: invalid URL %s\n", argv[optind]);
+        exit(1);
+    }
     optind++;
 
     int status;
@@ -155,6 +505,7 @@ Usage:
         f = open(infname, O_RDONLY);
         if (f < 0) {
             perror("file open:");
+            exit(1);
         }
     } else {
         f = 0;
@@ -167,19 +518,6 @@ Usage:
         DEBUGMSG(WARNING, "filename -f without -o output dir does nothing\n");
     }
 
-    uint8_t *chunk_buf;
-    chunk_buf = ccnl_malloc(chunk_size * sizeof(uint8_t));
-    if (!chunk_buf) {
-        DEBUGMSG(ERROR, "Error: Failed to allocate memory\n");
-        exit(1);
-    }
-    size_t chunk_len;
-    ssize_t s_chunk_len;
-    int8_t is_last = 0;
-    size_t offs;
-    uint32_t chunknum = 0;
-
-    char outpathname[255];
     char fileext[10];
     switch (suite) {
         case CCNL_SUITE_CCNB:
@@ -194,105 +532,86 @@ Usage:
         default:
             DEBUGMSG(ERROR, "fileext for suite %d not implemented\n", suite);
     }
+    o.dirname = outdirname;
+    o.fname = outfname;
+    o.fileext = fileext;
+    o.fd = 1;
 
-    
-    FILE *fp = fopen(infname, "r");
-    fseek(fp, 0L, SEEK_END);
-    long sz = ftell(fp);
-    size_t isz;
-    if (sz < 0) {
-        DEBUGMSG(ERROR, "Error reading input file offset; error: %d\n", errno);
-        exit(1);
-    }
-    if ((unsigned long) sz > SIZE_MAX) {
-        DEBUGMSG(ERROR, "Input file offset exceeds bounds: %ld", sz);
-        exit(1);
-    }
-    isz = (size_t) sz;
-    rewind(fp);
-    fclose(fp);
-
-    size_t lastchunknum_s = (isz / chunk_size);
-    if (lastchunknum_s > UINT32_MAX) {
-        DEBUGMSG(ERROR, "lastchunknum exceeds bounds: %zu", lastchunknum_s);
-        exit(1);
-    }
-    uint32_t lastchunknum = (uint32_t) lastchunknum_s;
-    if (sz % chunk_size == 0) {
-        --lastchunknum;
+    // the number of the last chunk goes into every chunk: a regular file
+    // is mapped, a pipe has to be read to its end first
+    if (!fstat(f, &st_buf) && S_ISREG(st_buf.st_mode)) {
+        if ((unsigned long long) st_buf.st_size > SIZE_MAX) {
+            DEBUGMSG(ERROR, "Input file size exceeds bounds: %lld", (long long) st_buf.st_size);
+            exit(1);
+        }
+        p.insize = (size_t) st_buf.st_size;
+        if (p.insize > 0) {
+            p.in = mmap(NULL, p.insize, PROT_READ, MAP_PRIVATE, f, 0);
+            if (p.in == MAP_FAILED) {
+                DEBUGMSG(ERROR, "Error mapping input file; error: %d\n", errno);
+                exit(1);
+            }
+            madvise(p.in, p.insize, MADV_SEQUENTIAL);
+            mapped = 1;
+        }
+    } else {
+        p.in = ccnl_produce_readall(f, &p.insize);
+        if (!p.in) {
+            exit(1);
+        }
     }
 
-    s_chunk_len = read(f, chunk_buf, chunk_size);
-    if (s_chunk_len < 0) {
-        DEBUGMSG(ERROR, "Error reading input file; error: %d\n", errno);
+    if ((p.insize + chunk_size - 1) / chunk_size > UINT32_MAX) {
+        DEBUGMSG(ERROR, "lastchunknum exceeds bounds: %zu", p.insize / chunk_size);
         exit(1);
     }
-    chunk_len = (size_t) s_chunk_len;
-    while (!is_last && chunk_len > 0) {
+    nchunks = (uint32_t) ((p.insize + chunk_size - 1) / chunk_size);
+    p.lastchunknum = nchunks - 1;
 
-        if (chunk_len < chunk_size) {
-            is_last = 1;
+    if (keys) {
+        // use the first key found in the key file
+        if (keys->keylen < 0) {
+            DEBUGMSG(ERROR, "Error: Invalid key length: %d", keys->keylen);
+            exit(1);
         }
+        ccnl_hmac256_keyval(keys->key, (size_t) keys->keylen, keyval);
+        ccnl_hmac256_keyid(keys->key, (size_t) keys->keylen, keyid);
+        p.keyval = keyval;
+        p.keyid = keyid;
+    }
 
-        strncpy(url, url_orig, strlen(url_orig));
-        offs = CCNL_MAX_PACKET_SIZE;
-        name = ccnl_URItoPrefix(url, suite, &chunknum);
-
-        switch (suite) {
-        case CCNL_SUITE_CCNTLV:
-            if (ccnl_ccntlv_prependContentWithHdr(name, chunk_buf, chunk_len, &lastchunknum,
-                                                  //is_last ? &chunknum : NULL,
-                                                  NULL, // int *contentpos
-                                                  &offs, out, &contentlen)) {
-                goto Error;
-            }
-            break;
-        case CCNL_SUITE_NDNTLV:
-            data_opts.ndntlv.finalblockid = lastchunknum;
-            if (ccnl_ndntlv_prependContent(name, chunk_buf, chunk_len, NULL,
-                                           &(data_opts.ndntlv),// is_last ? &chunknum : NULL,
-                                           &offs, out, &contentlen)) {
-                goto Error;
-            }
-            break;
-        default:
-            DEBUGMSG(ERROR, "produce for suite %i is not implemented\n", suite);
-            goto Error;
-            break;
-        }
-
-        if (outdirname) {
-            snprintf(outpathname, sizeof(outpathname), "%s/%s%d.%s", outdirname, outfname, chunknum, fileext);
-
-            DEBUGMSG(INFO, "writing chunk %d to file %s\n", chunknum, outpathname);
-
-            fout = creat(outpathname, 0666);
-            write(fout, out + offs, contentlen);
-            close(fout);
-        } else {
-            DEBUGMSG(INFO, "writing chunk %d\n", chunknum);
-            fwrite(out + offs, sizeof(unsigned char),contentlen, stdout);
+    if (packfname) {
+        o.fd = creat(packfname, 0666);
+        if (o.fd < 0) {
+            perror("creat");
+            exit(1);
         }
+    }
 
-        chunknum++;
-        if (!is_last) {
-            s_chunk_len = read(f, chunk_buf, chunk_size);
-            if (s_chunk_len < 0) {
-                DEBUGMSG(ERROR, "Error reading input file; error: %d\n", errno);
-                exit(1);
+    if (nthreads > 1 && nchunks > 1) {
+        rc = ccnl_produce_parallel(&p, &o, nchunks, nthreads);
+    } else {
+        for (chunknum = 0; chunknum < nchunks && !rc; chunknum++) {
+            if (ccnl_produce_encode(&p, p.name, chunknum, out, &offs, &len)) {
+                DEBUGMSG(ERROR, "Error: Failed creating chunk %u\n", chunknum);
+                rc = -1;
+            } else {
+                rc = ccnl_produce_write(&o, chunknum, out + offs, len);
             }
-            chunk_len = (size_t) s_chunk_len;
         }
     }
 
+    if (packfname) {
+        close(o.fd);
+    }
+    if (mapped) {
+        munmap(p.in, p.insize);
+    } else {
+        ccnl_free(p.in);
+    }
+    ccnl_prefix_free(p.name);
     close(f);
-    ccnl_free(chunk_buf);
-    return 0;
-
-Error:
-    close(f);
-    ccnl_free(chunk_buf);
-    return -1;
+    return rc;
 }
 
 // eof
@@ -0,0 +1,119 @@
+/**
+ * @file test_ageing.c
+ * @brief Tests for the expiry queues of the ageing
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include "ccnl-core.h"
+
+void test_ageq_order()
+{
+    struct ccnl_ageq_s q;
+    struct ccnl_ageq_entry_s e[3];
+    int obj[3];
+
+    memset(&q, 0, sizeof(q));
+    memset(e, 0, sizeof(e));
+    ccnl_ageq_add(&q, &e[0], 10, &obj[0]);
+    ccnl_ageq_add(&q, &e[1], 20, &obj[1]);
+    // due before the tail: handled together with it
+    ccnl_ageq_add(&q, &e[2], 15, &obj[2]);
+    assert_int_equal(20, e[2].due);
+    assert_int_equal(3, q.count);
+
+    assert_null(ccnl_ageq_due(&q, 9));
+    assert_ptr_equal(&obj[0], ccnl_ageq_due(&q, 10));
+    ccnl_ageq_remove(&q, &e[0]);
+    assert_null(ccnl_ageq_due(&q, 19));
+
+    // removing twice is harmless
+    ccnl_ageq_remove(&q, &e[1]);
+    ccnl_ageq_remove(&q, &e[1]);
+    assert_ptr_equal(&obj[2], ccnl_ageq_due(&q, 20));
+    ccnl_ageq_remove(&q, &e[2]);
+    assert_int_equal(0, q.count);
+    assert_null(q.head);
+    assert_null(q.tail);
+}
+
+void test_ageq_wrap()
+{
+    struct ccnl_ageq_s q;
+    struct ccnl_ageq_entry_s e;
+    int obj;
+
+    memset(&q, 0, sizeof(q));
+    ccnl_ageq_add(&q, &e, 5, &obj);
+    assert_null(ccnl_ageq_due(&q, UINT32_MAX - 5));
+    assert_ptr_equal(&obj, ccnl_ageq_due(&q, 6));
+}
+
+void test_ageq_insert()
+{
+    struct ccnl_ageq_s q;
+    struct ccnl_ageq_entry_s e[4];
+    int obj[4];
+
+    memset(&q, 0, sizeof(q));
+    ccnl_ageq_insert(&q, &e[0], 300, &obj[0]);
+    ccnl_ageq_insert(&q, &e[1], 100, &obj[1]);
+    ccnl_ageq_insert(&q, &e[2], 200, &obj[2]);
+    ccnl_ageq_insert(&q, &e[3], 300, &obj[3]);
+    // due times are kept, not clamped to the tail
+    assert_int_equal(100, e[1].due);
+    assert_int_equal(4, q.count);
+
+    assert_ptr_equal(&obj[1], ccnl_ageq_due(&q, 100));
+    ccnl_ageq_remove(&q, &e[1]);
+    assert_ptr_equal(&obj[2], ccnl_ageq_due(&q, 200));
+    ccnl_ageq_remove(&q, &e[2]);
+    assert_ptr_equal(&obj[0], ccnl_ageq_due(&q, 300));
+    ccnl_ageq_remove(&q, &e[0]);
+    assert_ptr_equal(&obj[3], ccnl_ageq_due(&q, 300));
+    assert_ptr_equal(&e[3], q.head);
+    assert_ptr_equal(&e[3], q.tail);
+}
+
+void test_ageing_record()
+{
+    struct ccnl_ageing_stats_s stats;
+
+    memset(&stats, 0, sizeof(stats));
+    ccnl_ageing_record(&stats, 3);
+    ccnl_ageing_record(&stats, 16);
+    ccnl_ageing_record(&stats, 5000);
+    ccnl_ageing_record(&stats, 1000000);
+    assert_int_equal(4, stats.ticks);
+    assert_int_equal(1, stats.hist[0]);
+    assert_int_equal(1, stats.hist[1]);
+    assert_int_equal(1, stats.hist[5]);
+    assert_int_equal(1, stats.hist[CCNL_AGEING_HIST - 1]);
+    assert_int_equal(1000000, stats.max_usec);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_ageq_order),
+        unit_test(test_ageq_wrap),
+        unit_test(test_ageq_insert),
+        unit_test(test_ageing_record),
+    };
+
+    return run_tests(tests);
+}
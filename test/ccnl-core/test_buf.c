@@ -0,0 +1,88 @@
+/**
+ * @file test_buf.c
+ * @brief Tests for the shared packet buffers
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include "ccnl-core.h"
+
+static struct ccnl_buf_s *sent[4];
+static int nsent;
+
+static void
+record_TX(struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc,
+          sockunion *dest, struct ccnl_buf_s *buf)
+{
+    (void) ccnl;
+    (void) ifc;
+    (void) dest;
+    sent[nsent++] = buf;
+    assert_int_equal(2, buf->refcnt);
+}
+
+void test_buf_ref()
+{
+    struct ccnl_buf_s *b = ccnl_buf_new("abc", 3);
+
+    assert_non_null(b);
+    assert_int_equal(1, b->refcnt);
+    assert_ptr_equal(b, ccnl_buf_ref(b));
+    assert_int_equal(2, b->refcnt);
+    ccnl_buf_free(b);
+    assert_int_equal(1, b->refcnt);
+    assert_memory_equal("abc", b->data, 3);
+    ccnl_buf_free(b);
+
+    assert_null(ccnl_buf_ref(NULL));
+    ccnl_buf_free(NULL);
+}
+
+void test_buf_send_shared()
+{
+    struct ccnl_relay_s relay;
+    struct ccnl_face_s f1, f2;
+    struct ccnl_pkt_s pkt;
+
+    memset(&relay, 0, sizeof(relay));
+    memset(&f1, 0, sizeof(f1));
+    memset(&f2, 0, sizeof(f2));
+    memset(&pkt, 0, sizeof(pkt));
+    relay.ccnl_ll_TX_ptr = record_TX;
+    pkt.buf = ccnl_buf_new("data", 4);
+    nsent = 0;
+
+    // both faces get the bytes of the packet, not a copy
+    ccnl_send_pkt(&relay, &f1, &pkt);
+    ccnl_send_pkt(&relay, &f2, &pkt);
+    assert_int_equal(2, nsent);
+    assert_ptr_equal(pkt.buf, sent[0]);
+    assert_ptr_equal(pkt.buf, sent[1]);
+    assert_int_equal(1, pkt.buf->refcnt);
+
+    ccnl_buf_free(pkt.buf);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_buf_ref),
+        unit_test(test_buf_send_shared),
+    };
+
+    return run_tests(tests);
+}
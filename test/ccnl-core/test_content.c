@@ -67,6 +67,37 @@ void test_ccnl_content_free_valid()
     assert_int_equal(result, 0);
 }
 
+void test_ccnl_content_digest()
+{
+    // SHA256("abc")
+    const unsigned char expected[CCNL_CONTENT_DIGEST_LEN] = {
+        0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea,
+        0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+        0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c,
+        0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad
+    };
+    struct ccnl_pkt_s *packet = ccnl_calloc(1, sizeof(struct ccnl_pkt_s));
+    struct ccnl_content_s *content;
+    unsigned char *md;
+
+    packet->buf = ccnl_buf_new("abc", 3);
+    content = ccnl_content_new(&packet);
+    assert_non_null(content);
+    assert_false(content->flags & CCNL_CONTENT_FLAGS_DIGEST);
+
+    md = ccnl_content_digest(content);
+    assert_non_null(md);
+    assert_memory_equal(expected, md, CCNL_CONTENT_DIGEST_LEN);
+    assert_true(content->flags & CCNL_CONTENT_FLAGS_DIGEST);
+
+    // the packet is not hashed again
+    content->pkt->buf->data[0] = 'x';
+    assert_ptr_equal(md, ccnl_content_digest(content));
+    assert_memory_equal(expected, md, CCNL_CONTENT_DIGEST_LEN);
+
+    ccnl_content_free(content);
+}
+
 int main(void)
 {
     const UnitTest tests[] = {
@@ -74,6 +105,7 @@ int main(void)
         unit_test(test_ccnl_content_new_valid),
         unit_test(test_ccnl_content_free_invalid),
         unit_test(test_ccnl_content_free_valid),
+        unit_test(test_ccnl_content_digest),
     };
     
     return run_tests(tests);
@@ -0,0 +1,263 @@
+/**
+ * @file test_cs_policy.c
+ * @brief Tests for the replacement policies of the content store
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include "ccnl-core.h"
+
+static struct ccnl_content_s*
+add_content(struct ccnl_relay_s *relay, const char *uri)
+{
+    char buf[100];
+    struct ccnl_pkt_s *pkt = ccnl_calloc(1, sizeof(*pkt));
+    struct ccnl_content_s *c;
+
+    strcpy(buf, uri);
+    pkt->pfx = ccnl_URItoPrefix(buf, 0, NULL);
+    c = ccnl_content_new(&pkt);
+    assert_non_null(c);
+    assert_true(ccnl_content_add2cache(relay, c) == c);
+    return c;
+}
+
+static int
+is_cached(struct ccnl_relay_s *relay, const char *uri)
+{
+    char buf[100];
+    struct ccnl_prefix_s *pfx;
+    struct ccnl_content_s *c;
+
+    strcpy(buf, uri);
+    pfx = ccnl_URItoPrefix(buf, 0, NULL);
+    c = ccnl_content_lookup(relay, pfx, pfx->compcnt, NULL);
+    ccnl_prefix_free(pfx);
+    return c != NULL;
+}
+
+static void
+setup_relay(struct ccnl_relay_s *relay, ccnl_cs_policy type)
+{
+    memset(relay, 0, sizeof(*relay));
+    relay->max_cache_entries = 3;
+    assert_int_equal(0, ccnl_cs_set_policy(relay, type));
+}
+
+// ccnl_core_cleanup() touches fields behind ifs[], whose offset depends
+// on the compile options of the library
+static void
+cleanup_relay(struct ccnl_relay_s *relay)
+{
+    while (relay->contents) {
+        ccnl_content_remove(relay, relay->contents);
+    }
+    ccnl_htable_cleanup(&relay->cs_index);
+    ccnl_cs_policy_cleanup(relay);
+}
+
+void test_cs_policy_lru()
+{
+    struct ccnl_relay_s relay;
+    struct ccnl_content_s *a;
+
+    setup_relay(&relay, CCNL_CS_POLICY_LRU);
+    a = add_content(&relay, "/a");
+    add_content(&relay, "/b");
+    add_content(&relay, "/c");
+    ccnl_cs_policy_hit(&relay, a);
+    add_content(&relay, "/d");
+
+    assert_int_equal(3, relay.contentcnt);
+    assert_true(is_cached(&relay, "/a"));
+    assert_false(is_cached(&relay, "/b"));
+
+    // static content is never evicted
+    a->flags |= CCNL_CONTENT_FLAGS_STATIC;
+    add_content(&relay, "/e");
+    add_content(&relay, "/f");
+    assert_true(is_cached(&relay, "/a"));
+    assert_false(is_cached(&relay, "/c"));
+    assert_false(is_cached(&relay, "/d"));
+
+    cleanup_relay(&relay);
+}
+
+void test_cs_policy_lfu()
+{
+    struct ccnl_relay_s relay;
+    struct ccnl_content_s *a, *b;
+
+    setup_relay(&relay, CCNL_CS_POLICY_LFU);
+    a = add_content(&relay, "/a");
+    b = add_content(&relay, "/b");
+    add_content(&relay, "/c");
+    ccnl_cs_policy_hit(&relay, a);
+    ccnl_cs_policy_hit(&relay, a);
+    ccnl_cs_policy_hit(&relay, b);
+    add_content(&relay, "/d");
+    assert_false(is_cached(&relay, "/c"));
+    add_content(&relay, "/e");
+    assert_false(is_cached(&relay, "/d"));
+    assert_true(is_cached(&relay, "/a"));
+    assert_true(is_cached(&relay, "/b"));
+
+    cleanup_relay(&relay);
+}
+
+void test_cs_policy_s3fifo()
+{
+    struct ccnl_relay_s relay;
+    struct ccnl_content_s *a, *b;
+
+    setup_relay(&relay, CCNL_CS_POLICY_S3FIFO);
+    a = add_content(&relay, "/a");
+    add_content(&relay, "/b");
+    add_content(&relay, "/c");
+    ccnl_cs_policy_hit(&relay, a);
+
+    // a was used and moves to the main queue, b is evicted instead
+    add_content(&relay, "/d");
+    assert_true(is_cached(&relay, "/a"));
+    assert_false(is_cached(&relay, "/b"));
+    assert_int_equal(2, a->cs_queue);
+
+    // b comes back while its name is remembered
+    b = add_content(&relay, "/b");
+    assert_int_equal(2, b->cs_queue);
+
+    cleanup_relay(&relay);
+}
+
+void test_cs_policy_arc()
+{
+    struct ccnl_relay_s relay;
+    struct ccnl_content_s *a, *b;
+
+    setup_relay(&relay, CCNL_CS_POLICY_ARC);
+    a = add_content(&relay, "/a");
+    add_content(&relay, "/b");
+    add_content(&relay, "/c");
+    ccnl_cs_policy_hit(&relay, a);
+    add_content(&relay, "/d");
+    assert_true(is_cached(&relay, "/a"));
+    assert_false(is_cached(&relay, "/b"));
+
+    // a miss on a remembered name grows the recency queue
+    b = add_content(&relay, "/b");
+    assert_int_equal(2, b->cs_queue);
+    assert_int_equal(1, relay.cs_policy.target);
+
+    cleanup_relay(&relay);
+}
+
+void test_cs_byte_budget()
+{
+    struct ccnl_relay_s relay;
+    struct ccnl_content_s *a;
+    size_t size;
+
+    setup_relay(&relay, CCNL_CS_POLICY_LRU);
+    relay.max_cache_entries = -1;
+    a = add_content(&relay, "/a");
+    size = ccnl_content_size(a);
+    assert_int_equal(size, relay.cache_bytes);
+
+    relay.max_cache_bytes = 2 * size;
+    add_content(&relay, "/b");
+    add_content(&relay, "/c");
+    assert_int_equal(2, relay.contentcnt);
+    assert_int_equal(2 * size, relay.cache_bytes);
+    assert_false(is_cached(&relay, "/a"));
+
+    cleanup_relay(&relay);
+    assert_int_equal(0, relay.cache_bytes);
+}
+
+static void
+ask_for(struct ccnl_relay_s *relay, const char *uri, int times)
+{
+    char buf[100];
+    struct ccnl_prefix_s *pfx;
+
+    strcpy(buf, uri);
+    pfx = ccnl_URItoPrefix(buf, 0, NULL);
+    while (times-- > 0) {
+        ccnl_cs_admission_record(relay, pfx);
+    }
+    ccnl_prefix_free(pfx);
+}
+
+void test_cs_admission()
+{
+    struct ccnl_relay_s relay;
+    struct ccnl_content_s *c;
+    struct ccnl_pkt_s *pkt;
+    char buf[100];
+
+    setup_relay(&relay, CCNL_CS_POLICY_LRU);
+    assert_int_equal(0, ccnl_cs_set_admission(&relay, 64));
+    ask_for(&relay, "/a", 3);
+    ask_for(&relay, "/b", 1);
+    ask_for(&relay, "/c", 2);
+    add_content(&relay, "/a");
+    add_content(&relay, "/b");
+    add_content(&relay, "/c");
+
+    // /d was asked for once, no more often than the victim /a
+    ask_for(&relay, "/d", 1);
+    strcpy(buf, "/d");
+    pkt = ccnl_calloc(1, sizeof(*pkt));
+    pkt->pfx = ccnl_URItoPrefix(buf, 0, NULL);
+    c = ccnl_content_new(&pkt);
+    assert_null(ccnl_content_add2cache(&relay, c));
+    assert_int_equal(1, relay.cs_stats.rejected);
+    ccnl_content_free(c);
+    assert_true(is_cached(&relay, "/a"));
+
+    // more popular than the victim, /d replaces /a
+    ask_for(&relay, "/d", 4);
+    add_content(&relay, "/d");
+    assert_false(is_cached(&relay, "/a"));
+    assert_true(is_cached(&relay, "/d"));
+    assert_true(ccnl_cs_admission_estimate(&relay, relay.contents) >= 1);
+
+    cleanup_relay(&relay);
+    ccnl_cs_set_admission(&relay, 0);
+}
+
+void test_cs_policy_names()
+{
+    assert_int_equal(CCNL_CS_POLICY_S3FIFO, ccnl_cs_policy_from_str("s3fifo"));
+    assert_int_equal(-1, ccnl_cs_policy_from_str("mru"));
+    assert_string_equal("arc", ccnl_cs_policy_to_str(CCNL_CS_POLICY_ARC));
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_cs_policy_lru),
+        unit_test(test_cs_policy_lfu),
+        unit_test(test_cs_policy_s3fifo),
+        unit_test(test_cs_policy_arc),
+        unit_test(test_cs_byte_budget),
+        unit_test(test_cs_admission),
+        unit_test(test_cs_policy_names),
+    };
+
+    return run_tests(tests);
+}
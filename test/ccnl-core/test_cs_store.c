@@ -0,0 +1,245 @@
+/**
+ * @file test_cs_store.c
+ * @brief Tests for the persistent content store
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "ccnl-cs-store.h"
+
+#define TEST_OBJECTS    3000
+
+static char dir[64];
+
+static void
+store_path(char *path, size_t size, const char *name)
+{
+    snprintf(path, size, "%s/%s", dir, name);
+}
+
+static void
+store_remove(void)
+{
+    char name[32], path[128];
+    int n;
+
+    for (n = 0; n < 128; n++) {
+        snprintf(name, sizeof(name), "cs-%06d.seg", n);
+        store_path(path, sizeof(path), name);
+        unlink(path);
+        snprintf(name, sizeof(name), "cs-%06d.idx", n);
+        store_path(path, sizeof(path), name);
+        unlink(path);
+    }
+    rmdir(dir);
+}
+
+// the packets are their own keys: "packet <n>", hash n % 97
+static int
+count_packets(struct ccnl_cs_store_s *s, uint32_t n)
+{
+    const uint8_t *data;
+    char want[32];
+    uint32_t pos = 0;
+    size_t len;
+    int found = 0;
+
+    snprintf(want, sizeof(want), "packet %u", n);
+    while ((data = ccnl_cs_store_get(s, n % 97, &pos, &len))) {
+        if (len == strlen(want) && !memcmp(data, want, len)) {
+            found++;
+        }
+    }
+    return found;
+}
+
+static void
+append_packets(struct ccnl_cs_store_s *s, uint32_t from, uint32_t to)
+{
+    char pkt[32];
+    uint32_t n;
+
+    for (n = from; n < to; n++) {
+        snprintf(pkt, sizeof(pkt), "packet %u", n);
+        assert_int_equal(0, ccnl_cs_store_append(s, n % 97, (uint8_t *) pkt,
+                                                 strlen(pkt)));
+    }
+}
+
+void test_cs_store_append_get()
+{
+    struct ccnl_cs_store_s *s;
+    uint32_t n;
+
+    s = ccnl_cs_store_open(dir, 0);
+    assert_non_null(s);
+    assert_int_equal(0, s->cnt);
+    assert_int_equal(-1, ccnl_cs_store_append(s, 1, (uint8_t *) "", 0));
+
+    // the index grows while the packets are appended
+    append_packets(s, 0, TEST_OBJECTS);
+    assert_int_equal(TEST_OBJECTS, s->cnt);
+    assert_int_equal(1, s->segcnt);
+    for (n = 0; n < TEST_OBJECTS; n++) {
+        assert_int_equal(1, count_packets(s, n));
+    }
+    assert_int_equal(0, count_packets(s, TEST_OBJECTS));
+    ccnl_cs_store_close(s);
+    store_remove();
+}
+
+void test_cs_store_reopen()
+{
+    struct ccnl_cs_store_s *s;
+    uint32_t n;
+
+    s = ccnl_cs_store_open(dir, 0);
+    append_packets(s, 0, 100);
+    ccnl_cs_store_close(s);
+
+    // reopened, the store has all packets; appending starts a new segment
+    s = ccnl_cs_store_open(dir, 0);
+    assert_non_null(s);
+    assert_int_equal(100, s->cnt);
+    append_packets(s, 100, 200);
+    assert_int_equal(2, s->segcnt);
+    for (n = 0; n < 200; n++) {
+        assert_int_equal(1, count_packets(s, n));
+    }
+    ccnl_cs_store_close(s);
+
+    s = ccnl_cs_store_open(dir, 0);
+    assert_int_equal(200, s->cnt);
+    ccnl_cs_store_close(s);
+    store_remove();
+}
+
+void test_cs_store_interrupted()
+{
+    struct ccnl_cs_store_s *s;
+    struct ccnl_cs_store_rec_s rec = { 7, 1000, 10, 0 };
+    char path[128];
+    int fd;
+
+    s = ccnl_cs_store_open(dir, 0);
+    append_packets(s, 0, 10);
+    ccnl_cs_store_close(s);
+
+    // a record of a packet which was not written, then half a record
+    store_path(path, sizeof(path), "cs-000000.idx");
+    fd = open(path, O_WRONLY | O_APPEND);
+    assert_true(fd >= 0);
+    assert_int_equal(sizeof(rec), write(fd, &rec, sizeof(rec)));
+    assert_int_equal(5, write(fd, &rec, 5));
+    close(fd);
+
+    s = ccnl_cs_store_open(dir, 0);
+    assert_non_null(s);
+    assert_int_equal(10, s->cnt);
+    assert_int_equal(1, count_packets(s, 7));
+    ccnl_cs_store_close(s);
+    store_remove();
+}
+
+void test_cs_store_max_size()
+{
+    struct ccnl_cs_store_s *s;
+    uint32_t n;
+
+    // segments of 1000 bytes, about 90 packets each
+    s = ccnl_cs_store_open(dir, 4000);
+    assert_non_null(s);
+    append_packets(s, 0, 1000);
+    assert_true(s->size <= 4000);
+    assert_true(s->size > 3000);
+    assert_true(s->segcnt >= 9);
+
+    // the oldest segments are gone with their packets
+    assert_int_equal(0, count_packets(s, 0));
+    assert_int_equal(0, count_packets(s, 500));
+    for (n = 800; n < 1000; n++) {
+        assert_int_equal(1, count_packets(s, n));
+    }
+    ccnl_cs_store_close(s);
+
+    s = ccnl_cs_store_open(dir, 4000);
+    assert_int_equal(0, s->size);
+    ccnl_cs_store_adopt(s);
+    assert_true(s->size <= 4000);
+    assert_int_equal(0, count_packets(s, 0));
+    assert_int_equal(1, count_packets(s, 999));
+    ccnl_cs_store_close(s);
+    store_remove();
+}
+
+void test_cs_store_pinned()
+{
+    struct ccnl_cs_store_s *s;
+
+    // an import, then packets of another writer
+    s = ccnl_cs_store_open(dir, 0);
+    ccnl_cs_store_pin(s, 1);
+    append_packets(s, 0, 100);
+    ccnl_cs_store_pin(s, 0);
+    append_packets(s, 100, 200);
+    ccnl_cs_store_close(s);
+
+    // without adopting them, only the store's own packets are deleted
+    s = ccnl_cs_store_open(dir, 4000);
+    append_packets(s, 1000, 2000);
+    assert_true(s->size <= 4000);
+    assert_int_equal(1, count_packets(s, 0));
+    assert_int_equal(1, count_packets(s, 150));
+    assert_int_equal(0, count_packets(s, 1000));
+    assert_int_equal(1, count_packets(s, 1999));
+    ccnl_cs_store_close(s);
+
+    // adopted, the packets of earlier runs go, the pinned ones stay
+    s = ccnl_cs_store_open(dir, 4000);
+    ccnl_cs_store_adopt(s);
+    append_packets(s, 2000, 3000);
+    assert_true(s->size <= 4000);
+    assert_int_equal(1, count_packets(s, 0));
+    assert_int_equal(1, count_packets(s, 99));
+    assert_int_equal(0, count_packets(s, 150));
+    assert_int_equal(0, count_packets(s, 1999));
+    assert_int_equal(1, count_packets(s, 2999));
+    ccnl_cs_store_close(s);
+
+    s = ccnl_cs_store_open(dir, 0);
+    assert_int_equal(1, count_packets(s, 50));
+    ccnl_cs_store_close(s);
+    store_remove();
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_cs_store_append_get),
+        unit_test(test_cs_store_reopen),
+        unit_test(test_cs_store_interrupted),
+        unit_test(test_cs_store_max_size),
+        unit_test(test_cs_store_pinned),
+    };
+
+    snprintf(dir, sizeof(dir), "/tmp/test_cs_store.%d", (int) getpid());
+    return run_tests(tests);
+}
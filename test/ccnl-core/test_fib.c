@@ -0,0 +1,112 @@
+/**
+ * @file test_fib.c
+ * @brief Tests for the FIB prefix index
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include "ccnl-core.h"
+
+#define TEST_FIB_SUITE 0
+
+static struct ccnl_forward_s*
+add_route(struct ccnl_relay_s *relay, const char *uri, struct ccnl_face_s *face)
+{
+    char buf[100];
+    struct ccnl_forward_s *fwd = ccnl_calloc(1, sizeof(*fwd));
+
+    strcpy(buf, uri);
+    fwd->prefix = ccnl_URItoPrefix(buf, TEST_FIB_SUITE, NULL);
+    fwd->suite = TEST_FIB_SUITE;
+    fwd->face = face;
+    assert_int_equal(0, ccnl_fib_link(relay, fwd));
+    return fwd;
+}
+
+static struct ccnl_prefix_s*
+name(const char *uri)
+{
+    char buf[100];
+
+    strcpy(buf, uri);
+    return ccnl_URItoPrefix(buf, TEST_FIB_SUITE, NULL);
+}
+
+void test_fib_longest_match()
+{
+    struct ccnl_relay_s relay;
+    struct ccnl_face_s f1, f2;
+    struct ccnl_forward_s *a, *ab, *ab2, *fwd;
+    struct ccnl_prefix_s *p;
+
+    memset(&relay, 0, sizeof(relay));
+    memset(&f1, 0, sizeof(f1));
+    memset(&f2, 0, sizeof(f2));
+    a = add_route(&relay, "/a", &f1);
+    ab = add_route(&relay, "/a/b", &f1);
+    ab2 = add_route(&relay, "/a/b", &f2);
+    // each face lists its FIB entries
+    assert_true(f1.fwds == ab && ab->face_next == a && !a->face_next);
+    assert_true(f2.fwds == ab2 && !ab2->face_next);
+
+    p = name("/a/b/c");
+    fwd = ccnl_fib_longest_match(&relay, p);
+    assert_true(fwd == ab || fwd == ab2);
+    fwd = ccnl_fib_lookup(&relay, p, 2, fwd);
+    assert_true(fwd == ab || fwd == ab2);
+    assert_null(ccnl_fib_lookup(&relay, p, 2, fwd));
+    ccnl_prefix_free(p);
+
+    p = name("/a/x");
+    assert_true(ccnl_fib_longest_match(&relay, p) == a);
+    ccnl_prefix_free(p);
+
+    p = name("/b");
+    assert_null(ccnl_fib_longest_match(&relay, p));
+    ccnl_prefix_free(p);
+
+    ccnl_fib_unlink(&relay, ab);
+    ccnl_fib_unlink(&relay, ab2);
+    assert_true(f1.fwds == a && !a->face_prev);
+    assert_null(f2.fwds);
+    p = name("/a/b/c");
+    assert_true(ccnl_fib_longest_match(&relay, p) == a);
+    ccnl_prefix_free(p);
+    assert_true(relay.fib == a);
+
+    ccnl_fib_unlink(&relay, a);
+    assert_null(relay.fib);
+    assert_null(f1.fwds);
+    assert_int_equal(0, relay.fib_index.count);
+
+    ccnl_prefix_free(a->prefix);
+    ccnl_prefix_free(ab->prefix);
+    ccnl_prefix_free(ab2->prefix);
+    ccnl_free(a);
+    ccnl_free(ab);
+    ccnl_free(ab2);
+    ccnl_htable_cleanup(&relay.fib_index);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_fib_longest_match),
+    };
+
+    return run_tests(tests);
+}
@@ -0,0 +1,76 @@
+/**
+ * @file test_htable.c
+ * @brief Tests for the hash table functions
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include "ccnl-htable.h"
+
+#define TEST_HTABLE_ENTRIES 100
+
+void test_htable_lookup_empty()
+{
+    struct ccnl_htable_s table = { NULL, 0, 0 };
+    assert_null(ccnl_htable_lookup(&table, 42));
+}
+
+void test_htable_add_lookup_remove()
+{
+    struct ccnl_htable_s table = { NULL, 0, 0 };
+    struct ccnl_hentry_s entries[TEST_HTABLE_ENTRIES] = {{ NULL, 0, NULL }};
+    int objs[TEST_HTABLE_ENTRIES];
+    struct ccnl_hentry_s *e;
+    int i;
+
+    for (i = 0; i < TEST_HTABLE_ENTRIES; i++) {
+        objs[i] = i;
+        // two entries share each hash value
+        assert_int_equal(0, ccnl_htable_add(&table, &entries[i], i / 2, &objs[i]));
+    }
+    assert_int_equal(TEST_HTABLE_ENTRIES, table.count);
+    assert_true(table.size >= TEST_HTABLE_ENTRIES);
+
+    e = ccnl_htable_lookup(&table, 7);
+    assert_non_null(e);
+    assert_int_equal(7, *(int *) e->obj / 2);
+    e = ccnl_htable_next(e);
+    assert_non_null(e);
+    assert_int_equal(7, *(int *) e->obj / 2);
+    assert_null(ccnl_htable_next(e));
+
+    ccnl_htable_remove(&table, &entries[14]);
+    ccnl_htable_remove(&table, &entries[14]);
+    assert_int_equal(TEST_HTABLE_ENTRIES - 1, table.count);
+    e = ccnl_htable_lookup(&table, 7);
+    assert_non_null(e);
+    assert_int_equal(15, *(int *) e->obj);
+    assert_null(ccnl_htable_next(e));
+
+    ccnl_htable_cleanup(&table);
+    assert_null(ccnl_htable_lookup(&table, 7));
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_htable_lookup_empty),
+        unit_test(test_htable_add_lookup_remove),
+    };
+
+    return run_tests(tests);
+}
@@ -22,6 +22,7 @@
 #include <cmocka.h>
  
 #include "ccnl-interest.h"
+#include "ccnl-prefix.h"
 
 
 void test_ccnl_interest_append_pending_invalid_parameters()
@@ -54,6 +55,49 @@ void test_ccnl_interest_remove_pending_invalid_parameters()
     assert_int_equal(result, -2); 
 }
 
+void test_ccnl_interest_face_backrefs()
+{
+    struct ccnl_interest_s interest;
+    struct ccnl_pkt_s pkt;
+    struct ccnl_face_s f1, f2;
+    char uri[] = "/a/b";
+
+    memset(&interest, 0, sizeof(interest));
+    memset(&pkt, 0, sizeof(pkt));
+    memset(&f1, 0, sizeof(f1));
+    memset(&f2, 0, sizeof(f2));
+    f1.faceid = 1;
+    f2.faceid = 2;
+    pkt.pfx = ccnl_URItoPrefix(uri, 0, NULL);
+    interest.pkt = &pkt;
+
+    /** each face lists the pending entries which refer to it */
+    assert_int_equal(0, ccnl_interest_append_pending(&interest, &f1));
+    assert_int_equal(0, ccnl_interest_append_pending(&interest, &f2));
+    assert_int_equal(0, ccnl_interest_append_pending(&interest, &f1));
+    assert_non_null(f1.pendints);
+    assert_ptr_equal(&interest, f1.pendints->interest);
+    assert_null(f1.pendints->face_next);
+    assert_ptr_equal(&interest, f2.pendints->interest);
+
+    assert_int_equal(1, ccnl_interest_remove_pending(&interest, &f1));
+    assert_null(f1.pendints);
+    assert_ptr_equal(f2.pendints, interest.pending);
+
+    ccnl_interest_set_from(&interest, &f1);
+    assert_ptr_equal(&interest, f1.interests);
+    ccnl_interest_set_from(&interest, &f2);
+    assert_null(f1.interests);
+    assert_ptr_equal(&interest, f2.interests);
+    ccnl_interest_set_from(&interest, NULL);
+    assert_null(f2.interests);
+
+    assert_int_equal(1, ccnl_interest_remove_pending(&interest, &f2));
+    assert_null(f2.pendints);
+    assert_null(interest.pending);
+    ccnl_prefix_free(pkt.pfx);
+}
+
 void test1()
 {
   int result = 0;
@@ -67,6 +111,7 @@ int main(void)
     unit_test(test_ccnl_interest_is_same_invalid_parameters),
     unit_test(test_ccnl_interest_remove_pending_invalid_parameters),
     unit_test(test_ccnl_interest_append_pending_invalid_parameters),
+    unit_test(test_ccnl_interest_face_backrefs),
   };
  
   return run_tests(tests);
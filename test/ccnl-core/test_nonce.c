@@ -0,0 +1,103 @@
+/**
+ * @file test_nonce.c
+ * @brief Tests for the duplicate nonce detection
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include "ccnl-core.h"
+
+void test_nonce_window()
+{
+    struct ccnl_nonce_filter_s f;
+
+    memset(&f, 0, sizeof(f));
+    assert_int_equal(0, ccnl_nonce_filter_config(&f, 16, 2));
+
+    assert_int_equal(0, ccnl_nonce_filter_check(&f, 42, 100));
+    assert_int_equal(1, ccnl_nonce_filter_check(&f, 42, 100));
+    assert_int_equal(0, ccnl_nonce_filter_check(&f, 43, 101));
+
+    // remembered in the previous window
+    assert_int_equal(1, ccnl_nonce_filter_check(&f, 42, 102));
+    assert_int_equal(1, f.rotations);
+
+    // forgotten after two windows
+    assert_int_equal(0, ccnl_nonce_filter_check(&f, 42, 106));
+    assert_int_equal(0, ccnl_nonce_filter_check(&f, 43, 106));
+    assert_int_equal(2, ccnl_nonce_filter_count(&f));
+    assert_int_equal(2, f.dups);
+    assert_int_equal(6, f.checked);
+
+    ccnl_nonce_filter_cleanup(&f);
+}
+
+void test_nonce_capacity()
+{
+    struct ccnl_nonce_filter_s f;
+    uint32_t h;
+
+    memset(&f, 0, sizeof(f));
+    assert_int_equal(-1, ccnl_nonce_filter_config(&f, 0, 2));
+    assert_int_equal(0, ccnl_nonce_filter_config(&f, 4, 100));
+
+    // a full set is rotated early, colliding slots are probed
+    for (h = 1; h <= 12; h++) {
+        assert_int_equal(0, ccnl_nonce_filter_check(&f, h * 8, 0));
+    }
+    assert_int_equal(2, f.rotations);
+    assert_int_equal(8, ccnl_nonce_filter_count(&f));
+    assert_int_equal(1, ccnl_nonce_filter_check(&f, 12 * 8, 0));
+    assert_int_equal(1, ccnl_nonce_filter_check(&f, 5 * 8, 0));
+    assert_int_equal(0, ccnl_nonce_filter_check(&f, 4 * 8, 0));
+
+    ccnl_nonce_filter_cleanup(&f);
+}
+
+void test_nonce_hash()
+{
+    char buf[20];
+    struct ccnl_prefix_s *p1, *p2;
+    struct ccnl_buf_s *n1 = ccnl_buf_new("1234", 4);
+    struct ccnl_buf_s *n2 = ccnl_buf_new("1235", 4);
+
+    strcpy(buf, "/a/b");
+    p1 = ccnl_URItoPrefix(buf, 0, NULL);
+    strcpy(buf, "/a/c");
+    p2 = ccnl_URItoPrefix(buf, 0, NULL);
+
+    // the same nonce for another name is not a duplicate
+    assert_int_equal(ccnl_nonce_hash(p1, n1), ccnl_nonce_hash(p1, n1));
+    assert_int_not_equal(ccnl_nonce_hash(p1, n1), ccnl_nonce_hash(p2, n1));
+    assert_int_not_equal(ccnl_nonce_hash(p1, n1), ccnl_nonce_hash(p1, n2));
+
+    ccnl_prefix_free(p1);
+    ccnl_prefix_free(p2);
+    ccnl_buf_free(n1);
+    ccnl_buf_free(n2);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_nonce_window),
+        unit_test(test_nonce_capacity),
+        unit_test(test_nonce_hash),
+    };
+
+    return run_tests(tests);
+}
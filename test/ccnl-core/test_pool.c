@@ -0,0 +1,90 @@
+/**
+ * @file test_pool.c
+ * @brief Tests for the object pools and the compact prefixes
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include "ccnl-core.h"
+
+void test_pool_reuse()
+{
+    struct ccnl_pool_s pool = { "test", 40, NULL, NULL, 0, 0, 0, 0 };
+    void *a, *b;
+
+    a = ccnl_pool_alloc(&pool);
+    assert_non_null(a);
+    assert_int_equal(1, pool.nslabs);
+    assert_int_equal(1, pool.inuse);
+    memset(a, 0xff, 40);
+    ccnl_pool_free(a);
+    assert_int_equal(0, pool.inuse);
+
+    // the freed object is handed out again, zeroed
+    b = ccnl_pool_alloc(&pool);
+    assert_ptr_equal(a, b);
+    assert_int_equal(0, ((char *) b)[39]);
+    assert_int_equal(2, pool.allocs);
+    assert_int_equal(0, pool.fallbacks);
+    ccnl_pool_free(b);
+}
+
+void test_pool_foreign()
+{
+    struct ccnl_pkt_s *pkt = ccnl_calloc(1, sizeof(*pkt));
+    uint32_t inuse = ccnl_pool_pkt.inuse;
+
+    // objects from ccnl_malloc() can be released through the pool
+    ccnl_pkt_free(pkt);
+    assert_int_equal(inuse, ccnl_pool_pkt.inuse);
+    ccnl_pool_free(NULL);
+}
+
+void test_prefix_compact()
+{
+    char buf[20];
+    struct ccnl_prefix_s *p;
+
+    strcpy(buf, "/a/b");
+    p = ccnl_URItoPrefix(buf, 0, NULL);
+    assert_non_null(p);
+    assert_int_equal(2, p->compcnt);
+    assert_ptr_equal(p + 1, p->comp);
+
+    // appending moves the components out of the prefix block
+    assert_int_equal(0, ccnl_prefix_appendCmp(p, (uint8_t *) "c", 1));
+    assert_int_equal(3, p->compcnt);
+    assert_string_equal("/a/b/c", ccnl_prefix_to_str(p, buf, sizeof(buf)));
+    ccnl_prefix_free(p);
+
+    // long names do not fit into the pool
+    p = ccnl_prefix_new(0, CCNL_POOL_PREFIX_COMP + 1);
+    assert_non_null(p);
+    assert_ptr_equal(p + 1, p->comp);
+    ccnl_prefix_free(p);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_pool_reuse),
+        unit_test(test_pool_foreign),
+        unit_test(test_prefix_compact),
+    };
+
+    return run_tests(tests);
+}
@@ -0,0 +1,114 @@
+/**
+ * @file test_populate.c
+ * @brief Tests for populating the content store from files
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <cmocka.h>
+
+#include "ccnl-core.h"
+#include "ccnl-pkt-builder.h"
+#include "ccnl-unix.h"
+
+static char dir[] = "/tmp/test_populate.XXXXXX";
+
+// appends a Data packet of the given payload size to a file
+static void
+write_content(FILE *f, const char *uri, size_t paylen)
+{
+    char buf[100];
+    uint8_t payload[4096];
+    struct ccnl_prefix_s *pfx;
+    struct ccnl_buf_s *pkt;
+    ccnl_data_opts_u opts;
+    size_t offs;
+
+    assert_true(paylen <= sizeof(payload));
+    memset(payload, 'x', paylen);
+    memset(&opts, 0, sizeof(opts));
+    strcpy(buf, uri);
+    pfx = ccnl_URItoPrefix(buf, CCNL_SUITE_NDNTLV, NULL);
+    pkt = ccnl_mkSimpleContent(pfx, payload, paylen, &offs, &opts);
+    assert_non_null(pkt);
+    assert_int_equal(1, fwrite(pkt->data, pkt->datalen, 1, f));
+    ccnl_buf_free(pkt);
+    ccnl_prefix_free(pfx);
+}
+
+static int
+is_cached(struct ccnl_relay_s *relay, const char *uri)
+{
+    char buf[100];
+    struct ccnl_prefix_s *pfx;
+    struct ccnl_content_s *c;
+
+    strcpy(buf, uri);
+    pfx = ccnl_URItoPrefix(buf, CCNL_SUITE_NDNTLV, NULL);
+    c = ccnl_content_lookup(relay, pfx, pfx->compcnt, NULL);
+    ccnl_prefix_free(pfx);
+    return c != NULL;
+}
+
+void test_populate_packed()
+{
+    struct ccnl_relay_s relay;
+    char path[100];
+    FILE *f;
+
+    assert_non_null(mkdtemp(dir));
+    snprintf(path, sizeof(path), "%s/packed", dir);
+    f = fopen(path, "w");
+    assert_non_null(f);
+    write_content(f, "/p/a", 10);
+    write_content(f, "/p/a", 10);
+    write_content(f, "/p/big", 4000);
+    write_content(f, "/p/b", 10);
+    write_content(f, "/p/c", 10);
+    fclose(f);
+
+    memset(&relay, 0, sizeof(relay));
+    relay.max_cache_entries = -1;
+    relay.max_cache_bytes = 3000;
+    assert_int_equal(0, ccnl_cs_set_policy(&relay, CCNL_CS_POLICY_LRU));
+    ccnl_populate_cache(&relay, dir);
+
+    // the duplicate and the object over the budget do not stop the file
+    assert_int_equal(3, relay.contentcnt);
+    assert_true(is_cached(&relay, "/p/a"));
+    assert_false(is_cached(&relay, "/p/big"));
+    assert_true(is_cached(&relay, "/p/b"));
+    assert_true(is_cached(&relay, "/p/c"));
+
+    while (relay.contents) {
+        ccnl_content_remove(&relay, relay.contents);
+    }
+    ccnl_htable_cleanup(&relay.cs_index);
+    ccnl_cs_policy_cleanup(&relay);
+    unlink(path);
+    rmdir(dir);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_populate_packed),
+    };
+
+    return run_tests(tests);
+}
@@ -127,6 +127,69 @@ void test_prefix_no_longest_match()
     assert_int_equal(0, res);
 }
 
+void test_prefix_hash()
+{
+    int prefix_hash_suite = 0;
+    char *c1 = ccnl_malloc(100);
+    strcpy(c1, "/path/to/data");
+    struct ccnl_prefix_s *p1 = ccnl_URItoPrefix(c1, prefix_hash_suite, NULL);
+
+    char *c2 = ccnl_malloc(100);
+    strcpy(c2, "/path/to/data/files");
+    struct ccnl_prefix_s *p2 = ccnl_URItoPrefix(c2, prefix_hash_suite, NULL);
+
+    char *c3 = ccnl_malloc(100);
+    strcpy(c3, "/path/todata");
+    struct ccnl_prefix_s *p3 = ccnl_URItoPrefix(c3, prefix_hash_suite, NULL);
+
+    assert_int_equal(ccnl_prefix_hash(p1, 3), ccnl_prefix_hash(p2, 3));
+    assert_int_equal(ccnl_prefix_hash(p1, 3), ccnl_prefix_hash(p1, 5));
+    assert_true(ccnl_prefix_hash(p1, 3) != ccnl_prefix_hash(p2, 4));
+    assert_true(ccnl_prefix_hash(p1, 3) != ccnl_prefix_hash(p3, 2));
+
+    ccnl_prefix_free(p1);
+    ccnl_prefix_free(p2);
+    ccnl_prefix_free(p3);
+}
+
+void test_prefix_implicit_digest()
+{
+    char uri[100];
+    struct ccnl_pkt_s *pkt = ccnl_calloc(1, sizeof(*pkt));
+    struct ccnl_content_s *c;
+    struct ccnl_prefix_s *i;
+    unsigned char md[CCNL_CONTENT_DIGEST_LEN];
+
+    strcpy(uri, "/path/to/data");
+    pkt->pfx = ccnl_URItoPrefix(uri, 0, NULL);
+    pkt->buf = ccnl_buf_new("packet", 6);
+    c = ccnl_content_new(&pkt);
+    assert_non_null(c);
+
+    // a last component which cannot be a digest is rejected unhashed
+    strcpy(uri, "/path/to/data/files");
+    i = ccnl_URItoPrefix(uri, 0, NULL);
+    assert_int_equal(-1, ccnl_i_prefixof_c(i, 0, 1, c));
+    assert_false(c->flags & CCNL_CONTENT_FLAGS_DIGEST);
+    ccnl_prefix_free(i);
+
+    strcpy(uri, "/path/to/data");
+    i = ccnl_URItoPrefix(uri, 0, NULL);
+    memset(md, 0, sizeof(md));
+    ccnl_prefix_appendCmp(i, md, sizeof(md));
+    assert_int_equal(-1, ccnl_i_prefixof_c(i, 0, 1, c));
+    assert_true(c->flags & CCNL_CONTENT_FLAGS_DIGEST);
+    ccnl_prefix_free(i);
+
+    strcpy(uri, "/path/to/data");
+    i = ccnl_URItoPrefix(uri, 0, NULL);
+    ccnl_prefix_appendCmp(i, ccnl_content_digest(c), CCNL_CONTENT_DIGEST_LEN);
+    assert_int_equal(0, ccnl_i_prefixof_c(i, 0, 1, c));
+    ccnl_prefix_free(i);
+
+    ccnl_content_free(c);
+}
+
 int main(void)
 {
   const UnitTest tests[] = {
@@ -137,6 +200,8 @@ int main(void)
     unit_test(test_prefix_no_exact_match),
     unit_test(test_prefix_longest_match),
     unit_test(test_prefix_no_longest_match),
+    unit_test(test_prefix_hash),
+    unit_test(test_prefix_implicit_digest),
   };
  
   return run_tests(tests);
@@ -0,0 +1,186 @@
+/**
+ * @file test_ring.c
+ * @brief Tests for the lock-free message rings
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "ccnl-core.h"
+
+#define TEST_PRODUCERS  4
+#define TEST_MESSAGES   20000
+
+struct test_msg_s {
+    uint32_t producer;
+    uint32_t seq;
+};
+
+struct test_producer_s {
+    struct ccnl_ring_s *r;
+    uint32_t id;
+};
+
+void test_ring_order()
+{
+    struct ccnl_ring_s r;
+    struct test_msg_s *m;
+    uint32_t k;
+
+    assert_int_equal(-1, ccnl_ring_init(&r, 0, sizeof(*m)));
+    assert_int_equal(0, ccnl_ring_init(&r, 3, sizeof(*m)));
+    assert_int_equal(4, r.depth);
+    assert_int_equal(0, r.stride % CCNL_RING_CACHELINE);
+    assert_null(ccnl_ring_peek(&r));
+
+    // several rounds: the positions wrap around the slots
+    for (k = 0; k < 10; k++) {
+        m = (struct test_msg_s *) ccnl_ring_reserve(&r);
+        assert_non_null(m);
+        m->seq = k;
+        ccnl_ring_commit(&r, m);
+        m = (struct test_msg_s *) ccnl_ring_peek(&r);
+        assert_non_null(m);
+        assert_int_equal(k, m->seq);
+        ccnl_ring_release(&r);
+        assert_int_equal(0, ccnl_ring_count(&r));
+    }
+    ccnl_ring_cleanup(&r);
+}
+
+void test_ring_full()
+{
+    struct ccnl_ring_s r;
+    struct test_msg_s *m, *held;
+    uint32_t k;
+
+    assert_int_equal(0, ccnl_ring_init(&r, 4, sizeof(*m)));
+    held = (struct test_msg_s *) ccnl_ring_reserve(&r);
+    for (k = 1; k < 4; k++) {
+        m = (struct test_msg_s *) ccnl_ring_reserve(&r);
+        m->seq = k;
+        ccnl_ring_commit(&r, m);
+    }
+    assert_null(ccnl_ring_reserve(&r));
+    assert_int_equal(1, r.drops);
+    assert_int_equal(4, r.highwater);
+
+    // a reserved element holds back the committed ones behind it
+    assert_null(ccnl_ring_peek(&r));
+    held->seq = 0;
+    ccnl_ring_commit(&r, held);
+    for (k = 0; k < 4; k++) {
+        m = (struct test_msg_s *) ccnl_ring_peek(&r);
+        assert_int_equal(k, m->seq);
+        ccnl_ring_release(&r);
+    }
+    assert_null(ccnl_ring_peek(&r));
+    ccnl_ring_cleanup(&r);
+}
+
+void test_ring_peek_nth()
+{
+    struct ccnl_ring_s r;
+    struct test_msg_s *m, *held;
+    uint32_t k;
+
+    assert_int_equal(0, ccnl_ring_init(&r, 8, sizeof(*m)));
+    for (k = 0; k < 3; k++) {
+        m = (struct test_msg_s *) ccnl_ring_reserve(&r);
+        m->seq = k;
+        ccnl_ring_commit(&r, m);
+    }
+    held = (struct test_msg_s *) ccnl_ring_reserve(&r);
+    for (k = 0; k < 3; k++) {
+        m = (struct test_msg_s *) ccnl_ring_peek_nth(&r, k);
+        assert_non_null(m);
+        assert_int_equal(k, m->seq);
+    }
+    assert_null(ccnl_ring_peek_nth(&r, 3));
+    assert_null(ccnl_ring_peek_nth(&r, 8));
+    ccnl_ring_commit(&r, held);
+    assert_ptr_equal(held, ccnl_ring_peek_nth(&r, 3));
+    ccnl_ring_cleanup(&r);
+}
+
+static void*
+test_ring_producer(void *arg)
+{
+    struct test_producer_s *p = (struct test_producer_s *) arg;
+    struct test_msg_s *m;
+    uint32_t k;
+
+    for (k = 0; k < TEST_MESSAGES; k++) {
+        while (!(m = (struct test_msg_s *) ccnl_ring_reserve(p->r))) {
+            sched_yield();
+        }
+        m->producer = p->id;
+        m->seq = k;
+        ccnl_ring_commit(p->r, m);
+    }
+    return NULL;
+}
+
+void test_ring_producers()
+{
+    struct ccnl_ring_s r;
+    struct test_producer_s args[TEST_PRODUCERS];
+    pthread_t th[TEST_PRODUCERS];
+    uint32_t next[TEST_PRODUCERS], k, got = 0;
+    struct test_msg_s *m;
+
+    assert_int_equal(0, ccnl_ring_init(&r, 64, sizeof(*m)));
+    for (k = 0; k < TEST_PRODUCERS; k++) {
+        args[k].r = &r;
+        args[k].id = k;
+        next[k] = 0;
+        assert_int_equal(0, pthread_create(&th[k], NULL, test_ring_producer, &args[k]));
+    }
+
+    // each producer's messages arrive complete and in order
+    while (got < TEST_PRODUCERS * TEST_MESSAGES) {
+        m = (struct test_msg_s *) ccnl_ring_peek(&r);
+        if (!m) {
+            sched_yield();
+            continue;
+        }
+        assert_true(m->producer < TEST_PRODUCERS);
+        assert_int_equal(next[m->producer], m->seq);
+        next[m->producer]++;
+        ccnl_ring_release(&r);
+        got++;
+    }
+    for (k = 0; k < TEST_PRODUCERS; k++) {
+        pthread_join(th[k], NULL);
+    }
+    assert_null(ccnl_ring_peek(&r));
+    assert_true(r.highwater <= r.depth);
+    ccnl_ring_cleanup(&r);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_ring_order),
+        unit_test(test_ring_full),
+        unit_test(test_ring_peek_nth),
+        unit_test(test_ring_producers),
+    };
+
+    return run_tests(tests);
+}
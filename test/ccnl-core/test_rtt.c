@@ -0,0 +1,75 @@
+/**
+ * @file test_rtt.c
+ * @brief Tests for the RTT and RTO estimation
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include "ccnl-core.h"
+
+void test_rtt_sample()
+{
+    struct ccnl_rtt_s r;
+
+    memset(&r, 0, sizeof(r));
+    assert_int_equal(CCNL_RTO_INITIAL, ccnl_rtt_rto(&r));
+    assert_int_equal(CCNL_RTO_INITIAL, ccnl_rtt_rto(NULL));
+
+    ccnl_rtt_sample(&r, 100);
+    assert_int_equal(100, r.srtt);
+    assert_int_equal(50, r.rttvar);
+    assert_int_equal(300, ccnl_rtt_rto(&r));
+
+    ccnl_rtt_sample(&r, 200);
+    assert_int_equal(113, r.srtt);
+    assert_int_equal(63, r.rttvar);
+    assert_int_equal(365, ccnl_rtt_rto(&r));
+    assert_int_equal(2, r.samples);
+}
+
+void test_rtt_bounds()
+{
+    struct ccnl_rtt_s r;
+
+    memset(&r, 0, sizeof(r));
+    ccnl_rtt_sample(&r, 10);
+    assert_int_equal(CCNL_RTO_MIN, ccnl_rtt_rto(&r));
+
+    memset(&r, 0, sizeof(r));
+    ccnl_rtt_sample(&r, 5000);
+    assert_int_equal(CCNL_RTO_MAX, ccnl_rtt_rto(&r));
+}
+
+void test_rtt_backoff()
+{
+    assert_int_equal(300, ccnl_rtt_backoff(300, 0));
+    assert_int_equal(600, ccnl_rtt_backoff(300, 1));
+    assert_int_equal(2400, ccnl_rtt_backoff(300, 3));
+    assert_int_equal(CCNL_RTO_MAX, ccnl_rtt_backoff(300, 4));
+    assert_int_equal(CCNL_RTO_MAX, ccnl_rtt_backoff(300, 1000));
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_rtt_sample),
+        unit_test(test_rtt_bounds),
+        unit_test(test_rtt_backoff),
+    };
+
+    return run_tests(tests);
+}
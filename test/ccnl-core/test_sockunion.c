@@ -107,6 +107,27 @@ void test_ccnl_addr2ascii_invalid()
     assert_string_equal(result, "(local)");
 }
 
+void test_ccnl_addr_hash()
+{
+    sockunion a, b;
+
+    memset(&a, 0, sizeof(a));
+    memset(&b, 0xff, sizeof(b));
+    a.ip4.sin_family = b.ip4.sin_family = AF_INET;
+    a.ip4.sin_addr.s_addr = b.ip4.sin_addr.s_addr = htonl(0x0a000001);
+    a.ip4.sin_port = b.ip4.sin_port = htons(9695);
+
+    /** bytes which ccnl_addr_cmp() ignores do not change the hash */
+    assert_int_equal(0, ccnl_addr_cmp(&a, &b));
+    assert_int_equal(ccnl_addr_hash(&a), ccnl_addr_hash(&b));
+
+    b.ip4.sin_port = htons(9696);
+    assert_true(ccnl_addr_hash(&a) != ccnl_addr_hash(&b));
+    b.ip4.sin_port = a.ip4.sin_port;
+    b.ip4.sin_addr.s_addr = htonl(0x0a000002);
+    assert_true(ccnl_addr_hash(&a) != ccnl_addr_hash(&b));
+}
+
 int main(void)
 {
     const UnitTest tests[] = {
@@ -116,6 +137,7 @@ int main(void)
         unit_test(test_ccnl_is_local_addr_invalid),
         unit_test(test_ccnl_is_local_addr_valid),
         unit_test(test_ccnl_addr2ascii_invalid),
+        unit_test(test_ccnl_addr_hash),
     };
     
     return run_tests(tests);
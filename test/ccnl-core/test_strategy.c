@@ -0,0 +1,171 @@
+/**
+ * @file test_strategy.c
+ * @brief Tests for the forwarding strategies
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include "ccnl-core.h"
+
+#define TEST_SUITE 0
+#define TEST_NEXTHOPS 3
+
+static struct ccnl_relay_s relay;
+static struct ccnl_face_s faces[TEST_NEXTHOPS];
+static struct ccnl_forward_s fwds[TEST_NEXTHOPS];
+static struct ccnl_forward_s *nh[TEST_NEXTHOPS];
+static struct ccnl_interest_s interest;
+
+static void
+setup_nexthops(const uint32_t *rtt)
+{
+    int k;
+
+    memset(&relay, 0, sizeof(relay));
+    memset(faces, 0, sizeof(faces));
+    memset(fwds, 0, sizeof(fwds));
+    memset(&interest, 0, sizeof(interest));
+    for (k = 0; k < TEST_NEXTHOPS; k++) {
+        if (rtt) {
+            ccnl_rtt_sample(&faces[k].perf.rtt, rtt[k]);
+        }
+        fwds[k].face = faces + k;
+        nh[k] = fwds + k;
+    }
+}
+
+static int
+first_only(struct ccnl_relay_s *r, struct ccnl_interest_s *i,
+           struct ccnl_forward_s **n, int cnt)
+{
+    (void) r;
+    (void) i;
+    (void) n;
+    (void) cnt;
+    return 1;
+}
+
+void test_strategy_multicast()
+{
+    setup_nexthops(NULL);
+    assert_int_equal(TEST_NEXTHOPS,
+                     ccnl_strategy_choose(&relay, NULL, &interest, nh, TEST_NEXTHOPS));
+    assert_ptr_equal(fwds, nh[0]);
+}
+
+void test_strategy_best_route()
+{
+    const uint32_t rtt[TEST_NEXTHOPS] = { 300, 50, 150 };
+    const struct ccnl_strategy_s *s = ccnl_strategy_find("best-route");
+
+    setup_nexthops(rtt);
+    assert_int_equal(1, ccnl_strategy_choose(&relay, s, &interest, nh, TEST_NEXTHOPS));
+    assert_ptr_equal(fwds + 1, nh[0]);
+
+    // a retransmission goes to the second best next hop
+    interest.retries = 1;
+    assert_int_equal(1, ccnl_strategy_choose(&relay, s, &interest, nh, TEST_NEXTHOPS));
+    assert_ptr_equal(fwds + 2, nh[0]);
+
+    // also as the default of the relay
+    interest.retries = 0;
+    relay.strategy = s;
+    assert_int_equal(1, ccnl_strategy_choose(&relay, NULL, &interest, nh, TEST_NEXTHOPS));
+    assert_ptr_equal(fwds + 1, nh[0]);
+}
+
+void test_strategy_round_robin()
+{
+    const struct ccnl_strategy_s *s = ccnl_strategy_find("round-robin");
+    int k, used[TEST_NEXTHOPS] = { 0 };
+
+    setup_nexthops(NULL);
+    for (k = 0; k < 3 * TEST_NEXTHOPS; k++) {
+        assert_int_equal(1, ccnl_strategy_choose(&relay, s, &interest, nh, TEST_NEXTHOPS));
+        nh[0]->uses++;
+        used[nh[0] - fwds]++;
+    }
+    for (k = 0; k < TEST_NEXTHOPS; k++) {
+        assert_int_equal(3, used[k]);
+    }
+}
+
+void test_strategy_weighted()
+{
+    // RTOs 200, 400 and 800 ms
+    const uint32_t rtt[TEST_NEXTHOPS] = { 100, 200, 400 };
+    const struct ccnl_strategy_s *s = ccnl_strategy_find("weighted");
+    int k, used[TEST_NEXTHOPS] = { 0 };
+
+    setup_nexthops(rtt);
+    for (k = 0; k < 70; k++) {
+        assert_int_equal(1, ccnl_strategy_choose(&relay, s, &interest, nh, TEST_NEXTHOPS));
+        used[nh[0] - fwds]++;
+    }
+    assert_int_equal(40, used[0]);
+    assert_int_equal(20, used[1]);
+    assert_int_equal(10, used[2]);
+}
+
+void test_strategy_register()
+{
+    const struct ccnl_strategy_s *s;
+    struct ccnl_prefix_s *p;
+    char buf[10];
+    int k;
+
+    assert_null(ccnl_strategy_register("multicast", first_only));
+    s = ccnl_strategy_register("test-first", first_only);
+    assert_non_null(s);
+    assert_ptr_equal(s, ccnl_strategy_find("test-first"));
+    assert_null(ccnl_strategy_find("none"));
+
+    // selected per prefix, for all its next hops
+    setup_nexthops(NULL);
+    strcpy(buf, "/a");
+    p = ccnl_URItoPrefix(buf, TEST_SUITE, NULL);
+    assert_int_equal(-1, ccnl_fib_set_strategy(&relay, p, s));
+    for (k = 0; k < TEST_NEXTHOPS; k++) {
+        fwds[k].prefix = p;
+        fwds[k].suite = TEST_SUITE;
+        assert_int_equal(0, ccnl_fib_link(&relay, fwds + k));
+    }
+    assert_int_equal(0, ccnl_fib_set_strategy(&relay, p, s));
+    for (k = 0; k < TEST_NEXTHOPS; k++) {
+        assert_ptr_equal(s, fwds[k].strategy);
+    }
+    assert_int_equal(1, ccnl_strategy_choose(&relay, fwds[0].strategy,
+                                             &interest, nh, TEST_NEXTHOPS));
+
+    for (k = 0; k < TEST_NEXTHOPS; k++) {
+        ccnl_fib_unlink(&relay, fwds + k);
+    }
+    ccnl_prefix_free(p);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_strategy_multicast),
+        unit_test(test_strategy_best_route),
+        unit_test(test_strategy_round_robin),
+        unit_test(test_strategy_weighted),
+        unit_test(test_strategy_register),
+    };
+
+    return run_tests(tests);
+}
@@ -0,0 +1,138 @@
+/**
+ * @file test_timer.c
+ * @brief Tests for the timer wheel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <time.h>
+#include <cmocka.h>
+
+#include "ccnl-os-time.h"
+
+static int fired[8];
+static int nfired;
+
+static void
+record(void *aux1, void *aux2)
+{
+    (void) aux2;
+    fired[nfired++] = (int) (intptr_t) aux1;
+}
+
+static void
+rearm(void *aux1, void *aux2)
+{
+    record(aux1, aux2);
+    ccnl_set_timer(0, record, (void *) (intptr_t) 9, NULL);
+}
+
+// runs the events until none is left
+static void
+run_all(void)
+{
+    int usec;
+
+    while ((usec = ccnl_run_events()) >= 0) {
+        struct timespec ts;
+        ts.tv_sec = usec / 1000000;
+        ts.tv_nsec = 1000L * (usec % 1000000);
+        nanosleep(&ts, NULL);
+    }
+}
+
+// returns where a timer fired, -1 if it did not
+static int
+fired_at(int id)
+{
+    int i;
+
+    for (i = 0; i < nfired; i++) {
+        if (fired[i] == id) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// only checks the orderings the wheel guarantees: how far the events run
+// late depends on the scheduler, and a late run may fire a timer set from
+// a callback before an older one that is already due
+void test_timer_order()
+{
+    void *h;
+
+    nfired = 0;
+    // 100ms is beyond the first level of the wheel and has to cascade
+    ccnl_set_timer(100000, record, (void *) 4, NULL);
+    ccnl_set_timer(3000, record, (void *) 3, NULL);
+    ccnl_set_timer(1000, record, (void *) 1, NULL);
+    h = ccnl_set_timer(2000, record, (void *) 2, NULL);
+    ccnl_set_timer(0, rearm, (void *) 0, NULL);
+    ccnl_rem_timer(h);
+    run_all();
+
+    assert_int_equal(5, nfired);
+    assert_int_equal(0, fired[0]);
+    assert_int_equal(-1, fired_at(2));
+    assert_true(fired_at(9) > fired_at(0));
+    assert_true(fired_at(1) < fired_at(3));
+    assert_true(fired_at(3) < fired_at(4));
+}
+
+void test_timer_same_tick()
+{
+    nfired = 0;
+    // already due: they all fire in the next run, in the order they were set
+    ccnl_set_timer(0, record, (void *) 5, NULL);
+    ccnl_set_timer(0, record, (void *) 6, NULL);
+    ccnl_set_timer(0, record, (void *) 7, NULL);
+    run_all();
+
+    assert_int_equal(3, nfired);
+    assert_int_equal(5, fired[0]);
+    assert_int_equal(6, fired[1]);
+    assert_int_equal(7, fired[2]);
+}
+
+void test_timer_next_event()
+{
+    void *h;
+    int usec;
+
+    nfired = 0;
+    assert_int_equal(-1, ccnl_run_events());
+    h = ccnl_set_timer(10 * 1000000, record, NULL, NULL);
+    usec = ccnl_run_events();
+    assert_true(usec > 0 && usec <= 10 * 1000000);
+    ccnl_rem_timer(h);
+    assert_int_equal(-1, ccnl_run_events());
+    assert_int_equal(0, nfired);
+
+    ccnl_set_timer(3600 * 1000000ULL, record, NULL, NULL);
+    ccnl_timer_cleanup();
+    assert_int_equal(-1, ccnl_run_events());
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_timer_order),
+        unit_test(test_timer_same_tick),
+        unit_test(test_timer_next_event),
+    };
+
+    return run_tests(tests);
+}